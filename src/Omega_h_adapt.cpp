@@ -5,9 +5,12 @@
 #include "Omega_h_coarsen.hpp"
 #include "Omega_h_confined.hpp"
 #include "Omega_h_conserve.hpp"
+#include "Omega_h_for.hpp"
 #include "Omega_h_histogram.hpp"
+#include "Omega_h_indset.hpp"
 #include "Omega_h_laplace.hpp"
 #include "Omega_h_map.hpp"
+#include "Omega_h_modify.hpp"
 #include "Omega_h_profile.hpp"
 #include "Omega_h_quality.hpp"
 #include "Omega_h_refine.hpp"
@@ -76,7 +79,7 @@ AdaptOpts::AdaptOpts(Int dim) {
 #ifdef OMEGA_H_USE_EGADS
   egads_model = nullptr;
   should_smooth_snap = true;
-  snap_smooth_tolerance = 1e-2;
+  snap_smooth_reduction = 1e-2;
   allow_snap_failure = false;
 #endif
   should_refine = true;
@@ -84,6 +87,13 @@ AdaptOpts::AdaptOpts(Int dim) {
   should_swap = true;
   should_coarsen_slivers = true;
   should_prevent_coarsen_flip = false;
+  should_rebalance = false;
+  max_imbalance_allowed = 1.10;
+  should_reorder = false;
+  min_reorder_improvement = 1.5;
+  should_combine_passes = false;
+  indset_engine = SYNCHRONOUS_INDSET;
+  should_adapt_unghosted = false;
 }
 
 static Reals get_fixable_qualities(Mesh* mesh, AdaptOpts const&) {
@@ -145,6 +155,8 @@ static void validate(Mesh* mesh, AdaptOpts const& opts) {
   OMEGA_H_CHECK(opts.min_quality_desired <= 1.0);
   OMEGA_H_CHECK(opts.nsliver_layers >= 0);
   OMEGA_H_CHECK(opts.nsliver_layers < 100);
+  OMEGA_H_CHECK(opts.max_imbalance_allowed >= 1.0);
+  OMEGA_H_CHECK(opts.min_reorder_improvement >= 1.0);
   auto mq = min_fixable_quality(mesh, opts);
   if (mq < opts.min_quality_allowed && !mesh->comm()->rank()) {
     std::cout << "WARNING: worst input element has quality " << mq
@@ -168,16 +180,168 @@ static bool pre_adapt(Mesh* mesh, AdaptOpts const& opts) {
   return true;
 }
 
+/* imbalance of the work left to do, measured with the same weights
+   that balance(true) evens out. measuring element counts instead
+   would call for a new partition right after each rebalance */
+static Real get_predicted_imbalance(Mesh* mesh) {
+  auto const comm = mesh->comm();
+  auto const weights =
+      mesh->owned_array(mesh->dim(), mesh->predictive_weights(), 1);
+  auto const local = get_sum(weights);
+  auto const total = comm->allreduce(local, OMEGA_H_SUM);
+  if (!(total > 0.0)) return 1.0;
+  auto const max = comm->allreduce(local, OMEGA_H_MAX);
+  return max / (total / comm->size());
+}
+
+static void rebalance_if_needed(Mesh* mesh, AdaptOpts const& opts) {
+  if (!opts.should_rebalance || mesh->comm()->size() == 1) return;
+  auto const before = get_predicted_imbalance(mesh);
+  if (before <= opts.max_imbalance_allowed) return;
+  OMEGA_H_TIME_FUNCTION;
+  auto const t0 = now();
+  /* weighs elements by the metric so that the partition anticipates
+     the refinement still to come. balance() starts from the stored
+     RIB hints, so the partition only moves incrementally */
+  mesh->balance(/*predictive=*/true);
+  auto const t1 = now();
+  if (opts.verbosity >= EACH_REBUILD) {
+    auto const after = get_predicted_imbalance(mesh);
+    if (can_print(mesh)) {
+      std::cout << "rebalancing from predicted imbalance " << before
+                << " to " << after << " took " << (t1 - t0) << " seconds\n";
+    }
+  }
+}
+
 static void post_rebuild(Mesh* mesh, AdaptOpts const& opts) {
   if (opts.verbosity >= EACH_REBUILD) print_adapt_status(mesh, opts);
+  rebalance_if_needed(mesh, opts);
+}
+
+static bool refine_pass(Mesh* mesh, AdaptOpts const& opts) {
+  /* the conservation errors of the two kinds of cavities are not merged,
+     and user transfers may not build the same tags for both */
+  if (opts.should_combine_passes && opts.should_swap &&
+      !should_conserve_any(mesh, opts.xfer_opts) && !opts.xfer_opts.user_xfer) {
+    return refine_and_swap_by_size(mesh, opts);
+  }
+  return refine_by_size(mesh, opts);
+}
+
+void set_cavity_parting(Mesh* mesh, AdaptOpts const& opts) {
+  if (opts.should_adapt_unghosted) {
+    mesh->set_parting(OMEGA_H_ELEM_BASED);
+  } else {
+    mesh->set_parting(OMEGA_H_GHOSTED);
+  }
+}
+
+/* a ghosted mesh gives owned keys their whole cavity. without ghosts,
+   only the keys which are not shared have it */
+Read<I8> filter_local_cavities(
+    Mesh* mesh, AdaptOpts const& opts, Int key_dim, Read<I8> cands) {
+  if (!opts.should_adapt_unghosted) return cands;
+  return land_each(cands, mark_unshared(mesh, key_dim));
+}
+
+enum FrozenWork { COARSEN_WORK, QUALITY_WORK };
+
+static Read<I8> mark_frozen_work(
+    Mesh* mesh, AdaptOpts const& opts, FrozenWork work) {
+  if (work == QUALITY_WORK) {
+    auto elems_have_work =
+        each_lt(get_fixable_qualities(mesh, opts), opts.min_quality_desired);
+    return mark_down(mesh, mesh->dim(), VERT, elems_have_work);
+  }
+  auto edges_have_work = each_lt(mesh->ask_lengths(), opts.min_length_desired);
+  return mark_down(mesh, EDGE, VERT, edges_have_work);
+}
+
+/* chooses frozen vertices whose stars share no element. each round
+   chooses the candidates whose key is the lowest among the candidates
+   of every element of their star, then drops the candidates sharing an
+   element with a chosen one. the copies of a vertex see different parts
+   of its star, so the marks are reduced across copies after each step.
+   the keys are hashes of the global numbers, which as with Luby's
+   independent sets takes O(log n) rounds in expectation, where global
+   numbers that decrease along a chain of stars would take one round
+   per link */
+static Read<I8> choose_frozen_verts(Mesh* mesh, Read<I8> verts_are_frozen) {
+  auto const dim = mesh->dim();
+  auto const nverts_per_elem = dim + 1;
+  auto elems2verts = mesh->ask_elem_verts();
+  auto verts2elems = mesh->ask_up(VERT, dim);
+  auto vert_keys = hash_globals(mesh->globals(VERT));
+  auto nelems = mesh->nelems();
+  auto verts_are_cands =
+      mesh->reduce_array(VERT, verts_are_frozen, 1, OMEGA_H_MAX);
+  verts_are_cands = mesh->sync_array(VERT, verts_are_cands, 1);
+  auto verts_are_chosen = Read<I8>(mesh->nverts(), I8(0));
+  while (get_max(mesh->comm(), verts_are_cands) == 1) {
+    Write<GO> elem_mins(nelems);
+    auto f = OMEGA_H_LAMBDA(LO e) {
+      auto elem_min = ArithTraits<GO>::max();
+      for (Int ev = 0; ev < nverts_per_elem; ++ev) {
+        auto v = elems2verts[e * nverts_per_elem + ev];
+        if (verts_are_cands[v]) elem_min = min2(elem_min, vert_keys[v]);
+      }
+      elem_mins[e] = elem_min;
+    };
+    parallel_for(nelems, f, "choose_frozen_verts");
+    auto vert_mins =
+        graph_reduce(verts2elems, Read<GO>(elem_mins), 1, OMEGA_H_MIN);
+    vert_mins = mesh->reduce_array(VERT, vert_mins, 1, OMEGA_H_MIN);
+    vert_mins = mesh->sync_array(VERT, vert_mins, 1);
+    auto verts_are_new =
+        land_each(verts_are_cands, each_eq(vert_mins, vert_keys));
+    verts_are_chosen = lor_each(verts_are_chosen, verts_are_new);
+    auto elems_are_taken = mark_up(mesh, VERT, dim, verts_are_new);
+    auto verts_are_blocked = mark_down(mesh, dim, VERT, elems_are_taken);
+    verts_are_blocked =
+        mesh->reduce_array(VERT, verts_are_blocked, 1, OMEGA_H_MAX);
+    verts_are_blocked = mesh->sync_array(VERT, verts_are_blocked, 1);
+    verts_are_cands =
+        land_each(verts_are_cands, invert_marks(verts_are_blocked));
+  }
+  return verts_are_chosen;
+}
+
+/* with should_adapt_unghosted, collapses and swaps only use cavities
+   which are already local. the stars of shared vertices with work left
+   stay frozen until the passes stall, then a set of them which do not
+   overlap moves, each to the owner of its vertex.
+   returns false if nothing was frozen */
+static bool migrate_frozen_cavities(
+    Mesh* mesh, AdaptOpts const& opts, FrozenWork work) {
+  auto comm = mesh->comm();
+  if (!opts.should_adapt_unghosted || comm->size() == 1) return false;
+  OMEGA_H_TIME_FUNCTION;
+  auto const t0 = now();
+  mesh->set_parting(OMEGA_H_ELEM_BASED);
+  auto verts_are_frozen = land_each(mark_frozen_work(mesh, opts, work),
+      invert_marks(mark_unshared(mesh, VERT)));
+  if (get_max(comm, verts_are_frozen) != 1) return false;
+  auto verts_are_chosen = choose_frozen_verts(mesh, verts_are_frozen);
+  auto nchosen = get_sum(comm, land_each(verts_are_chosen, mesh->owned(VERT)));
+  auto keys2verts = collect_marked(verts_are_chosen);
+  set_owners_by_indset(
+      mesh, VERT, keys2verts, mesh->ask_up(VERT, mesh->dim()));
+  auto const t1 = now();
+  if (opts.verbosity >= EACH_REBUILD && can_print(mesh)) {
+    std::cout << "moving the cavities of " << nchosen
+              << " frozen vertices took " << (t1 - t0) << " seconds\n";
+  }
+  return true;
 }
 
 static void satisfy_lengths(Mesh* mesh, AdaptOpts const& opts) {
   OMEGA_H_TIME_FUNCTION;
   bool did_anything;
+  bool did_migrate = false;
   do {
     did_anything = false;
-    if (opts.should_refine && refine_by_size(mesh, opts)) {
+    if (opts.should_refine && refine_pass(mesh, opts)) {
       post_rebuild(mesh, opts);
       did_anything = true;
     }
@@ -185,6 +349,12 @@ static void satisfy_lengths(Mesh* mesh, AdaptOpts const& opts) {
       post_rebuild(mesh, opts);
       did_anything = true;
     }
+    if (did_anything) {
+      did_migrate = false;
+    } else if (!did_migrate && opts.should_coarsen) {
+      did_migrate = migrate_frozen_cavities(mesh, opts, COARSEN_WORK);
+      did_anything = did_migrate;
+    }
   } while (did_anything);
 }
 
@@ -194,15 +364,22 @@ static bool satisfy_quality(Mesh* mesh, AdaptOpts const& opts) {
   if ((opts.verbosity >= EACH_REBUILD) && can_print(mesh)) {
     std::cout << "addressing element qualities\n";
   }
+  bool did_migrate = false;
   do {
     if (opts.should_swap && swap_edges(mesh, opts)) {
       post_rebuild(mesh, opts);
+      did_migrate = false;
       continue;
     }
     if (opts.should_coarsen_slivers && coarsen_slivers(mesh, opts)) {
       post_rebuild(mesh, opts);
+      did_migrate = false;
       continue;
     }
+    if (!did_migrate) {
+      did_migrate = migrate_frozen_cavities(mesh, opts, QUALITY_WORK);
+      if (did_migrate) continue;
+    }
     if ((opts.verbosity > SILENT) && can_print(mesh)) {
       std::cout << "could not satisfy quality\n";
     }
@@ -230,7 +407,7 @@ static void snap_and_satisfy_quality(Mesh* mesh, AdaptOpts const& opts) {
       }
       auto t0 = now();
       warp =
-          solve_laplacian(mesh, warp, mesh->dim(), opts.snap_smooth_tolerance);
+          solve_laplacian(mesh, warp, mesh->dim(), opts.snap_smooth_reduction);
       auto t1 = now();
       if (opts.verbosity >= EACH_REBUILD) {
         std::cout << "Solving Laplacian of warp field took " << (t1 - t0)
@@ -249,8 +426,23 @@ static void snap_and_satisfy_quality(Mesh* mesh, AdaptOpts const& opts) {
     satisfy_quality(mesh, opts);
 }
 
-static void post_adapt(
-    Mesh* mesh, AdaptOpts const& opts, Now t0, Now t1, Now t2, Now t3, Now t4) {
+static void reorder(Mesh* mesh, AdaptOpts const& opts) {
+  auto const verbose = (opts.verbosity >= EACH_REBUILD);
+  auto const before = verbose ? get_locality(mesh) : 0.0;
+  auto const t0 = now();
+  if (!reorder_for_locality(mesh, opts.min_reorder_improvement)) return;
+  auto const t1 = now();
+  if (verbose) {
+    auto const after = get_locality(mesh);
+    if (can_print(mesh)) {
+      std::cout << "reordering from locality " << before << " to " << after
+                << " took " << (t1 - t0) << " seconds\n";
+    }
+  }
+}
+
+static void post_adapt(Mesh* mesh, AdaptOpts const& opts, Now t0, Now t1,
+    Now t2, Now t3, Now t4, IndsetStats const& indsets0) {
   if (opts.verbosity == EACH_ADAPT) {
     if (!mesh->comm()->rank()) std::cout << "after adapting:\n";
     print_adapt_status(mesh, opts);
@@ -271,6 +463,14 @@ static void post_adapt(
     std::cout << "correcting integral errors took " << (t4 - t3)
               << " seconds\n";
   }
+  if (opts.verbosity > SILENT && !mesh->comm()->rank()) {
+    auto const indsets1 = get_indset_stats();
+    std::cout << "choosing " << (indsets1.ncalls - indsets0.ncalls)
+              << " independent sets took " << (indsets1.time - indsets0.time)
+              << " seconds (" << (indsets1.nrounds - indsets0.nrounds)
+              << " exchanges, " << (indsets1.nsweeps - indsets0.nsweeps)
+              << " local steps)\n";
+  }
   Now t5 = now();
   if (opts.verbosity > SILENT && !mesh->comm()->rank()) {
     std::cout << "adapting took " << (t5 - t0) << " seconds\n\n";
@@ -281,10 +481,12 @@ bool adapt(Mesh* mesh, AdaptOpts const& opts) {
   ScopedTimer adapt_timer("adapt");
   OMEGA_H_CHECK(mesh->family() == OMEGA_H_SIMPLEX);
   auto t0 = now();
+  auto const indsets0 = get_indset_stats();
 
   ScopedChangeRCFieldsToMesh change_to_mesh(*mesh);
   if (!pre_adapt(mesh, opts)) return false;
   setup_conservation_tags(mesh, opts);
+  if (opts.should_adapt_unghosted) mesh->set_parting(OMEGA_H_ELEM_BASED);
   auto t1 = now();
   satisfy_lengths(mesh, opts);
   auto t2 = now();
@@ -295,9 +497,10 @@ bool adapt(Mesh* mesh, AdaptOpts const& opts) {
 
 
   mesh->set_parting(OMEGA_H_ELEM_BASED);
+  if (opts.should_reorder) reorder(mesh, opts);
 
 
-  post_adapt(mesh, opts, t0, t1, t2, t3, t4);
+  post_adapt(mesh, opts, t0, t1, t2, t3, t4, indsets0);
 
 
   return true;
@@ -6,6 +6,7 @@
 #include <Omega_h_config.h>
 #include <Omega_h_compare.hpp>
 #include <Omega_h_defines.hpp>
+#include <Omega_h_indset.hpp>
 #include <Omega_h_mark.hpp>
 
 namespace Omega_h {
@@ -65,7 +66,9 @@ struct AdaptOpts {
 #ifdef OMEGA_H_USE_EGADS
   Egads* egads_model;
   bool should_smooth_snap;
-  Real snap_smooth_tolerance;
+  /* reduction of the residual of the smoothing solve,
+     see solve_laplacian */
+  Real snap_smooth_reduction;
   bool allow_snap_failure;
 #endif
   bool should_refine;
@@ -73,6 +76,25 @@ struct AdaptOpts {
   bool should_swap;
   bool should_coarsen_slivers;
   bool should_prevent_coarsen_flip;
+  /* after each refine, coarsen or swap pass, repartition the elements
+     with Mesh::balance(true) if the imbalance of
+     Mesh::predictive_weights() exceeds max_imbalance_allowed */
+  bool should_rebalance;
+  Real max_imbalance_allowed;
+  /* at the end, reorder the entities with reorder_for_locality() */
+  bool should_reorder;
+  Real min_reorder_improvement;
+  /* with should_swap, refine with refine_and_swap_by_size, which swaps
+     edges around slivers in the same pass and rebuild. user transfers
+     see the splits and the swaps of such a pass separately. not done
+     for conserved fields */
+  bool should_combine_passes;
+  /* how refine, coarsen and swap choose independent sets of cavities */
+  IndsetEngine indset_engine;
+  /* keep the element-based partition instead of ghosting for every pass.
+     only the chosen cavities which cross part boundaries move, each onto
+     the rank owning its key */
+  bool should_adapt_unghosted;
   TransferOpts xfer_opts;
 };
 
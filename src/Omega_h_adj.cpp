@@ -3,6 +3,7 @@
 #include "Omega_h_align.hpp"
 #include "Omega_h_amr.hpp"
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_atomics.hpp"
 #include "Omega_h_element.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_int_scan.hpp"
@@ -10,6 +11,8 @@
 #include "Omega_h_sort.hpp"
 #include "Omega_h_timer.hpp"
 
+#include <cstdint>
+
 namespace Omega_h {
 
 Adj unmap_adjacency(LOs const a2b, Adj const b2c) {
@@ -130,10 +133,88 @@ Read<I8> find_canonical_jumps(
   return jumps;
 }
 
+static bool hashed_find_unique_enabled = false;
+
+void enable_hashed_find_unique() { hashed_find_unique_enabled = true; }
+
+void disable_hashed_find_unique() { hashed_find_unique_enabled = false; }
+
+bool is_hashed_find_unique_enabled() { return hashed_find_unique_enabled; }
+
+/* mixes a canonical vertex list into a 32-bit hash,
+   using the MurmurHash3 finalizer on each vertex */
+OMEGA_H_DEVICE std::uint32_t hash_canonical(
+    Int const deg, LOs const& canon, LO const e) {
+  std::uint32_t h = 0x9e3779b9u;
+  for (Int j = 0; j < deg; ++j) {
+    auto k = static_cast<std::uint32_t>(canon[e * deg + j]);
+    k ^= k >> 16;
+    k *= 0x85ebca6bu;
+    k ^= k >> 13;
+    k *= 0xc2b2ae35u;
+    k ^= k >> 16;
+    h ^= k + 0x9e3779b9u + (h << 6) + (h >> 2);
+  }
+  return h;
+}
+
+/* smallest power of two holding twice the uses, computed wide so that
+   huge meshes are detected instead of overflowing LO */
+static std::int64_t get_hash_capacity(LO const nu) {
+  std::int64_t capacity = 1;
+  while (capacity < 2 * std::int64_t(nu)) capacity *= 2;
+  return capacity;
+}
+
+/* Identifies unique entities among the uses by inserting their canonical
+   vertex lists into an open-addressing (linear probing) hash table.
+   Each slot ends up holding the largest use index with that vertex list,
+   so the result is deterministic: unique entities are ordered by their
+   last use and take the orientation of that use.
+   This is the same choice of representative the sorting path makes
+   (the last use in each run of equal keys), only the order of the
+   unique entities differs. */
+static LOs find_unique_uses_hashed(
+    Int const deg, LOs const uv2v_canon, LO const capacity) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const nu = divide_no_remainder(uv2v_canon.size(), deg);
+  auto const mask = std::uint32_t(capacity - 1);
+  Write<LO> slots(capacity, -1);
+  Write<LO> u2slot(nu);
+  auto insert = OMEGA_H_LAMBDA(LO u) {
+    auto slot = hash_canonical(deg, uv2v_canon, u) & mask;
+    while (true) {
+      auto const prev = atomic_compare_exchange(&slots[LO(slot)], -1, u);
+      if (prev == -1) break;
+      if (are_equal(deg, uv2v_canon, prev, u)) {
+        atomic_max(&slots[LO(slot)], u);
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+    u2slot[u] = LO(slot);
+  };
+  parallel_for(nu, std::move(insert), "find_unique_hash_insert");
+  Write<I8> is_first(nu);
+  auto mark = OMEGA_H_LAMBDA(LO u) {
+    is_first[u] = (slots[u2slot[u]] == u);
+  };
+  parallel_for(nu, std::move(mark), "find_unique_hash_mark");
+  return collect_marked(read(is_first));
+}
+
 static LOs find_unique_deg(Int const deg, LOs const uv2v) {
   OMEGA_H_TIME_FUNCTION;
   auto const codes = get_codes_to_canonical(deg, uv2v);
   auto const uv2v_canon = align_ev2v(deg, uv2v, codes);
+  auto const nu = divide_no_remainder(uv2v_canon.size(), deg);
+  auto const capacity = get_hash_capacity(nu);
+  /* the table has to be indexable by LO, otherwise sort instead */
+  if (hashed_find_unique_enabled &&
+      capacity <= std::int64_t(ArithTraits<LO>::max())) {
+    auto const e2u = find_unique_uses_hashed(deg, uv2v_canon, LO(capacity));
+    return unmap<LO>(e2u, uv2v, deg);
+  }
   auto const sorted2u = sort_by_keys(uv2v_canon, deg);
   auto const jumps = find_canonical_jumps(deg, uv2v_canon, sorted2u);
   auto const e2sorted = collect_marked(jumps);
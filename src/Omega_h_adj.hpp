@@ -78,6 +78,14 @@ LOs find_unique(LOs const hv2v, Omega_h_Family const family, Int const high_dim,
 */
 LOs find_unique(LOs const hv2v, Topo_type const high_type, Topo_type const low_type);
 
+/* by default find_unique identifies duplicate uses by sorting their
+   canonical vertex lists. once enabled, a parallel hash table is used
+   instead, which takes expected linear time. the unique entities are then
+   ordered by their last use rather than lexically by vertex list */
+void enable_hashed_find_unique();
+void disable_hashed_find_unique();
+bool is_hashed_find_unique_enabled();
+
 /* for each entity (or entity use), sort its vertex list
    and express the sorting transformation as an alignment code */
 template <typename T>
@@ -165,6 +173,24 @@ OMEGA_H_DEVICE Few<Matrix<dim, dim>, neev> gather_symms(
   return x;
 }
 
+/* the counterparts of gather_vectors and gather_symms for
+   per-element copies of vertex data (see Mesh::ask_elem_coords),
+   which only index contiguous memory */
+template <Int neev, Int dim>
+OMEGA_H_DEVICE Matrix<dim, neev> get_packed_vectors(Reals const& a, LO e) {
+  Matrix<dim, neev> x;
+  for (Int i = 0; i < neev; ++i) x[i] = get_vector<dim>(a, e * neev + i);
+  return x;
+}
+
+template <Int neev, Int dim>
+OMEGA_H_DEVICE Few<Matrix<dim, dim>, neev> get_packed_symms(
+    Reals const& a, LO e) {
+  Few<Matrix<dim, dim>, neev> x;
+  for (Int i = 0; i < neev; ++i) x[i] = get_symm<dim>(a, e * neev + i);
+  return x;
+}
+
 #define INST_DECL(T)                                                           \
   extern template Read<I8> get_codes_to_canonical(Int deg, Read<T> ev2v);      \
   extern template void find_matches_ex(Int deg, LOs a2fv, Read<T> av2v,        \
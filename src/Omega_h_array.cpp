@@ -29,12 +29,20 @@ T* nonnull(T* p) {
 #ifdef OMEGA_H_USE_KOKKOS
 template <typename T>
 Write<T>::Write(View<T*> view_in) : view_(view_in) { }
+#else
+template <typename T>
+Write<T>::Write(SharedAlloc shared_alloc_in)
+    : shared_alloc_(std::move(shared_alloc_in)) {}
 #endif
 
 template <typename T>
 Write<T>::Write(LO size_in, std::string const& name_in) {
   begin_code("Write allocation");
   OMEGA_H_CHECK(size_in >= 0);
+  if (profile::global_kernel_counters) {
+    profile::global_kernel_counters->allocated_bytes +=
+        sizeof(T) * static_cast<std::size_t>(size_in);
+  }
 #ifdef OMEGA_H_USE_KOKKOS
   if (is_pooling_enabled()) {
 #if defined(OMEGA_H_COMPILING_FOR_HOST)
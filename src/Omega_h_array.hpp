@@ -60,6 +60,8 @@ class Write {
   OMEGA_H_INLINE Write();
 #ifdef OMEGA_H_USE_KOKKOS
   Write(View<T*> view_in);
+#else
+  explicit Write(SharedAlloc shared_alloc_in);
 #endif
   Write(LO size_in, std::string const& name = "");
   Write(LO size_in, T value, std::string const& name = "");
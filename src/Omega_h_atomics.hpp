@@ -56,6 +56,38 @@ OMEGA_H_DEVICE void atomic_add(int* const dest, const int val) {
 #endif
 }
 
+OMEGA_H_DEVICE int atomic_compare_exchange(
+    int* const dest, const int compare, const int val) {
+#if defined(OMEGA_H_USE_KOKKOS)
+  return Kokkos::atomic_compare_exchange(dest, compare, val);
+#elif defined(OMEGA_H_USE_CUDA) && defined(__CUDA_ARCH__)
+  return atomicCAS(dest, compare, val);
+#elif defined(OMEGA_H_USE_OPENMP)
+  return __sync_val_compare_and_swap(dest, compare, val);
+#else
+  int oldval = *dest;
+  if (oldval == compare) *dest = val;
+  return oldval;
+#endif
+}
+
+OMEGA_H_DEVICE void atomic_max(int* const dest, const int val) {
+#if defined(OMEGA_H_USE_KOKKOS)
+  Kokkos::atomic_max(dest, val);
+#elif defined(OMEGA_H_USE_CUDA) && defined(__CUDA_ARCH__)
+  atomicMax(dest, val);
+#elif defined(OMEGA_H_USE_OPENMP)
+  int oldval = *dest;
+  while (val > oldval) {
+    int const prev = atomic_compare_exchange(dest, oldval, val);
+    if (prev == oldval) break;
+    oldval = prev;
+  }
+#else
+  if (val > *dest) *dest = val;
+#endif
+}
+
 }  // end namespace Omega_h
 
 #endif
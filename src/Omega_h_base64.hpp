@@ -1,15 +1,32 @@
 #ifndef BASE64_HPP
 #define BASE64_HPP
 
-#include <istream>
+#include <cstddef>
+#include <iosfwd>
 #include <string>
 
 namespace Omega_h {
 
 namespace base64 {
 
+/* encoding and decoding use AVX2 or SSSE3 instructions when the CPU
+   has them, as checked on first use, and a scalar loop otherwise.
+   an engine can also be requested explicitly, as long as it is
+   no better than best_engine() */
+enum Engine { SCALAR, SSSE3, AVX2 };
+Engine best_engine();
+char const* engine_name(Engine engine);
+
 std::size_t encoded_size(std::size_t size);
+/* writes encoded_size(size) characters to out */
+void encode(void const* data, std::size_t size, char* out,
+    Engine engine = best_engine());
 std::string encode(void const* data, std::size_t size);
+/* encodes into the stream one piece at a time,
+   without building the whole encoded string */
+void write_encoded(std::ostream& stream, void const* data, std::size_t size);
+void decode(char const* text, void* data, std::size_t size,
+    Engine engine = best_engine());
 void decode(std::string const& text, void* data, std::size_t size);
 std::string read_encoded(std::istream& f);
 }  // namespace base64
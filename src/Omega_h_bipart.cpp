@@ -32,4 +32,30 @@ Dist bi_partition(CommPtr comm, Read<I8> marks) {
   return Dist(comm, dests, linsize);
 }
 
+Dist multi_partition(CommPtr comm, Read<I32> parts, Int nparts) {
+  OMEGA_H_CHECK_MSG(comm->size() % nparts == 0,
+      "multi_partition needs a number of MPI ranks divisible by the number "
+      "of parts");
+  auto const groupsize = divide_no_remainder(comm->size(), nparts);
+  Write<I32> dest_ranks(parts.size());
+  Write<LO> dest_idxs(parts.size());
+  LO linsize = -1;
+  for (Int part = 0; part < nparts; ++part) {
+    auto marked = collect_marked(each_eq_to(parts, part));
+    auto total = comm->allreduce(GO(marked.size()), OMEGA_H_SUM);
+    auto start = comm->exscan(GO(marked.size()), OMEGA_H_SUM);
+    Read<GO> globals(marked.size(), start, 1);
+    auto owners = globals_to_linear_owners(globals, total, groupsize);
+    auto const rank_start = part * groupsize;
+    map_into(add_to_each(owners.ranks, rank_start), marked, dest_ranks, 1);
+    map_into(owners.idxs, marked, dest_idxs, 1);
+    if (rank_start <= comm->rank() && comm->rank() < (rank_start + groupsize)) {
+      linsize =
+          linear_partition_size(total, groupsize, comm->rank() - rank_start);
+    }
+  }
+  auto dests = Remotes(Read<I32>(dest_ranks), Read<LO>(dest_idxs));
+  return Dist(comm, dests, linsize);
+}
+
 }  // end namespace Omega_h
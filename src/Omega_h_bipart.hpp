@@ -17,6 +17,12 @@ namespace Omega_h {
 
 Dist bi_partition(CommPtr comm, Read<I8> marks);
 
+/* the same for nparts parts, with parts[i] in [0, nparts) the part
+   of item i. the ranks are split into nparts equal consecutive groups,
+   so nparts must divide the communicator size */
+
+Dist multi_partition(CommPtr comm, Read<I32> parts, Int nparts);
+
 }  // end namespace Omega_h
 
 #endif
@@ -1,6 +1,9 @@
 #include "Omega_h_cmdline.hpp"
 
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 
 namespace Omega_h {
 
@@ -33,7 +36,15 @@ static bool parse_arg(char const* arg, std::string* p_value) {
 }
 
 static bool parse_arg(char const* arg, int* p_value) {
-  *p_value = std::atoi(arg);
+  char* end;
+  errno = 0;
+  auto const value = std::strtol(arg, &end, 10);
+  if (end == arg || *end != '\0' || errno == ERANGE ||
+      value < std::numeric_limits<int>::min() ||
+      value > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  *p_value = int(value);
   return true;
 }
 
@@ -92,7 +92,8 @@ static bool coarsen_ghosted(Mesh* mesh, AdaptOpts const& opts,
   auto vert_rails = Read<GO>();
   choose_rails(mesh, cands2edges, cand_edge_codes, cand_edge_quals,
       &verts_are_cands, &vert_quals, &vert_rails);
-  auto verts_are_keys = find_indset(mesh, VERT, vert_quals, verts_are_cands);
+  auto verts_are_keys = find_indset(
+      mesh, VERT, vert_quals, verts_are_cands, opts.indset_engine);
   Graph verts2cav_elems;
   verts2cav_elems = mesh->ask_up(VERT, mesh->dim());
   mesh->add_tag(VERT, "key", 1, verts_are_keys);
@@ -162,7 +163,7 @@ static bool coarsen(Mesh* mesh, AdaptOpts const& opts, OvershootLimit overshoot,
   if (ret) {
 
 
-    mesh->set_parting(OMEGA_H_GHOSTED);
+    set_cavity_parting(mesh, opts);
 
 
     ret = coarsen_ghosted(mesh, opts, overshoot, improve);
@@ -181,6 +182,8 @@ static bool coarsen(Mesh* mesh, AdaptOpts const& opts, OvershootLimit overshoot,
 
 bool coarsen_verts(Mesh* mesh, AdaptOpts const& opts,
     Read<I8> vert_marks, OvershootLimit overshoot, Improve improve) {
+  /* a collapse replaces the elements around the collapsing vertex */
+  vert_marks = filter_local_cavities(mesh, opts, VERT, vert_marks);
   auto ev2v = mesh->ask_verts_of(EDGE);
   Write<I8> edge_codes_w(mesh->nedges(), DONT_COLLAPSE);
   auto f = OMEGA_H_LAMBDA(LO e) {
@@ -219,7 +222,7 @@ bool coarsen_slivers(Mesh* mesh, AdaptOpts const& opts) {
   OMEGA_H_TIME_FUNCTION;
 
 
-  mesh->set_parting(OMEGA_H_GHOSTED);
+  set_cavity_parting(mesh, opts);
 
 
   auto comm = mesh->comm();
@@ -15,7 +15,7 @@ namespace Omega_h {
 void choose_rails(Mesh* mesh, LOs cands2edges, Read<I8> cand_edge_codes,
     Reals cand_edge_quals, Read<I8>* verts_are_cands, Reals* vert_quals,
     Read<GO>* vert_rails) {
-  OMEGA_H_CHECK(mesh->parting() == OMEGA_H_GHOSTED);
+  OMEGA_H_CHECK(mesh->parting() != OMEGA_H_VERT_BASED);
   auto edges2cands = invert_injective_map(cands2edges, mesh->nedges());
   auto v2e = mesh->ask_up(VERT, EDGE);
   auto v2ve = v2e.a2ab;
@@ -58,12 +58,16 @@ void choose_rails(Mesh* mesh, LOs cands2edges, Read<I8> cand_edge_codes,
     vert_rails_w[v] = best_global;
   };
   parallel_for(mesh->nverts(), f, "choose_rails");
-  *verts_are_cands = verts_are_cands_w;
-  *verts_are_cands = mesh->sync_array(VERT, *verts_are_cands, 1);
-  *vert_quals = vert_quals_w;
-  *vert_quals = mesh->sync_array(VERT, *vert_quals, 1);
-  *vert_rails = vert_rails_w;
-  *vert_rails = mesh->sync_array(VERT, *vert_rails, 1);
+  auto cands_tag = std::make_shared<Tag<I8>>("candidates", 1);
+  cands_tag->set_array(verts_are_cands_w);
+  auto quals_tag = std::make_shared<Tag<Real>>("qualities", 1);
+  quals_tag->set_array(vert_quals_w);
+  auto rails_tag = std::make_shared<Tag<GO>>("rails", 1);
+  rails_tag->set_array(vert_rails_w);
+  auto synced = mesh->sync_arrays(VERT, {cands_tag, quals_tag, rails_tag});
+  *verts_are_cands = as<I8>(synced[0].get())->array();
+  *vert_quals = as<Real>(synced[1].get())->array();
+  *vert_rails = as<GO>(synced[2].get())->array();
 }
 
 /* this function is in some sense
@@ -209,6 +209,19 @@ T Comm::allreduce(T x, Omega_h_Op op) const {
   return x;
 }
 
+template <typename T>
+Read<T> Comm::allreduce(Read<T> x, Omega_h_Op op) const {
+#ifdef OMEGA_H_USE_MPI
+  HostWrite<T> h_x(deep_copy(x));
+  CALL(MPI_Allreduce(MPI_IN_PLACE, nonnull(h_x.data()), h_x.size(),
+      MpiTraits<T>::datatype(), mpi_op(op), impl_));
+  return h_x.write();
+#else
+  (void)op;
+  return x;
+#endif
+}
+
 bool Comm::reduce_or(bool x) const {
   I8 y = x;
   y = allreduce(y, OMEGA_H_MAX);
@@ -566,6 +579,118 @@ Read<T> Comm::alltoallv(Read<T> sendbuf_dev, Read<LO> sdispls_dev,
   return recvbuf_dev;
 }
 
+PersistentAlltoallv::PersistentAlltoallv() : active_(false) {
+#ifdef OMEGA_H_USE_MPI
+  neighbor_comm_ = MPI_COMM_NULL;
+#endif
+}
+
+PersistentAlltoallv::~PersistentAlltoallv() {
+#ifdef OMEGA_H_USE_MPI
+  if (active_) wait();
+  for (auto& request : requests_) CALL(MPI_Request_free(&request));
+  if (neighbor_comm_ != MPI_COMM_NULL) CALL(MPI_Comm_free(&neighbor_comm_));
+#endif
+}
+
+void PersistentAlltoallv::start() {
+  OMEGA_H_CHECK(!active_);
+#ifdef OMEGA_H_USE_MPI
+  if (!requests_.empty()) {
+    CALL(MPI_Startall(int(requests_.size()), requests_.data()));
+  }
+#endif
+  active_ = true;
+}
+
+bool PersistentAlltoallv::test() {
+  if (!active_) return true;
+#ifdef OMEGA_H_USE_MPI
+  int flag = 1;
+  if (!requests_.empty()) {
+    CALL(MPI_Testall(
+        int(requests_.size()), requests_.data(), &flag, MPI_STATUSES_IGNORE));
+  }
+  if (!flag) return false;
+#endif
+  active_ = false;
+  return true;
+}
+
+void PersistentAlltoallv::wait() {
+  if (!active_) return;
+#ifdef OMEGA_H_USE_MPI
+  if (!requests_.empty()) {
+    CALL(MPI_Waitall(
+        int(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE));
+  }
+#endif
+  active_ = false;
+}
+
+template <typename T>
+PersistentAlltoallvPtr Comm::alltoallv_init(T const* sendbuf,
+    HostRead<LO> sdispls, T* recvbuf, HostRead<LO> rdispls, Int width) const {
+  OMEGA_H_TIME_FUNCTION;
+  auto out = std::make_shared<PersistentAlltoallv>();
+#ifdef OMEGA_H_USE_MPI
+  int const outdegree = host_dsts_.size();
+  int const indegree = host_srcs_.size();
+  OMEGA_H_CHECK(sdispls.size() == outdegree + 1);
+  OMEGA_H_CHECK(rdispls.size() == indegree + 1);
+  auto const datatype = MpiTraits<T>::datatype();
+#if MPI_VERSION >= 4
+  /* send counts, send displacements, receive counts, receive displacements,
+     which MPI reads until the request is freed */
+  auto& counts = out->counts_;
+  counts.resize(std::size_t(2 * (outdegree + indegree)));
+  int* const scounts = counts.data();
+  int* const sdispls_w = scounts + outdegree;
+  int* const rcounts = sdispls_w + outdegree;
+  int* const rdispls_w = rcounts + indegree;
+  for (int i = 0; i < outdegree; ++i) {
+    scounts[i] = (sdispls[i + 1] - sdispls[i]) * width;
+    sdispls_w[i] = sdispls[i] * width;
+  }
+  for (int i = 0; i < indegree; ++i) {
+    rcounts[i] = (rdispls[i + 1] - rdispls[i]) * width;
+    rdispls_w[i] = rdispls[i] * width;
+  }
+  CALL(MPI_Dist_graph_create_adjacent(impl_, indegree,
+      nonnull(host_srcs_.data()), OMEGA_H_MPI_UNWEIGHTED, outdegree,
+      nonnull(host_dsts_.data()), OMEGA_H_MPI_UNWEIGHTED, MPI_INFO_NULL, 0,
+      &out->neighbor_comm_));
+  out->requests_.resize(1);
+  CALL(MPI_Neighbor_alltoallv_init(sendbuf, scounts, sdispls_w, datatype,
+      recvbuf, rcounts, rdispls_w, datatype, out->neighbor_comm_,
+      MPI_INFO_NULL, out->requests_.data()));
+#else
+  /* distinct from the tag of Neighbor_ialltoallv, so that exchanges
+     posted meanwhile through the same Comm are not matched with these */
+  int const tag = 43;
+  out->requests_.resize(std::size_t(outdegree + indegree));
+  auto requests = out->requests_.data();
+  for (int i = 0; i < outdegree; ++i) {
+    CALL(MPI_Send_init(sendbuf + sdispls[i] * width,
+        (sdispls[i + 1] - sdispls[i]) * width, datatype, host_dsts_[i], tag,
+        impl_, requests + i));
+  }
+  for (int i = 0; i < indegree; ++i) {
+    CALL(MPI_Recv_init(recvbuf + rdispls[i] * width,
+        (rdispls[i + 1] - rdispls[i]) * width, datatype, host_srcs_[i], tag,
+        impl_, requests + outdegree + i));
+  }
+#endif
+#else
+  (void)sendbuf;
+  (void)sdispls;
+  (void)recvbuf;
+  (void)rdispls;
+  (void)width;
+#endif
+  return out;
+}
+
 void Comm::barrier() const {
 #ifdef OMEGA_H_USE_MPI
   CALL(MPI_Barrier(impl_));
@@ -576,6 +701,7 @@ void Comm::barrier() const {
 
 #define INST(T)                                                                \
   template T Comm::allreduce(T x, Omega_h_Op op) const;                        \
+  template Read<T> Comm::allreduce(Read<T> x, Omega_h_Op op) const;            \
   template T Comm::exscan(T x, Omega_h_Op op) const;                           \
   template void Comm::bcast(T& x, int root_rank) const;                        \
   template Read<T> Comm::allgather(T x) const;                                 \
@@ -583,7 +709,9 @@ void Comm::barrier() const {
   template Read<T> Comm::alltoallv(                                            \
       Read<T> sendbuf, Read<LO> sdispls, Read<LO> rdispls, Int width) const;   \
   template Future<T> Comm::ialltoallv(                                       \
-      Read<T> sendbuf, Read<LO> sdispls, Read<LO> rdispls, Int width) const;
+      Read<T> sendbuf, Read<LO> sdispls, Read<LO> rdispls, Int width) const;   \
+  template PersistentAlltoallvPtr Comm::alltoallv_init(T const* sendbuf,       \
+      HostRead<LO> sdispls, T* recvbuf, HostRead<LO> rdispls, Int width) const;
 
 INST(I8)
 INST(I32)
@@ -2,6 +2,7 @@
 #define OMEGA_H_COMM_HPP
 
 #include <memory>
+#include <vector>
 
 #include <Omega_h_mpi.h>
 #include <Omega_h_array.hpp>
@@ -26,6 +27,36 @@ class Comm;
 
 typedef std::shared_ptr<Comm> CommPtr;
 
+/* persistent requests for one alltoallv between two fixed buffers,
+   created by Comm::alltoallv_init and then started and waited on
+   any number of times.
+   with MPI 4 this is a single MPI_Neighbor_alltoallv_init request,
+   otherwise one MPI_Send_init or MPI_Recv_init per neighbor.
+   persistent exchanges on one Comm must be started in the same
+   order on all ranks */
+class PersistentAlltoallv {
+#ifdef OMEGA_H_USE_MPI
+  std::vector<MPI_Request> requests_;
+  std::vector<int> counts_;
+  MPI_Comm neighbor_comm_;
+#endif
+  bool active_;
+  friend class Comm;
+
+ public:
+  PersistentAlltoallv();
+  PersistentAlltoallv(PersistentAlltoallv const&) = delete;
+  PersistentAlltoallv& operator=(PersistentAlltoallv const&) = delete;
+  ~PersistentAlltoallv();
+  void start();
+  /* true once the exchange started last has completed */
+  bool test();
+  void wait();
+  bool active() const { return active_; }
+};
+
+using PersistentAlltoallvPtr = std::shared_ptr<PersistentAlltoallv>;
+
 class Comm {
 #ifdef OMEGA_H_USE_MPI
   MPI_Comm impl_;
@@ -64,6 +95,9 @@ class Comm {
   Read<I32> destinations() const;
   template <typename T>
   T allreduce(T x, Omega_h_Op op) const;
+  /* element-wise over all ranks, in one collective */
+  template <typename T>
+  Read<T> allreduce(Read<T> x, Omega_h_Op op) const;
   bool reduce_or(bool x) const;
   bool reduce_and(bool x) const;
   Int128 add_int128(Int128 x) const;
@@ -82,6 +116,12 @@ class Comm {
   template <typename T>
   Future<T> ialltoallv(
       Read<T> sendbuf, Read<LO> sdispls, Read<LO> rdispls, Int width) const;
+  /* sdispls and rdispls as in alltoallv. the buffers and this Comm
+     must stay alive as long as the returned requests do */
+  template <typename T>
+  PersistentAlltoallvPtr alltoallv_init(T const* sendbuf,
+      HostRead<LO> sdispls, T* recvbuf, HostRead<LO> rdispls,
+      Int width) const;
   void barrier() const;
   template<typename T>
   void send(int rank, const T& x);
@@ -216,6 +256,7 @@ void Comm::recv(int rank, T& x) {
 
 #define OMEGA_H_EXPL_INST_DECL(T)                                              \
   extern template T Comm::allreduce(T x, Omega_h_Op op) const;                 \
+  extern template Read<T> Comm::allreduce(Read<T> x, Omega_h_Op op) const;     \
   extern template T Comm::exscan(T x, Omega_h_Op op) const;                    \
   extern template void Comm::bcast(T& x, int root_rank) const;                 \
   extern template Read<T> Comm::allgather(T x) const;                          \
@@ -223,7 +264,9 @@ void Comm::recv(int rank, T& x) {
   extern template Read<T> Comm::alltoallv(                                     \
       Read<T> sendbuf, Read<LO> sdispls, Read<LO> rdispls, Int width) const;   \
   extern template Future<T> Comm::ialltoallv(                                  \
-      Read<T> sendbuf, Read<LO> sdispls, Read<LO> rdispls, Int width) const;
+      Read<T> sendbuf, Read<LO> sdispls, Read<LO> rdispls, Int width) const;   \
+  extern template PersistentAlltoallvPtr Comm::alltoallv_init(T const* sendbuf, \
+      HostRead<LO> sdispls, T* recvbuf, HostRead<LO> rdispls, Int width) const;
 OMEGA_H_EXPL_INST_DECL(I8)
 OMEGA_H_EXPL_INST_DECL(I32)
 OMEGA_H_EXPL_INST_DECL(I64)
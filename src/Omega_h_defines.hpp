@@ -43,6 +43,12 @@ enum Omega_h_Parting {
   OMEGA_H_VERT_BASED,
 };
 
+/* the partitioner used by Mesh::balance */
+enum Omega_h_Partitioner {
+  OMEGA_H_RIB,           // recursive inertial bisection
+  OMEGA_H_MULTISECTION,  // recursive coordinate multi-section
+};
+
 enum Omega_h_Source {
   OMEGA_H_CONSTANT,
   OMEGA_H_VARIATION,
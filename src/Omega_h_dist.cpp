@@ -1,5 +1,7 @@
 #include "Omega_h_dist.hpp"
 
+#include <algorithm>
+
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_int_scan.hpp"
@@ -221,6 +223,104 @@ void Dist::copy(Dist const& other) {
   }
 }
 
+template <typename T>
+DistPlan<T>::DistPlan() : width_(0) {}
+
+template <typename T>
+DistPlan<T>::DistPlan(Dist const& dist, Int width)
+    : width_(width), comm_(dist.comm_[Dist::F]) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const F = Dist::F;
+  auto const R = Dist::R;
+  /* expand and permute fused into one gather from the forward roots */
+  if (dist.roots2items_[F].exists()) {
+    content2roots_ = invert_fan(dist.roots2items_[F]);
+    if (dist.items2content_[F].exists()) {
+      content2roots_ = permute(content2roots_, dist.items2content_[F], 1);
+    }
+  } else if (dist.items2content_[F].exists()) {
+    content2roots_ = invert_permutation(dist.items2content_[F]);
+  }
+  ritems2content_ = dist.items2content_[R];
+  HostRead<LO> sdispls(dist.msgs2content_[F]);
+  HostRead<LO> rdispls(dist.msgs2content_[R]);
+  sendbuf_ = Write<T>(sdispls.last() * width, "DistPlan send");
+#ifdef OMEGA_H_USE_MPI
+  recvbuf_ = Write<T>(rdispls.last() * width, "DistPlan receive");
+#else
+  recvbuf_ = sendbuf_;
+#endif
+#if defined(OMEGA_H_USE_MPI) && OMEGA_H_MPI_NEEDS_HOST_COPY
+  host_sendbuf_ = HostWrite<T>(sendbuf_.size());
+  host_recvbuf_ = HostWrite<T>(recvbuf_);
+  requests_ = comm_->alltoallv_init(nonnull(host_sendbuf_.data()),
+      sdispls, nonnull(host_recvbuf_.data()), rdispls, width);
+#else
+  requests_ = comm_->alltoallv_init(
+      nonnull(sendbuf_.data()), sdispls, nonnull(recvbuf_.data()), rdispls, width);
+#endif
+}
+
+template <typename T>
+void DistPlan<T>::begin(Read<T> data) {
+  if (!requests_) {
+    passed_ = data;
+    return;
+  }
+  ScopedTimer timer("DistPlan::begin");
+  OMEGA_H_CHECK(!requests_->active());
+  auto const sendbuf = sendbuf_;
+  if (content2roots_.exists()) {
+    auto const content2roots = content2roots_;
+    auto const width = width_;
+    auto f = OMEGA_H_LAMBDA(LO content) {
+      auto const root = content2roots[content];
+      for (Int j = 0; j < width; ++j) {
+        sendbuf[content * width + j] = data[root * width + j];
+      }
+    };
+    parallel_for(content2roots.size(), f, "DistPlan::pack");
+  } else {
+    OMEGA_H_CHECK(data.size() == sendbuf.size());
+    copy_into(data, sendbuf);
+  }
+#if defined(OMEGA_H_USE_MPI) && OMEGA_H_MPI_NEEDS_HOST_COPY
+  HostRead<T> packed(read(sendbuf));
+  std::copy_n(nonnull(packed.data()), packed.size(), host_sendbuf_.data());
+#endif
+  requests_->start();
+}
+
+template <typename T>
+bool DistPlan<T>::test() {
+  if (!requests_) return true;
+  return requests_->test();
+}
+
+template <typename T>
+Read<T> DistPlan<T>::finish() {
+  if (!requests_) {
+    auto const out = passed_;
+    passed_ = Read<T>();
+    return out;
+  }
+  ScopedTimer timer("DistPlan::finish");
+  requests_->wait();
+#if defined(OMEGA_H_USE_MPI) && OMEGA_H_MPI_NEEDS_HOST_COPY
+  host_recvbuf_.write();
+#endif
+  /* the receive buffer is reused, so the result is always a copy */
+  Read<T> const recvbuf = recvbuf_;
+  if (ritems2content_.exists()) return unmap(ritems2content_, recvbuf, width_);
+  return deep_copy(recvbuf);
+}
+
+template <typename T>
+Read<T> DistPlan<T>::exch(Read<T> data) {
+  begin(data);
+  return finish();
+}
+
 Dist create_dist_for_variable_sized(Dist copies2owners, LOs copies2data) {
   auto nactors = copies2owners.nitems();
   // a proper fan contains (n+1) entries
@@ -260,7 +360,8 @@ Dist create_dist_for_variable_sized(Dist copies2owners, LOs copies2data) {
   template Read<T> Dist::exch(Read<T> data, Int width) const;                  \
   template Future<T> Dist::iexch(Read<T> data, Int width) const;             \
   template Read<T> Dist::exch_reduce(Read<T> data, Int width, Omega_h_Op op)   \
-      const;
+      const;                                                                   \
+  template class DistPlan<T>;
 INST_T(I8)
 INST_T(I32)
 INST_T(I64)
@@ -116,6 +116,9 @@ namespace Omega_h {
    For a depiction of the process, consult Figure 4.3(Page 106)
 */
 
+template <typename T>
+class DistPlan;
+
 class Dist {
   CommPtr parent_comm_;
   LOs roots2items_[2];
@@ -187,6 +190,54 @@ class Dist {
  private:
   void copy(Dist const& other);
   enum { F, R };
+  template <typename T>
+  friend class DistPlan;
+};
+
+/*! \brief a persistent plan for repeating Dist::exch with new data
+  \details
+   The displacements, the send and receive buffers and the
+   (persistent) MPI requests are set up once by the constructor,
+   so each exchange only packs the send buffer, starts the requests
+   and unpacks the receive buffer.
+   This suits exchanges repeated many times over the same pattern,
+   such as synchronizing a field every solver iteration.
+   begin() and finish() split the exchange so that computation
+   which does not need the result can overlap the communication.
+   The result of finish() is the same as that of exch(data, width).
+   A plan belongs to one Dist and width. Copies of a plan
+   share its buffers, so only one exchange per plan can be in flight.
+   A default-constructed plan returns the data it was given.
+ */
+template <typename T>
+class DistPlan {
+  Int width_;
+  LOs content2roots_;
+  LOs ritems2content_;
+  Write<T> sendbuf_;
+  Write<T> recvbuf_;
+#if defined(OMEGA_H_USE_MPI) && OMEGA_H_MPI_NEEDS_HOST_COPY
+  HostWrite<T> host_sendbuf_;
+  HostWrite<T> host_recvbuf_;
+#endif
+  /* the requests were made on this communicator, so it is declared
+     first to outlive them */
+  CommPtr comm_;
+  PersistentAlltoallvPtr requests_;
+  Read<T> passed_;
+
+ public:
+  DistPlan();
+  DistPlan(Dist const& dist, Int width);
+  /* packs data (one packet per forward root) and starts sending it */
+  void begin(Read<T> data);
+  /* true once the exchange begun last has completed */
+  bool test();
+  /* waits for the exchange begun last and returns
+     the received data (one packet per reverse item) */
+  Read<T> finish();
+  Read<T> exch(Read<T> data);
+  Int width() const { return width_; }
 };
 
 /*! \brief Creates a Dist object that can be re-used to synchronize variable-sized data per actor
@@ -202,7 +253,8 @@ Dist create_dist_for_variable_sized(Dist copies2owners, LOs copies2data);
   extern template Read<T> Dist::exch(Read<T> data, Int width) const;           \
   extern template Future<T> Dist::iexch(Read<T> data, Int width) const;        \
   extern template Read<T> Dist::exch_reduce<T>(                                \
-      Read<T> data, Int width, Omega_h_Op op) const;
+      Read<T> data, Int width, Omega_h_Op op) const;                           \
+  extern template class DistPlan<T>;
 OMEGA_H_EXPL_INST_DECL(I8)
 OMEGA_H_EXPL_INST_DECL(I32)
 OMEGA_H_EXPL_INST_DECL(I64)
@@ -1,3 +1,4 @@
+#include <memory>
 #include <sstream>
 
 #include <Omega_h_array_ops.hpp>
@@ -376,7 +377,7 @@ template <Int dim>
 any access(LO size, any& var, ExprReader::Args& args) {
   auto i = static_cast<Int>(any_cast<Real>(args.at(0)));
   auto j =
-      args.size() > 1 ? static_cast<Int>(any_cast<Real>(args.at(0))) : Int(-1);
+      args.size() > 1 ? static_cast<Int>(any_cast<Real>(args.at(1))) : Int(-1);
   if (var.type() == typeid(Vector<dim>)) {
     return (any_cast<Vector<dim>>(var))(i);
   } else if (var.type() == typeid(Tensor<dim>)) {
@@ -386,7 +387,7 @@ any access(LO size, any& var, ExprReader::Args& args) {
     if (array.size() == size * dim) {
       return Reals(get_component(array, dim, i));
     } else if (array.size() == size * matrix_ncomps(dim, dim)) {
-      return Reals(get_component(array, matrix_ncomps(dim, dim), j * dim + i));
+      return Reals(get_component(array, matrix_ncomps(dim, dim), i * dim + j));
     } else {
       std::stringstream ss;
       ss << "Unexpected array size " << array.size() << " in access operator\n";
@@ -689,6 +690,8 @@ ExprEnv::ExprEnv(LO size_in, Int dim_in) : size(size_in), dim(dim_in) {
   if (dim == 2) register_variable("I", any(identity_matrix<2, 2>()));
   if (dim == 1) register_variable("I", any(identity_matrix<1, 1>()));
   register_variable("pi", any(Real(Omega_h::PI)));
+  /* the functions above can all be lowered by ExprProgram */
+  user_functions.clear();
 }
 
 void ExprEnv::register_variable(std::string const& name, any const& value) {
@@ -703,6 +706,7 @@ void ExprEnv::register_function(
   OMEGA_H_CHECK(variables.find(name) == variables.end());
   // OMEGA_H_CHECK(functions.find(name) == functions.end());
   functions[name] = value;
+  user_functions.insert(name);
 }
 
 void ExprEnv::repeat(any& x) { promote(size, dim, x); }
@@ -723,6 +727,12 @@ void ExprReader::register_function(
 
 void ExprReader::repeat(any& x) { env.repeat(x); }
 
+any ExprReader::read_fused(std::string const& text, std::string const& name) {
+  ExprOpsReader ops_reader;
+  auto const op = any_cast<OpPtr>(ops_reader.read_string(text, name));
+  return eval_fused(op, env);
+}
+
 any ExprReader::at_shift(int token, std::string& text) {
   switch (token) {
     case math_lang::TOK_NAME: {
@@ -1157,4 +1167,564 @@ std::string ExprEnv::string(int verbose) {
 
 #undef OMEGA_H_BINARY_REDUCE
 
+namespace {
+
+enum ExprOpcode : I32 {
+  EXPR_CONST,
+  EXPR_INPUT,
+  EXPR_NEG,
+  EXPR_ADD,
+  EXPR_SUB,
+  EXPR_MUL,
+  EXPR_DIV,
+  EXPR_POW,
+  EXPR_GT,
+  EXPR_LT,
+  EXPR_EQ,
+  EXPR_AND,
+  EXPR_OR,
+  EXPR_SELECT,
+  EXPR_EXP,
+  EXPR_SQRT,
+  EXPR_SIN,
+  EXPR_COS,
+  EXPR_ERF
+};
+
+/* constants and inputs take immediate operands,
+   everything else takes the values of earlier instructions */
+bool takes_values(I32 opcode) { return opcode > EXPR_INPUT; }
+
+enum ExprShape { EXPR_NONE, EXPR_BOOL, EXPR_SCALAR, EXPR_VECTOR, EXPR_TENSOR };
+
+/* the instructions computing each component of a value */
+struct ExprValue {
+  Int shape = EXPR_NONE;
+  std::vector<Int> comps;
+};
+
+struct ExprInstr {
+  I32 opcode;
+  I32 a;
+  I32 b;
+  I32 c;
+};
+
+[[noreturn]] void fail_lowering(std::string const& msg) {
+  throw ParserFail("ExprProgram: " + msg);
+}
+
+template <typename T>
+Read<T> to_read(std::vector<T> const& v) {
+  HostWrite<T> h(LO(v.size()));
+  for (std::size_t i = 0; i < v.size(); ++i) h[LO(i)] = v[i];
+  return h.write();
+}
+
+/* lowering first produces one instruction per value (as in SSA form),
+   then dead instructions are dropped and the values are packed
+   into as few registers as their lifetimes allow */
+struct ExprLowering {
+  ExprEnv& env;
+  std::vector<ExprInstr> instrs;
+  std::vector<Real> constants;
+  std::vector<Reals> inputs;
+  std::map<std::string, ExprValue> locals;
+  std::map<std::string, ExprValue> loaded;
+  ExprLowering(ExprEnv& env_in) : env(env_in) {}
+  Int emit(I32 opcode, I32 a, I32 b = -1, I32 c = -1) {
+    instrs.push_back({opcode, a, b, c});
+    return Int(instrs.size()) - 1;
+  }
+  Int constant(Real value) {
+    constants.push_back(value);
+    return emit(EXPR_CONST, I32(constants.size()) - 1);
+  }
+  /* row-major, as matrix2vector stores tensors in arrays */
+  Int tensor_comp(Int i, Int j) const { return i * env.dim + j; }
+  ExprValue make(Int shape, std::vector<Int> comps) {
+    ExprValue value;
+    value.shape = shape;
+    value.comps = std::move(comps);
+    return value;
+  }
+  ExprValue unary(I32 opcode, ExprValue const& x) {
+    auto y = x;
+    for (auto& comp : y.comps) comp = emit(opcode, comp);
+    return y;
+  }
+  ExprValue each(I32 opcode, ExprValue const& x, ExprValue const& y) {
+    auto z = x;
+    for (std::size_t i = 0; i < x.comps.size(); ++i) {
+      z.comps[i] = emit(opcode, x.comps[i], y.comps[i]);
+    }
+    return z;
+  }
+  ExprValue scaled(I32 opcode, ExprValue const& x, Int s) {
+    auto y = x;
+    for (auto& comp : y.comps) comp = emit(opcode, comp, s);
+    return y;
+  }
+  Int dot(std::vector<Int> const& x, std::vector<Int> const& y) {
+    auto sum = emit(EXPR_MUL, x[0], y[0]);
+    for (std::size_t i = 1; i < x.size(); ++i) {
+      sum = emit(EXPR_ADD, sum, emit(EXPR_MUL, x[i], y[i]));
+    }
+    return sum;
+  }
+  std::vector<Int> row(ExprValue const& m, Int i) {
+    std::vector<Int> comps;
+    for (Int j = 0; j < env.dim; ++j) {
+      comps.push_back(m.comps[tensor_comp(i, j)]);
+    }
+    return comps;
+  }
+  std::vector<Int> col(ExprValue const& m, Int j) {
+    std::vector<Int> comps;
+    for (Int i = 0; i < env.dim; ++i) {
+      comps.push_back(m.comps[tensor_comp(i, j)]);
+    }
+    return comps;
+  }
+  void check_numeric(ExprValue const& x, char const* op) {
+    if (x.shape == EXPR_NONE || x.shape == EXPR_BOOL) {
+      fail_lowering(std::string("Invalid operand type to ") + op + " operator");
+    }
+  }
+  void check_shape(ExprValue const& x, Int shape, char const* op) {
+    if (x.shape != shape) {
+      fail_lowering(std::string("Invalid operand type to ") + op);
+    }
+  }
+  template <Int dim>
+  ExprValue lower_small(any const& x) {
+    std::vector<Int> comps;
+    if (x.type() == typeid(Vector<dim>)) {
+      auto v = any_cast<Vector<dim>>(x);
+      for (Int i = 0; i < dim; ++i) comps.push_back(constant(v[i]));
+      return make(EXPR_VECTOR, comps);
+    }
+    if (x.type() == typeid(Tensor<dim>)) {
+      auto m = any_cast<Tensor<dim>>(x);
+      for (Int k = 0; k < dim * dim; ++k) {
+        comps.push_back(constant(m(k / dim, k % dim)));
+      }
+      return make(EXPR_TENSOR, comps);
+    }
+    fail_lowering(std::string("unsupported variable type ") + x.type().name());
+  }
+  ExprValue lower_any(any const& x) {
+    if (x.type() == typeid(Real)) {
+      return make(EXPR_SCALAR, {constant(any_cast<Real>(x))});
+    }
+    if (x.type() == typeid(Reals)) {
+      auto const a = any_cast<Reals>(x);
+      Int shape = EXPR_NONE;
+      Int ncomps = 0;
+      if (a.size() == env.size) {
+        shape = EXPR_SCALAR;
+        ncomps = 1;
+      } else if (a.size() == env.size * env.dim) {
+        shape = EXPR_VECTOR;
+        ncomps = env.dim;
+      } else if (a.size() == env.size * env.dim * env.dim) {
+        shape = EXPR_TENSOR;
+        ncomps = env.dim * env.dim;
+      } else {
+        fail_lowering("unexpected array size");
+      }
+      if (Int(inputs.size()) == expr_max_inputs) {
+        fail_lowering("too many array variables");
+      }
+      inputs.push_back(a);
+      std::vector<Int> comps;
+      for (Int c = 0; c < ncomps; ++c) {
+        comps.push_back(emit(EXPR_INPUT, I32(inputs.size()) - 1, c, ncomps));
+      }
+      return make(shape, comps);
+    }
+    if (env.dim == 3) return lower_small<3>(x);
+    if (env.dim == 2) return lower_small<2>(x);
+    return lower_small<1>(x);
+  }
+  ExprValue variable(std::string const& name) {
+    auto lit = locals.find(name);
+    if (lit != locals.end()) return lit->second;
+    auto cit = loaded.find(name);
+    if (cit != loaded.end()) return cit->second;
+    auto it = env.variables.find(name);
+    if (it == env.variables.end()) {
+      fail_lowering("unknown variable name \"" + name + "\"");
+    }
+    return loaded[name] = lower_any(it->second);
+  }
+  Int index_arg(CallOp& op, std::size_t i) {
+    auto arg = dynamic_cast<ConstOp*>(op.rhs[i].get());
+    if (!arg) fail_lowering("access operator needs constant indices");
+    auto const index = static_cast<Int>(arg->value);
+    if (index < 0 || index >= env.dim) fail_lowering("index out of range");
+    return index;
+  }
+  ExprValue access(CallOp& op) {
+    auto const var = variable(op.name);
+    if (var.shape == EXPR_VECTOR && op.rhs.size() == 1) {
+      return make(EXPR_SCALAR, {var.comps[index_arg(op, 0)]});
+    }
+    if (var.shape == EXPR_TENSOR && op.rhs.size() == 2) {
+      auto const i = index_arg(op, 0);
+      auto const j = index_arg(op, 1);
+      return make(EXPR_SCALAR, {var.comps[std::size_t(tensor_comp(i, j))]});
+    }
+    fail_lowering("Unexpected variable type in access operator");
+  }
+  ExprValue call(CallOp& op) {
+    auto const& name = op.name;
+    if (locals.count(name) || env.variables.count(name)) return access(op);
+    if (!env.functions.count(name)) {
+      fail_lowering(
+          "\"" + name + "\" is neither a variable nor a function name");
+    }
+    if (env.user_functions.count(name)) {
+      fail_lowering("can't lower user function " + name + "()");
+    }
+    std::vector<ExprValue> args;
+    for (auto& arg : op.rhs) args.push_back(lower(*arg));
+    auto const nargs = Int(args.size());
+    std::map<std::string, I32> const unary_ops = {{"exp", EXPR_EXP},
+        {"sqrt", EXPR_SQRT}, {"sin", EXPR_SIN}, {"cos", EXPR_COS},
+        {"erf", EXPR_ERF}};
+    auto uit = unary_ops.find(name);
+    if (uit != unary_ops.end()) {
+      if (nargs != 1) fail_lowering(name + "() takes exactly one argument");
+      check_shape(args[0], EXPR_SCALAR, (name + "()").c_str());
+      return unary(uit->second, args[0]);
+    }
+    if (name == "vector") {
+      if (nargs < 1 || nargs > env.dim) {
+        fail_lowering("Wrong number of arguments to vector()");
+      }
+      std::vector<Int> comps;
+      for (Int i = 0; i < env.dim; ++i) {
+        auto const& arg = args[std::size_t(min2(i, nargs - 1))];
+        check_shape(arg, EXPR_SCALAR, "vector()");
+        comps.push_back(arg.comps[0]);
+      }
+      return make(EXPR_VECTOR, comps);
+    }
+    if (name == "matrix" || name == "tensor") {
+      auto zero =
+          nargs == 1 ? dynamic_cast<ConstOp*>(op.rhs[0].get()) : nullptr;
+      if (zero && zero->value == 0.0) {
+        return make(EXPR_TENSOR,
+            std::vector<Int>(std::size_t(env.dim * env.dim), args[0].comps[0]));
+      }
+      if (nargs != env.dim * env.dim) {
+        fail_lowering("Wrong number of arguments to matrix()");
+      }
+      std::vector<Int> comps(static_cast<std::size_t>(nargs));
+      for (Int i = 0; i < env.dim; ++i) {
+        for (Int j = 0; j < env.dim; ++j) {
+          auto const& arg = args[std::size_t(i * env.dim + j)];
+          check_shape(arg, EXPR_SCALAR, "matrix()");
+          comps[std::size_t(tensor_comp(i, j))] = arg.comps[0];
+        }
+      }
+      return make(EXPR_TENSOR, comps);
+    }
+    if (name == "norm") {
+      if (nargs != 1) fail_lowering("norm() takes exactly one argument");
+      check_shape(args[0], EXPR_VECTOR, "norm()");
+      return make(EXPR_SCALAR,
+          {emit(EXPR_SQRT, dot(args[0].comps, args[0].comps))});
+    }
+    fail_lowering("can't lower " + name + "()");
+  }
+  ExprValue mul(ExprValue const& x, ExprValue const& y) {
+    check_numeric(x, "*");
+    check_numeric(y, "*");
+    if (x.shape == EXPR_SCALAR) return scaled(EXPR_MUL, y, x.comps[0]);
+    if (y.shape == EXPR_SCALAR) return scaled(EXPR_MUL, x, y.comps[0]);
+    if (x.shape == EXPR_VECTOR && y.shape == EXPR_VECTOR) {
+      return make(EXPR_SCALAR, {dot(x.comps, y.comps)});
+    }
+    if (x.shape == EXPR_TENSOR && y.shape == EXPR_VECTOR) {
+      std::vector<Int> comps;
+      for (Int i = 0; i < env.dim; ++i) {
+        comps.push_back(dot(row(x, i), y.comps));
+      }
+      return make(EXPR_VECTOR, comps);
+    }
+    if (x.shape == EXPR_TENSOR && y.shape == EXPR_TENSOR) {
+      std::vector<Int> comps(x.comps.size());
+      for (Int i = 0; i < env.dim; ++i) {
+        for (Int j = 0; j < env.dim; ++j) {
+          comps[std::size_t(tensor_comp(i, j))] = dot(row(x, i), col(y, j));
+        }
+      }
+      return make(EXPR_TENSOR, comps);
+    }
+    fail_lowering("Invalid operand types to * operator");
+  }
+  ExprValue same_shape(I32 opcode, ExprValue const& x, ExprValue const& y,
+      char const* op) {
+    check_numeric(x, op);
+    if (x.shape != y.shape) {
+      fail_lowering(
+          std::string("Invalid operand types to ") + op + " operator");
+    }
+    return each(opcode, x, y);
+  }
+  ExprValue compare(I32 opcode, ExprValue const& x, ExprValue const& y,
+      char const* op) {
+    check_shape(x, EXPR_SCALAR, op);
+    check_shape(y, EXPR_SCALAR, op);
+    return make(EXPR_BOOL, {emit(opcode, x.comps[0], y.comps[0])});
+  }
+  ExprValue logical(I32 opcode, ExprValue const& x, ExprValue const& y,
+      char const* op) {
+    check_shape(x, EXPR_BOOL, op);
+    check_shape(y, EXPR_BOOL, op);
+    return make(EXPR_BOOL, {emit(opcode, x.comps[0], y.comps[0])});
+  }
+  ExprValue lower(ExprOp& op) {
+    if (auto p = dynamic_cast<ConstOp*>(&op)) {
+      return make(EXPR_SCALAR, {constant(p->value)});
+    }
+    if (auto p = dynamic_cast<SemicolonOp*>(&op)) {
+      lower(*p->lhs);
+      return lower(*p->rhs);
+    }
+    if (auto p = dynamic_cast<AssignOp*>(&op)) {
+      locals[p->name] = lower(*p->rhs);
+      return ExprValue();
+    }
+    if (auto p = dynamic_cast<VarOp*>(&op)) return variable(p->name);
+    if (auto p = dynamic_cast<NegOp*>(&op)) {
+      auto x = lower(*p->rhs);
+      check_numeric(x, "negation");
+      return unary(EXPR_NEG, x);
+    }
+    if (auto p = dynamic_cast<TernaryOp*>(&op)) {
+      auto cond = lower(*p->cond);
+      auto x = lower(*p->lhs);
+      auto y = lower(*p->rhs);
+      check_shape(cond, EXPR_BOOL, "ternary operator");
+      if (x.shape == EXPR_NONE || x.shape != y.shape) {
+        fail_lowering("Invalid value types in ternary operator");
+      }
+      auto z = x;
+      for (std::size_t i = 0; i < x.comps.size(); ++i) {
+        z.comps[i] = emit(EXPR_SELECT, cond.comps[0], x.comps[i], y.comps[i]);
+      }
+      return z;
+    }
+    if (auto p = dynamic_cast<CallOp*>(&op)) return call(*p);
+    if (auto p = dynamic_cast<OrOp*>(&op)) {
+      return logical(EXPR_OR, lower(*p->lhs), lower(*p->rhs), "||");
+    }
+    if (auto p = dynamic_cast<AndOp*>(&op)) {
+      return logical(EXPR_AND, lower(*p->lhs), lower(*p->rhs), "&&");
+    }
+    if (auto p = dynamic_cast<GtOp*>(&op)) {
+      return compare(EXPR_GT, lower(*p->lhs), lower(*p->rhs), ">");
+    }
+    if (auto p = dynamic_cast<LtOp*>(&op)) {
+      return compare(EXPR_LT, lower(*p->lhs), lower(*p->rhs), "<");
+    }
+    if (auto p = dynamic_cast<EqOp*>(&op)) {
+      return compare(EXPR_EQ, lower(*p->lhs), lower(*p->rhs), "==");
+    }
+    if (auto p = dynamic_cast<AddOp*>(&op)) {
+      return same_shape(EXPR_ADD, lower(*p->lhs), lower(*p->rhs), "+");
+    }
+    if (auto p = dynamic_cast<SubOp*>(&op)) {
+      return same_shape(EXPR_SUB, lower(*p->lhs), lower(*p->rhs), "-");
+    }
+    if (auto p = dynamic_cast<MulOp*>(&op)) {
+      return mul(lower(*p->lhs), lower(*p->rhs));
+    }
+    if (auto p = dynamic_cast<DivOp*>(&op)) {
+      auto x = lower(*p->lhs);
+      auto y = lower(*p->rhs);
+      check_numeric(x, "/");
+      check_shape(y, EXPR_SCALAR, "/ operator");
+      return scaled(EXPR_DIV, x, y.comps[0]);
+    }
+    if (auto p = dynamic_cast<PowOp*>(&op)) {
+      auto x = lower(*p->lhs);
+      auto y = lower(*p->rhs);
+      check_shape(x, EXPR_SCALAR, "^ operator");
+      check_shape(y, EXPR_SCALAR, "^ operator");
+      return make(EXPR_SCALAR, {emit(EXPR_POW, x.comps[0], y.comps[0])});
+    }
+    fail_lowering(std::string("unexpected operation ") + typeid(op).name());
+  }
+  /* drops instructions that don't reach the outputs and assigns
+     registers, reusing one as soon as its value has been last read */
+  Int allocate(std::vector<Int> const& outputs, std::vector<I32>& code,
+      std::vector<I32>& output_regs) {
+    auto const n = Int(instrs.size());
+    std::vector<Int> last_use(std::size_t(n), -1);
+    for (auto out : outputs) last_use[std::size_t(out)] = n;
+    for (Int k = n - 1; k >= 0; --k) {
+      auto const& instr = instrs[std::size_t(k)];
+      if (last_use[std::size_t(k)] == -1) continue;
+      if (!takes_values(instr.opcode)) continue;
+      for (auto v : {instr.a, instr.b, instr.c}) {
+        if (v >= 0 && last_use[std::size_t(v)] < k) {
+          last_use[std::size_t(v)] = k;
+        }
+      }
+    }
+    std::vector<Int> regs(std::size_t(n), -1);
+    std::vector<Int> free_regs;
+    Int nregs = 0;
+    for (Int k = 0; k < n; ++k) {
+      if (last_use[std::size_t(k)] == -1) continue;
+      auto const& instr = instrs[std::size_t(k)];
+      I32 operands[3] = {instr.a, instr.b, instr.c};
+      if (takes_values(instr.opcode)) {
+        for (auto& operand : operands) {
+          if (operand >= 0) operand = regs[std::size_t(operand)];
+        }
+        for (auto v : {instr.a, instr.b, instr.c}) {
+          if (v >= 0 && last_use[std::size_t(v)] == k &&
+              regs[std::size_t(v)] >= 0) {
+            free_regs.push_back(regs[std::size_t(v)]);
+            regs[std::size_t(v)] = -1;
+          }
+        }
+      }
+      Int reg;
+      if (free_regs.empty()) {
+        reg = nregs++;
+      } else {
+        reg = free_regs.back();
+        free_regs.pop_back();
+      }
+      regs[std::size_t(k)] = reg;
+      code.push_back(instr.opcode);
+      code.push_back(reg);
+      for (auto operand : operands) code.push_back(operand);
+    }
+    if (nregs > expr_max_registers) fail_lowering("too many registers needed");
+    for (auto out : outputs) output_regs.push_back(regs[std::size_t(out)]);
+    return nregs;
+  }
+};
+
+}  // end anonymous namespace
+
+ExprProgram::ExprProgram(ExprOp& op, ExprEnv& env) : size_(env.size) {
+  OMEGA_H_TIME_FUNCTION;
+  ExprLowering lowering(env);
+  auto const result = lowering.lower(op);
+  if (result.shape == EXPR_NONE || result.shape == EXPR_BOOL) {
+    fail_lowering("expression has no value");
+  }
+  ncomps_ = Int(result.comps.size());
+  std::vector<I32> code;
+  std::vector<I32> output_regs;
+  nregisters_ = lowering.allocate(result.comps, code, output_regs);
+  code_ = to_read(code);
+  constants_ = to_read(lowering.constants);
+  for (std::size_t i = 0; i < lowering.inputs.size(); ++i) {
+    inputs_[Int(i)] = lowering.inputs[i];
+  }
+  outputs_ = to_read(output_regs);
+}
+
+Reals ExprProgram::eval() const {
+  OMEGA_H_TIME_FUNCTION;
+  auto const code = code_;
+  auto const constants = constants_;
+  auto const inputs = inputs_;
+  auto const outputs = outputs_;
+  auto const ninstrs = ninstructions();
+  auto const ncomps = ncomps_;
+  auto const size = size_;
+  Write<Real> out(size * ncomps);
+  auto const nblocks = (size + expr_block_size - 1) / expr_block_size;
+  /* each instruction is applied to a whole block of entities,
+     which amortizes decoding it and lets the loops vectorize */
+  auto f = OMEGA_H_LAMBDA(LO block) {
+    Real r[expr_max_registers][expr_block_size];
+    auto const first = block * expr_block_size;
+    auto const n = min2(expr_block_size, size - first);
+#define OMEGA_H_EXPR_EACH(value)                                               \
+  for (Int l = 0; l < n; ++l) r[d][l] = (value);                               \
+  break
+    for (Int k = 0; k < ninstrs; ++k) {
+      auto const opcode = code[k * 5 + 0];
+      auto const d = code[k * 5 + 1];
+      auto const a = code[k * 5 + 2];
+      auto const b = code[k * 5 + 3];
+      auto const c = code[k * 5 + 4];
+      switch (opcode) {
+        case EXPR_CONST:
+          OMEGA_H_EXPR_EACH(constants[a]);
+        case EXPR_INPUT:
+          OMEGA_H_EXPR_EACH(inputs[a][(first + l) * c + b]);
+        case EXPR_NEG:
+          OMEGA_H_EXPR_EACH(-r[a][l]);
+        case EXPR_ADD:
+          OMEGA_H_EXPR_EACH(r[a][l] + r[b][l]);
+        case EXPR_SUB:
+          OMEGA_H_EXPR_EACH(r[a][l] - r[b][l]);
+        case EXPR_MUL:
+          OMEGA_H_EXPR_EACH(r[a][l] * r[b][l]);
+        case EXPR_DIV:
+          /* same convention as divide_each_maybe_zero */
+          OMEGA_H_EXPR_EACH(
+              (r[b][l] != 0.0) ? (r[a][l] / r[b][l]) : 0.0);
+        case EXPR_POW:
+          OMEGA_H_EXPR_EACH(std::pow(r[a][l], r[b][l]));
+        case EXPR_GT:
+          OMEGA_H_EXPR_EACH(Real(r[a][l] > r[b][l]));
+        case EXPR_LT:
+          OMEGA_H_EXPR_EACH(Real(r[a][l] < r[b][l]));
+        case EXPR_EQ:
+          OMEGA_H_EXPR_EACH(Real(r[a][l] == r[b][l]));
+        case EXPR_AND:
+          OMEGA_H_EXPR_EACH(Real(r[a][l] != 0.0 && r[b][l] != 0.0));
+        case EXPR_OR:
+          OMEGA_H_EXPR_EACH(Real(r[a][l] != 0.0 || r[b][l] != 0.0));
+        case EXPR_SELECT:
+          OMEGA_H_EXPR_EACH((r[a][l] != 0.0) ? r[b][l] : r[c][l]);
+        case EXPR_EXP:
+          OMEGA_H_EXPR_EACH(std::exp(r[a][l]));
+        case EXPR_SQRT:
+          OMEGA_H_EXPR_EACH(std::sqrt(r[a][l]));
+        case EXPR_SIN:
+          OMEGA_H_EXPR_EACH(std::sin(r[a][l]));
+        case EXPR_COS:
+          OMEGA_H_EXPR_EACH(std::cos(r[a][l]));
+        case EXPR_ERF:
+          OMEGA_H_EXPR_EACH(std::erf(r[a][l]));
+      }
+    }
+#undef OMEGA_H_EXPR_EACH
+    for (Int l = 0; l < n; ++l) {
+      for (Int i = 0; i < ncomps; ++i) {
+        out[(first + l) * ncomps + i] = r[outputs[i]][l];
+      }
+    }
+  };
+  parallel_for(nblocks, f, "ExprProgram::eval");
+  return out;
+}
+
+any eval_fused(OpPtr const& op, ExprEnv& env) {
+  std::unique_ptr<ExprProgram> program;
+  try {
+    program.reset(new ExprProgram(*op, env));
+  } catch (ParserFail const&) {
+    /* ExprOp::eval will either handle it or report the error */
+    auto result = op->eval(env);
+    env.repeat(result);
+    return result;
+  }
+  return program->eval();
+}
+
 }  // end namespace Omega_h
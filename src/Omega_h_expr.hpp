@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <map>
+#include <set>
 #include <vector>
 
 #include <Omega_h_any.hpp>
@@ -22,6 +23,9 @@ struct ExprEnv {
   void repeat(any& x);
   std::map<std::string, any> variables;
   std::map<std::string, Function> functions;
+  /* functions registered after construction, which ExprProgram
+     can't lower and leaves to ExprOp::eval */
+  std::set<std::string> user_functions;
   LO size;
   Int dim;
   std::string string(int verbose=0);
@@ -34,6 +38,50 @@ struct ExprOp {
 
 using OpPtr = std::shared_ptr<ExprOp>;
 
+constexpr Int expr_max_registers = 64;
+constexpr Int expr_max_inputs = 8;
+/* entities per interpreter pass; one per thread on GPUs,
+   which have far less room per thread for registers */
+#if defined(OMEGA_H_USE_CUDA) || defined(OMEGA_H_USE_KOKKOS)
+constexpr Int expr_block_size = 1;
+#else
+constexpr Int expr_block_size = 64;
+#endif
+
+/* an expression lowered to a flat program of scalar instructions,
+   which evaluates it for all env.size entities inside one parallel_for
+   instead of building an intermediate array per operator.
+   vectors and tensors are split into one register per component.
+   Real, Vector and Tensor variables become constants, while
+   Reals variables (scalars, vectors or tensors per entity)
+   are read directly by the kernel.
+   assignments only bind names within the expression.
+   the constructor throws ParserFail for expressions the program
+   can't express (e.g. user functions or symm()) */
+class ExprProgram {
+ public:
+  ExprProgram(ExprOp& op, ExprEnv& env);
+  /* ncomps() values per entity */
+  Reals eval() const;
+  Int ncomps() const { return ncomps_; }
+  Int ninstructions() const { return code_.size() / 5; }
+  Int nregisters() const { return nregisters_; }
+
+ private:
+  LO size_;
+  Int ncomps_;
+  Int nregisters_;
+  Read<I32> code_;
+  Reals constants_;
+  Few<Reals, expr_max_inputs> inputs_;
+  Read<I32> outputs_;
+};
+
+/* evaluates with an ExprProgram when the expression allows it and
+   with ExprOp::eval otherwise, repeating a constant result into
+   an array either way */
+any eval_fused(OpPtr const& op, ExprEnv& env);
+
 class ExprOpsReader final : public Reader {
  public:
   ExprOpsReader();
@@ -54,6 +102,9 @@ class ExprReader final : public Reader {
   void register_variable(std::string const& name, any const& value);
   void register_function(std::string const& name, Function const& value);
   void repeat(any& x);
+  /* opt-in alternative to read_string: parses text into ExprOps and
+     evaluates them with eval_fused, so the result is always an array */
+  any read_fused(std::string const& text, std::string const& name = "expr");
 
  protected:
   any at_shift(int token, std::string& text) override final;
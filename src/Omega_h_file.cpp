@@ -2,16 +2,35 @@
 
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OMEGA_H_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #ifdef OMEGA_H_USE_ZLIB
 #include <zlib.h>
 #endif
 
+#ifdef OMEGA_H_USE_ZSTD
+#include <zstd.h>
+#endif
+
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_inertia.hpp"
@@ -87,8 +106,277 @@ struct SwapBytes<T, 8> {
 
 unsigned char const magic[2] = {0xa1, 0x1a};
 
+#ifdef OMEGA_H_HAVE_MMAP
+/* a private, writable mapping of a whole file.
+   arrays viewing it share ownership so it outlives the reader */
+struct MappedFile {
+  char* data;
+  std::size_t size;
+  explicit MappedFile(filesystem::path const& path) : data(nullptr), size(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      Omega_h_fail("could not open file \"%s\"\n", path.c_str());
+    }
+    struct stat st;
+    OMEGA_H_CHECK(::fstat(fd, &st) == 0);
+    size = static_cast<std::size_t>(st.st_size);
+    if (size > 0) {
+      void* ptr =
+          ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (ptr == MAP_FAILED) {
+        ::close(fd);
+        Omega_h_fail("could not map file \"%s\": %s\n", path.c_str(),
+            std::strerror(errno));
+      }
+      data = static_cast<char*>(ptr);
+    }
+    ::close(fd);
+  }
+  ~MappedFile() {
+    if (data) ::munmap(data, size);
+  }
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+};
+
+/* an input buffer over a MappedFile; read_array recognizes it
+   and takes array data straight from the mapping */
+class MappedStreambuf : public std::streambuf {
+ public:
+  explicit MappedStreambuf(std::shared_ptr<MappedFile> file_in)
+      : file_(file_in) {
+    setg(file_->data, file_->data, file_->data + file_->size);
+  }
+  std::shared_ptr<MappedFile> const& file() const { return file_; }
+  char* current() const { return gptr(); }
+  std::size_t remaining() const {
+    return static_cast<std::size_t>(egptr() - gptr());
+  }
+  void advance(std::size_t nbytes) {
+    setg(eback(), gptr() + nbytes, egptr());
+  }
+
+ protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+      std::ios_base::openmode which) override {
+    off_type base = 0;
+    if (dir == std::ios_base::cur) base = gptr() - eback();
+    if (dir == std::ios_base::end) base = egptr() - eback();
+    return seekpos(pos_type(base + off), which);
+  }
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    auto const off = off_type(pos);
+    if (!(which & std::ios_base::in) || off < 0 || off > egptr() - eback()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + off, egptr());
+    return pos;
+  }
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+};
+
+template <typename T>
+Read<T> read_mapped_array(MappedStreambuf* buf, LO size) {
+  auto const nbytes = static_cast<std::size_t>(size) * sizeof(T);
+  OMEGA_H_CHECK(buf->remaining() >= nbytes);
+  auto const ptr = buf->current();
+  buf->advance(nbytes);
+#if !defined(OMEGA_H_USE_KOKKOS) && !defined(OMEGA_H_USE_CUDA)
+  if (reinterpret_cast<std::uintptr_t>(ptr) % alignof(T) == 0) {
+    return Write<T>(SharedAlloc(nbytes, "", ptr, buf->file()));
+  }
+#endif
+  HostWrite<T> copy(size);
+  if (nbytes) std::memcpy(copy.data(), ptr, nbytes);
+  return copy.write();
+}
+#endif
+
+void write_padding(std::ostream& stream) {
+  auto const pos = static_cast<std::size_t>(stream.tellp());
+  auto const npad = (array_alignment - pos % array_alignment) % array_alignment;
+  char const zeros[array_alignment] = {};
+  stream.write(zeros, static_cast<std::streamsize>(npad));
+}
+
+void skip_padding(std::istream& stream) {
+  auto const pos = static_cast<std::size_t>(stream.tellg());
+  auto const npad = (array_alignment - pos % array_alignment) % array_alignment;
+  stream.ignore(static_cast<std::streamsize>(npad));
+}
+
 }  // end anonymous namespace
 
+Compression default_compression() {
+#if defined(OMEGA_H_USE_ZSTD)
+  return COMPRESSION_ZSTD;
+#elif defined(OMEGA_H_USE_ZLIB)
+  return COMPRESSION_ZLIB;
+#else
+  return COMPRESSION_NONE;
+#endif
+}
+
+bool can_compress(I8 compression) {
+  switch (compression) {
+    case COMPRESSION_NONE:
+      return true;
+#ifdef OMEGA_H_USE_ZLIB
+    case COMPRESSION_ZLIB_WHOLE:
+    case COMPRESSION_ZLIB:
+      return true;
+#endif
+#ifdef OMEGA_H_USE_ZSTD
+    case COMPRESSION_ZSTD:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+static void fail_unsupported_compression(I8 compression) {
+  Omega_h_fail(
+      "Omega_h was built without support for .osh compression mode %d\n",
+      int(compression));
+}
+
+/* worst-case compressed size of one chunk */
+static I64 chunk_bound(I8 compression, I64 nbytes) {
+#ifdef OMEGA_H_USE_ZSTD
+  if (compression == COMPRESSION_ZSTD) {
+    return static_cast<I64>(::ZSTD_compressBound(std::size_t(nbytes)));
+  }
+#endif
+#ifdef OMEGA_H_USE_ZLIB
+  if (compression == COMPRESSION_ZLIB) {
+    return static_cast<I64>(::compressBound(uLong(nbytes)));
+  }
+#endif
+  (void)nbytes;
+  fail_unsupported_compression(compression);
+  OMEGA_H_NORETURN(0);
+}
+
+/* these run inside OpenMP loops, so they report failure
+   instead of throwing */
+static bool compress_chunk(I8 compression, char const* src, I64 nbytes,
+    std::vector<char>* dst) {
+  dst->resize(std::size_t(chunk_bound(compression, nbytes)));
+#ifdef OMEGA_H_USE_ZSTD
+  if (compression == COMPRESSION_ZSTD) {
+    auto const ret = ::ZSTD_compress(dst->data(), dst->size(), src,
+        std::size_t(nbytes), 1);
+    if (::ZSTD_isError(ret)) return false;
+    dst->resize(ret);
+    return true;
+  }
+#endif
+#ifdef OMEGA_H_USE_ZLIB
+  if (compression == COMPRESSION_ZLIB) {
+    uLong dest_bytes = static_cast<uLong>(dst->size());
+    int ret = ::compress2(reinterpret_cast< ::Bytef*>(dst->data()),
+        &dest_bytes, reinterpret_cast<const ::Bytef*>(src), uLong(nbytes),
+        Z_BEST_SPEED);
+    if (ret != Z_OK) return false;
+    dst->resize(std::size_t(dest_bytes));
+    return true;
+  }
+#endif
+  (void)src;
+  return false;
+}
+
+static bool decompress_chunk(I8 compression, char const* src,
+    I64 compressed_bytes, char* dst, I64 nbytes) {
+#ifdef OMEGA_H_USE_ZSTD
+  if (compression == COMPRESSION_ZSTD) {
+    auto const ret = ::ZSTD_decompress(
+        dst, std::size_t(nbytes), src, std::size_t(compressed_bytes));
+    return !::ZSTD_isError(ret) && ret == std::size_t(nbytes);
+  }
+#endif
+#ifdef OMEGA_H_USE_ZLIB
+  if (compression == COMPRESSION_ZLIB) {
+    uLong dest_bytes = static_cast<uLong>(nbytes);
+    int ret = ::uncompress(reinterpret_cast< ::Bytef*>(dst), &dest_bytes,
+        reinterpret_cast<const ::Bytef*>(src), uLong(compressed_bytes));
+    return ret == Z_OK && dest_bytes == static_cast<uLong>(nbytes);
+  }
+#endif
+  (void)src;
+  (void)compressed_bytes;
+  (void)dst;
+  (void)nbytes;
+  return false;
+}
+
+/* chunked layout: chunk size, the compressed size of every chunk,
+   then the compressed chunks back to back. knowing all sizes up front
+   lets both directions work on the chunks in parallel */
+static void write_chunks(std::ostream& stream, char const* data, I64 nbytes,
+    I8 compression, bool needs_swapping) {
+  if (!can_compress(compression)) fail_unsupported_compression(compression);
+  I64 chunk_bytes = compression_chunk_bytes;
+  write_value(stream, chunk_bytes, needs_swapping);
+  I64 const nchunks = (nbytes + chunk_bytes - 1) / chunk_bytes;
+  std::vector<std::vector<char>> chunks(static_cast<std::size_t>(nchunks));
+  std::vector<I8> ok(static_cast<std::size_t>(nchunks), 1);
+#if defined(OMEGA_H_USE_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (I64 i = 0; i < nchunks; ++i) {
+    auto const begin = i * chunk_bytes;
+    auto const n = std::min(chunk_bytes, nbytes - begin);
+    ok[std::size_t(i)] =
+        compress_chunk(compression, data + begin, n, &chunks[std::size_t(i)]);
+  }
+  for (auto const chunk_ok : ok) OMEGA_H_CHECK(chunk_ok);
+  for (auto const& chunk : chunks) {
+    auto compressed_bytes = static_cast<I64>(chunk.size());
+    write_value(stream, compressed_bytes, needs_swapping);
+  }
+  for (auto const& chunk : chunks) {
+    stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+  }
+}
+
+static void read_chunks(std::istream& stream, char* data, I64 nbytes,
+    I8 compression, bool needs_swapping) {
+  if (!can_compress(compression)) fail_unsupported_compression(compression);
+  I64 chunk_bytes;
+  read_value(stream, chunk_bytes, needs_swapping);
+  OMEGA_H_CHECK(chunk_bytes > 0);
+  I64 const nchunks = (nbytes + chunk_bytes - 1) / chunk_bytes;
+  std::vector<I64> offsets(static_cast<std::size_t>(nchunks + 1), 0);
+  for (I64 i = 0; i < nchunks; ++i) {
+    I64 compressed_bytes;
+    read_value(stream, compressed_bytes, needs_swapping);
+    OMEGA_H_CHECK(compressed_bytes >= 0);
+    offsets[std::size_t(i + 1)] = offsets[std::size_t(i)] + compressed_bytes;
+  }
+  std::vector<char> compressed(
+      static_cast<std::size_t>(offsets[std::size_t(nchunks)]));
+  stream.read(
+      compressed.data(), static_cast<std::streamsize>(compressed.size()));
+  OMEGA_H_CHECK(stream.good());
+  std::vector<I8> ok(static_cast<std::size_t>(nchunks), 1);
+#if defined(OMEGA_H_USE_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (I64 i = 0; i < nchunks; ++i) {
+    auto const begin = i * chunk_bytes;
+    auto const n = std::min(chunk_bytes, nbytes - begin);
+    auto const src_begin = offsets[std::size_t(i)];
+    auto const src_n = offsets[std::size_t(i + 1)] - src_begin;
+    ok[std::size_t(i)] = decompress_chunk(
+        compression, compressed.data() + src_begin, src_n, data + begin, n);
+  }
+  for (auto const chunk_ok : ok) OMEGA_H_CHECK(chunk_ok);
+}
+
 template <typename T>
 void swap_bytes(T& ptr) {
   SwapBytes<T>::swap(&ptr);
@@ -115,50 +403,134 @@ void read_value(std::istream& stream, T& val, bool needs_swapping) {
   if (needs_swapping) swap_bytes(val);
 }
 
-template <typename T>
-void write_array(std::ostream& stream, Read<T> array, bool is_compressed,
-    bool needs_swapping) {
-  if( !array.exists() ) return;
-  LO size = array.size();
-  write_value(stream, size, needs_swapping);
-  Read<T> swapped = swap_bytes(array, needs_swapping);
-  HostRead<T> uncompressed(swapped);
-  I64 uncompressed_bytes =
-      static_cast<I64>(static_cast<std::size_t>(size) * sizeof(T));
+/* writes array data that has already been byte swapped if needed */
+static void write_bytes(std::ostream& stream, char const* data, I64 nbytes,
+    I8 compression, bool needs_swapping, bool is_aligned) {
+  if (compression == COMPRESSION_NONE) {
+    if (is_aligned) write_padding(stream);
+    stream.write(data, nbytes);
+  } else if (compression == COMPRESSION_ZLIB_WHOLE) {
 #ifdef OMEGA_H_USE_ZLIB
-  if (is_compressed) {
-    uLong source_bytes = static_cast<uLong>(uncompressed_bytes);
+    uLong source_bytes = static_cast<uLong>(nbytes);
     uLong dest_bytes = ::compressBound(source_bytes);
     auto compressed = new ::Bytef[dest_bytes];
     int ret = ::compress2(compressed, &dest_bytes,
-        reinterpret_cast<const ::Bytef*>(nonnull(uncompressed.data())),
-        source_bytes, Z_BEST_SPEED);
+        reinterpret_cast<const ::Bytef*>(data), source_bytes, Z_BEST_SPEED);
     OMEGA_H_CHECK(ret == Z_OK);
     I64 compressed_bytes = static_cast<I64>(dest_bytes);
     write_value(stream, compressed_bytes, needs_swapping);
     stream.write(reinterpret_cast<const char*>(compressed), compressed_bytes);
     delete[] compressed;
-  } else
 #else
-  OMEGA_H_CHECK(is_compressed == false);
+    fail_unsupported_compression(compression);
 #endif
-  {
-    stream.write(reinterpret_cast<const char*>(nonnull(uncompressed.data())),
-        uncompressed_bytes);
+  } else {
+    write_chunks(stream, data, nbytes, compression, needs_swapping);
   }
 }
 
+namespace {
+
+struct DeferredArray {
+  std::size_t literal_end;
+  char const* data;
+  I64 nbytes;
+  I8 compression;
+  bool needs_swapping;
+  bool is_aligned;
+  std::shared_ptr<void> holder;
+};
+
+/* an output buffer that keeps everything but array data, and records
+   arrays by reference so they can be compressed and written later.
+   holder keeps each array alive; it must be created and released on
+   the thread that owns the mesh, since array handles are not
+   thread-safe */
+class DeferredStreambuf : public std::streambuf {
+ public:
+  void defer(DeferredArray array) {
+    array.literal_end = literal_.size();
+    arrays_.push_back(std::move(array));
+  }
+  void replay(std::ostream& stream) const {
+    std::size_t pos = 0;
+    for (auto const& array : arrays_) {
+      stream.write(literal_.data() + pos,
+          static_cast<std::streamsize>(array.literal_end - pos));
+      pos = array.literal_end;
+      write_bytes(stream, array.data, array.nbytes, array.compression,
+          array.needs_swapping, array.is_aligned);
+    }
+    stream.write(literal_.data() + pos,
+        static_cast<std::streamsize>(literal_.size() - pos));
+  }
+
+ protected:
+  std::streamsize xsputn(char const* s, std::streamsize n) override {
+    literal_.append(s, static_cast<std::size_t>(n));
+    return n;
+  }
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      literal_.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+  }
+
+ private:
+  std::string literal_;
+  std::vector<DeferredArray> arrays_;
+};
+
+}  // end anonymous namespace
+
 template <typename T>
-void read_array(std::istream& stream, Read<T>& array, bool is_compressed,
-    bool needs_swapping) {
+void write_array(std::ostream& stream, Read<T> array, I8 compression,
+    bool needs_swapping, bool is_aligned) {
+  if( !array.exists() ) return;
+  OMEGA_H_CHECK(!(compression && is_aligned));
+  LO size = array.size();
+  write_value(stream, size, needs_swapping);
+  Read<T> swapped = swap_bytes(array, needs_swapping);
+  HostRead<T> uncompressed(swapped);
+  I64 uncompressed_bytes =
+      static_cast<I64>(static_cast<std::size_t>(size) * sizeof(T));
+  auto const data =
+      reinterpret_cast<const char*>(nonnull(uncompressed.data()));
+  auto const deferred = dynamic_cast<DeferredStreambuf*>(stream.rdbuf());
+  if (deferred) {
+    deferred->defer({0, data, uncompressed_bytes, compression, needs_swapping,
+        is_aligned, std::make_shared<HostRead<T>>(uncompressed)});
+    return;
+  }
+  write_bytes(stream, data, uncompressed_bytes, compression, needs_swapping,
+      is_aligned);
+}
+
+template <typename T>
+void read_array(std::istream& stream, Read<T>& array, I8 compression,
+    bool needs_swapping, bool is_aligned) {
   LO size;
   read_value(stream, size, needs_swapping);
   OMEGA_H_CHECK(size >= 0);
+  if (is_aligned) skip_padding(stream);
+#ifdef OMEGA_H_HAVE_MMAP
+  if (compression == COMPRESSION_NONE) {
+    auto const buf = dynamic_cast<MappedStreambuf*>(stream.rdbuf());
+    if (buf) {
+      array = swap_bytes(read_mapped_array<T>(buf, size), needs_swapping);
+      return;
+    }
+  }
+#endif
   I64 uncompressed_bytes =
       static_cast<I64>(static_cast<std::size_t>(size) * sizeof(T));
   HostWrite<T> uncompressed(size);
+  if (compression == COMPRESSION_NONE) {
+    stream.read(reinterpret_cast<char*>(nonnull(uncompressed.data())),
+        uncompressed_bytes);
+  } else if (compression == COMPRESSION_ZLIB_WHOLE) {
 #ifdef OMEGA_H_USE_ZLIB
-  if (is_compressed) {
     I64 compressed_bytes;
     read_value(stream, compressed_bytes, needs_swapping);
     OMEGA_H_CHECK(compressed_bytes >= 0);
@@ -173,13 +545,12 @@ void read_array(std::istream& stream, Read<T>& array, bool is_compressed,
     OMEGA_H_CHECK(ret == Z_OK);
     OMEGA_H_CHECK(dest_bytes == static_cast<uLong>(uncompressed_bytes));
     delete[] compressed;
-  } else
 #else
-  OMEGA_H_CHECK(is_compressed == false);
+    fail_unsupported_compression(compression);
 #endif
-  {
-    stream.read(reinterpret_cast<char*>(nonnull(uncompressed.data())),
-        uncompressed_bytes);
+  } else {
+    read_chunks(stream, reinterpret_cast<char*>(uncompressed.data()),
+        uncompressed_bytes, compression, needs_swapping);
   }
   array = swap_bytes(Read<T>(uncompressed.write()), needs_swapping);
 }
@@ -272,7 +643,7 @@ static void read_meta(
 }
 
 static void write_tag(std::ostream& stream, TagBase const* tag,
-    Int ent_dim, bool is_compressed, bool needs_swapping) {
+    Int ent_dim, I8 compression, bool needs_swapping, bool is_aligned) {
   std::string name = tag->name();
   write(stream, name, needs_swapping);
   auto ncomps = I8(tag->ncomps());
@@ -288,24 +659,27 @@ static void write_tag(std::ostream& stream, TagBase const* tag,
   write(stream, "n_geom_ents", needs_swapping);
   write_value(stream, n_class_ids, needs_swapping);
   if (n_class_ids > 0) {
-    write_array(stream, class_ids, is_compressed, needs_swapping);
+    write_array(stream, class_ids, compression, needs_swapping, is_aligned);
   }
   auto f = [&](auto type) {
     using T = decltype(type);
-    write_array(stream, as<T>(tag)->array(), is_compressed, needs_swapping);
+    write_array(stream, as<T>(tag)->array(),
+        compression, needs_swapping, is_aligned);
   };
   apply_to_omega_h_types(tag->type(), std::move(f));
 }
 static void write_rc_tag(std::ostream& stream, TagBase const* tag,
-    Int ent_dim, Mesh *mesh, bool is_compressed, bool needs_swapping) {
+    Int ent_dim, Mesh *mesh, I8 compression, bool needs_swapping,
+    bool is_aligned) {
     auto rc_postfix_found = ((tag->name()).find("_rc") != std::string::npos);
     OMEGA_H_CHECK(rc_postfix_found);
   const auto rc_mesh_tag = mesh->get_rc_mesh_tag_from_rc_tag(ent_dim, tag);
-  write_tag(stream, rc_mesh_tag.get(), ent_dim, is_compressed,needs_swapping);
+  write_tag(stream, rc_mesh_tag.get(), ent_dim, compression,
+      needs_swapping, is_aligned);
 }
 
 static void read_tag(std::istream& stream, Mesh* mesh, Int d,
-    bool is_compressed, I32 version, bool needs_swapping) {
+    I8 compression, I32 version, bool needs_swapping, bool is_aligned) {
   std::string name;
   read(stream, name, needs_swapping);
   I8 ncomps;
@@ -329,14 +703,14 @@ static void read_tag(std::istream& stream, Mesh* mesh, Int d,
     I32 n_class_ids;
     read_value(stream, n_class_ids, needs_swapping);
     if (n_class_ids > 0) {
-      read_array(stream, class_ids, is_compressed, needs_swapping);
+      read_array(stream, class_ids, compression, needs_swapping, is_aligned);
     }
   }
 
   auto f = [&](auto t) {
     using T = decltype(t);
     Read<T> array;
-    read_array(stream, array, is_compressed, needs_swapping);
+    read_array(stream, array, compression, needs_swapping, is_aligned);
     if(is_rc_tag(name)) {
       mesh->set_rc_from_mesh_array(d,ncomps,class_ids,name,array);
     }
@@ -379,25 +753,26 @@ static void read_sets(std::istream& stream, Mesh* mesh, bool needs_swapping) {
   }
 }
 
-void write(std::ostream& stream, Mesh* mesh) {
+void write(std::ostream& stream, Mesh* mesh) { write(stream, mesh, false); }
+
+void write(std::ostream& stream, Mesh* mesh, bool aligned) {
   begin_code("binary::write(stream,Mesh)");
   stream.write(reinterpret_cast<const char*>(magic), sizeof(magic));
 // write_value(stream, latest_version); moved to /version at version 4
-#ifdef OMEGA_H_USE_ZLIB
-  I8 is_compressed = true;
-#else
-  I8 is_compressed = false;
-#endif
+  I8 compression = aligned ? I8(COMPRESSION_NONE) : I8(default_compression());
   bool needs_swapping = !is_little_endian_cpu();
-  write_value(stream, is_compressed, needs_swapping);
+  write_value(stream, compression, needs_swapping);
+  I8 is_aligned = aligned;
+  write_value(stream, is_aligned, needs_swapping);
   write_meta(stream, mesh, needs_swapping);
   LO nverts = mesh->nverts();
   write_value(stream, nverts, needs_swapping);
   for (Int d = 1; d <= mesh->dim(); ++d) {
     auto down = mesh->ask_down(d, d - 1);
-    write_array(stream, down.ab2b, is_compressed, needs_swapping);
+    write_array(stream, down.ab2b, compression, needs_swapping, is_aligned);
     if (d > 1) {
-      write_array(stream, down.codes, is_compressed, needs_swapping);
+      write_array(stream, down.codes,
+          compression, needs_swapping, is_aligned);
     }
   }
 
@@ -405,15 +780,19 @@ void write(std::ostream& stream, Mesh* mesh) {
     auto nsaved_tags = mesh->ntags(d) + mesh->nrctags(d);
     write_value(stream, nsaved_tags, needs_swapping);
     for (Int i = 0; i < mesh->ntags(d); ++i) {
-      write_tag(stream, mesh->get_tag(d, i), d, is_compressed, needs_swapping);
+      write_tag(stream, mesh->get_tag(d, i), d, compression, needs_swapping,
+          is_aligned);
     }
     for (const auto& rc_tag : mesh->get_rc_tags(d)) {
-      write_rc_tag(stream, rc_tag.get(), d, mesh, is_compressed, needs_swapping);
+      write_rc_tag(stream, rc_tag.get(), d, mesh, compression,
+          needs_swapping, is_aligned);
     }
     if (mesh->comm()->size() > 1) {
       auto owners = mesh->ask_owners(d);
-      write_array(stream, owners.ranks, is_compressed, needs_swapping);
-      write_array(stream, owners.idxs, is_compressed, needs_swapping);
+      write_array(stream, owners.ranks,
+          compression, needs_swapping, is_aligned);
+      write_array(stream, owners.idxs,
+          compression, needs_swapping, is_aligned);
     }
   }
   write_sets(stream, mesh, needs_swapping);
@@ -422,8 +801,10 @@ void write(std::ostream& stream, Mesh* mesh) {
   if (has_parents) {
     for (Int d = 0; d <= mesh->dim(); ++d) {
       auto parents = mesh->ask_parents(d);
-      write_array(stream, parents.parent_idx, is_compressed, needs_swapping);
-      write_array(stream, parents.codes, is_compressed, needs_swapping);
+      write_array(stream, parents.parent_idx,
+          compression, needs_swapping, is_aligned);
+      write_array(stream, parents.codes,
+          compression, needs_swapping, is_aligned);
     }
   }
   end_code();
@@ -439,20 +820,20 @@ void read(std::istream& stream, Mesh* mesh, I32 version) {
   if (version == -1) read_value(stream, version, needs_swapping);
   OMEGA_H_CHECK(version >= 1);
   OMEGA_H_CHECK(version <= latest_version);
-  I8 is_compressed;
-  read_value(stream, is_compressed, needs_swapping);
-#ifndef OMEGA_H_USE_ZLIB
-  OMEGA_H_CHECK(!is_compressed);
-#endif
+  I8 compression;
+  read_value(stream, compression, needs_swapping);
+  if (!can_compress(compression)) fail_unsupported_compression(compression);
+  I8 is_aligned = false;
+  if (version >= 11) read_value(stream, is_aligned, needs_swapping);
   read_meta(stream, mesh, version, needs_swapping);
   LO nverts;
   read_value(stream, nverts, needs_swapping);
   mesh->set_verts(nverts);
   for (Int d = 1; d <= mesh->dim(); ++d) {
     Adj down;
-    read_array(stream, down.ab2b, is_compressed, needs_swapping);
+    read_array(stream, down.ab2b, compression, needs_swapping, is_aligned);
     if (d > 1) {
-      read_array(stream, down.codes, is_compressed, needs_swapping);
+      read_array(stream, down.codes, compression, needs_swapping, is_aligned);
     }
     mesh->set_ents(d, down);
   }
@@ -460,12 +841,15 @@ void read(std::istream& stream, Mesh* mesh, I32 version) {
     Int ntags;
     read_value(stream, ntags, needs_swapping);
     for (Int i = 0; i < ntags; ++i) {
-      read_tag(stream, mesh, d, is_compressed, version, needs_swapping);
+      read_tag(stream, mesh, d, compression, version, needs_swapping,
+          is_aligned);
     }
     if (mesh->comm()->size() > 1) {
       Remotes owners;
-      read_array(stream, owners.ranks, is_compressed, needs_swapping);
-      read_array(stream, owners.idxs, is_compressed, needs_swapping);
+      read_array(stream, owners.ranks,
+          compression, needs_swapping, is_aligned);
+      read_array(stream, owners.idxs,
+          compression, needs_swapping, is_aligned);
       mesh->set_owners(d, owners);
     }
   }
@@ -478,8 +862,10 @@ void read(std::istream& stream, Mesh* mesh, I32 version) {
     if (has_parents) {
       for (Int d = 0; d <= mesh->dim(); ++d) {
         Parents parents;
-        read_array(stream, parents.parent_idx, is_compressed, needs_swapping);
-        read_array(stream, parents.codes, is_compressed, needs_swapping);
+        read_array(stream, parents.parent_idx,
+            compression, needs_swapping, is_aligned);
+        read_array(stream, parents.codes,
+            compression, needs_swapping, is_aligned);
         mesh->set_parents(d, parents);
       }
     }
@@ -539,7 +925,11 @@ I32 read_version(filesystem::path const& path, CommPtr comm) {
 }
 
 void write(filesystem::path const& path, Mesh* mesh) {
-  begin_code("binary::write(path,Mesh)");
+  write(path, mesh, false);
+}
+
+static filesystem::path prepare_write(
+    filesystem::path const& path, Mesh* mesh) {
   if (path.extension().string() != ".osh" && can_print(mesh)) {
     std::cout
         << "it is strongly recommended to end Omega_h paths in \".osh\",\n";
@@ -550,29 +940,113 @@ void write(filesystem::path const& path, Mesh* mesh) {
   auto filepath = path;
   filepath /= std::to_string(mesh->comm()->rank());
   filepath += ".osh";
-  std::ofstream file(filepath.c_str());
+  return filepath;
+}
+
+void write(filesystem::path const& path, Mesh* mesh, bool aligned) {
+  begin_code("binary::write(path,Mesh)");
+  auto const filepath = prepare_write(path, mesh);
+  std::ofstream file(filepath.c_str(), std::ios::binary);
   OMEGA_H_CHECK(file.is_open());
-  write(file, mesh);
+  write(file, mesh, aligned);
   write_nparts(path, mesh);
   write_version(path, mesh);
   mesh->comm()->barrier();
   end_code();
 }
 
-void read_in_comm(
-    filesystem::path const& path, CommPtr comm, Mesh* mesh, I32 version) {
-  ScopedTimer timer("binary::read_in_comm(path, comm, mesh, version)");
+struct DeferredWrite {
+  filesystem::path filepath;
+  DeferredStreambuf buf;
+};
+
+WriteFuture::WriteFuture() = default;
+
+WriteFuture::WriteFuture(
+    std::unique_ptr<DeferredWrite> state, std::future<void> result)
+    : state_(std::move(state)), result_(std::move(result)) {}
+
+WriteFuture::WriteFuture(WriteFuture&&) = default;
+
+WriteFuture& WriteFuture::operator=(WriteFuture&& other) {
+  if (this != &other) {
+    if (result_.valid()) result_.wait();
+    state_ = std::move(other.state_);
+    result_ = std::move(other.result_);
+  }
+  return *this;
+}
+
+/* the worker reads through state_, so wait before releasing it */
+WriteFuture::~WriteFuture() {
+  if (result_.valid()) result_.wait();
+}
+
+bool WriteFuture::completed() {
+  if (!result_.valid()) return true;
+  return result_.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+void WriteFuture::get() {
+  OMEGA_H_CHECK(result_.valid());
+  result_.wait();
+  auto result = std::move(result_);
+  state_.reset();
+  result.get();
+}
+
+WriteFuture write_async(
+    filesystem::path const& path, Mesh* mesh, bool aligned) {
+  ScopedTimer timer("binary::write_async(path, mesh)");
+  auto const filepath = prepare_write(path, mesh);
+  std::unique_ptr<DeferredWrite> state(new DeferredWrite{filepath, {}});
+  {
+    std::ostream stream(&state->buf);
+    write(stream, mesh, aligned);
+  }
+  write_nparts(path, mesh);
+  write_version(path, mesh);
+  auto const raw_state = state.get();
+  auto result = std::async(std::launch::async, [raw_state]() {
+    std::ofstream file(raw_state->filepath.c_str(), std::ios::binary);
+    OMEGA_H_CHECK(file.is_open());
+    raw_state->buf.replay(file);
+    file.close();
+    OMEGA_H_CHECK(!file.fail());
+  });
+  return WriteFuture(std::move(state), std::move(result));
+}
+
+static void read_part(filesystem::path const& path, CommPtr comm, Mesh* mesh,
+    I32 version, bool mapped) {
   mesh->set_comm(comm);
   auto filepath = path;
   filepath /= std::to_string(mesh->comm()->rank());
   if (version != -1) filepath += ".osh";
+#ifdef OMEGA_H_HAVE_MMAP
+  if (mapped) {
+    MappedStreambuf buf(std::make_shared<MappedFile>(filepath));
+    std::istream stream(&buf);
+    read(stream, mesh, version);
+    return;
+  }
+#else
+  (void)mapped;
+#endif
   std::ifstream file(filepath.c_str(), std::ios::binary);
   OMEGA_H_CHECK(file.is_open());
   read(file, mesh, version);
 }
 
-I32 read(filesystem::path const& path, CommPtr comm, Mesh* mesh, bool strict) {
-  ScopedTimer timer("binary::read(path, comm, mesh, strict)");
+void read_in_comm(
+    filesystem::path const& path, CommPtr comm, Mesh* mesh, I32 version) {
+  ScopedTimer timer("binary::read_in_comm(path, comm, mesh, version)");
+  read_part(path, comm, mesh, version, false);
+}
+
+static I32 read_parts(filesystem::path const& path, CommPtr comm, Mesh* mesh,
+    bool strict, bool mapped) {
   auto const nparts = read_nparts(path, comm);
   auto const version = read_version(path, comm);
   if (strict) {
@@ -583,7 +1057,7 @@ I32 read(filesystem::path const& path, CommPtr comm, Mesh* mesh, bool strict) {
           " doesn't match the number of MPI ranks %d\n",
           path.c_str(), nparts, comm->size());
     }
-    read_in_comm(path, comm, mesh, version);
+    read_part(path, comm, mesh, version, mapped);
   } else {
     if (nparts > comm->size()) {
       Omega_h_fail(
@@ -593,13 +1067,24 @@ I32 read(filesystem::path const& path, CommPtr comm, Mesh* mesh, bool strict) {
     auto const in_subcomm = (comm->rank() < nparts);
     auto const subcomm = comm->split(I32(!in_subcomm), 0);
     if (in_subcomm) {
-      read_in_comm(path, subcomm, mesh, version);
+      read_part(path, subcomm, mesh, version, mapped);
     }
     mesh->set_comm(comm);
   }
   return nparts;
 }
 
+I32 read(filesystem::path const& path, CommPtr comm, Mesh* mesh, bool strict) {
+  ScopedTimer timer("binary::read(path, comm, mesh, strict)");
+  return read_parts(path, comm, mesh, strict, false);
+}
+
+I32 read_mapped(
+    filesystem::path const& path, CommPtr comm, Mesh* mesh, bool strict) {
+  ScopedTimer timer("binary::read_mapped(path, comm, mesh, strict)");
+  return read_parts(path, comm, mesh, strict, true);
+}
+
 Mesh read(filesystem::path const& path, Library* lib, bool strict) {
   ScopedTimer timer("binary::read(path, lib, strict)");
   return binary::read(path, lib->world(), strict);
@@ -612,14 +1097,22 @@ Mesh read(filesystem::path const& path, CommPtr comm, bool strict) {
   return mesh;
 }
 
+Mesh read_mapped(filesystem::path const& path, CommPtr comm, bool strict) {
+  ScopedTimer timer("binary::read_mapped(path, comm, strict)");
+  auto mesh = Mesh(comm->library());
+  binary::read_mapped(path, comm, &mesh, strict);
+  return mesh;
+}
+
 #define OMEGA_H_INST(T)                                                        \
   template void swap_bytes(T&);                                                \
   template Read<T> swap_bytes(Read<T> array, bool is_little_endian);           \
   template void write_value(std::ostream& stream, T val, bool);                \
   template void read_value(std::istream& stream, T& val, bool);                \
-  template void write_array(std::ostream& stream, Read<T> array, bool, bool);  \
+  template void write_array(                                                   \
+      std::ostream& stream, Read<T> array, I8, bool, bool);                  \
   template void read_array(                                                    \
-      std::istream& stream, Read<T>& array, bool is_compressed, bool);
+      std::istream& stream, Read<T>& array, I8 compression, bool, bool);
 OMEGA_H_INST(I8)
 OMEGA_H_INST(I32)
 OMEGA_H_INST(I64)
@@ -1,7 +1,9 @@
 #ifndef OMEGA_H_FILE_HPP
 #define OMEGA_H_FILE_HPP
 
+#include <future>
 #include <iosfwd>
+#include <memory>
 #include <vector>
 
 #include <Omega_h_config.h>
@@ -137,10 +139,16 @@ static constexpr bool dont_compress = false;
 #endif
 TagSet get_all_vtk_tags(Mesh* mesh, Int cell_dim);
 TagSet get_all_vtk_tags_mix(Mesh* mesh, Int cell_dim);
+/* appended = true puts the (optionally compressed) array bytes raw in
+   an <AppendedData> section after the XML instead of base64 text */
+static constexpr bool do_append = true;
+static constexpr bool dont_append = false;
 void write_vtu(std::ostream& stream, Mesh* mesh, Int cell_dim,
-    TagSet const& tags, bool compress = OMEGA_H_DEFAULT_COMPRESS);
+    TagSet const& tags, bool compress = OMEGA_H_DEFAULT_COMPRESS,
+    bool appended = dont_append);
 void write_vtu(filesystem::path const& filename, Mesh* mesh, Int cell_dim,
-    TagSet const& tags, bool compress = OMEGA_H_DEFAULT_COMPRESS);
+    TagSet const& tags, bool compress = OMEGA_H_DEFAULT_COMPRESS,
+    bool appended = dont_append);
 void write_vtu(std::string const& filename, Mesh* mesh, Int cell_dim,
     bool compress = OMEGA_H_DEFAULT_COMPRESS);
 void write_vtu(std::string const& filename, Mesh* mesh,
@@ -150,7 +158,8 @@ void write_vtu(filesystem::path const& filename, MixedMesh* mesh, Topo_type max_
     bool compress = OMEGA_H_DEFAULT_COMPRESS);
 
 void write_parallel(filesystem::path const& path, Mesh* mesh, Int cell_dim,
-    TagSet const& tags, bool compress = OMEGA_H_DEFAULT_COMPRESS);
+    TagSet const& tags, bool compress = OMEGA_H_DEFAULT_COMPRESS,
+    bool appended = dont_append);
 void write_parallel(std::string const& path, Mesh* mesh, Int cell_dim,
     bool compress = OMEGA_H_DEFAULT_COMPRESS);
 void write_parallel(std::string const& path, Mesh* mesh,
@@ -164,6 +173,7 @@ class Writer {
   filesystem::path root_path_;
   Int cell_dim_;
   bool compress_;
+  bool appended_;
   I64 step_;
   std::streampos pvd_pos_;
 
@@ -173,7 +183,8 @@ class Writer {
   Writer& operator=(Writer const&) = default;
   ~Writer() = default;
   Writer(filesystem::path const& root_path, Mesh* mesh, Int cell_dim = -1,
-      Real restart_time = 0.0, bool compress = OMEGA_H_DEFAULT_COMPRESS);
+      Real restart_time = 0.0, bool compress = OMEGA_H_DEFAULT_COMPRESS,
+      bool appended = dont_append);
   void write();
   void write(Real time);
   void write(Real time, TagSet const& tags);
@@ -185,7 +196,8 @@ class FullWriter {
  public:
   FullWriter() = default;
   FullWriter(filesystem::path const& root_path, Mesh* mesh,
-      Real restart_time = 0.0, bool compress = OMEGA_H_DEFAULT_COMPRESS);
+      Real restart_time = 0.0, bool compress = OMEGA_H_DEFAULT_COMPRESS,
+      bool appended = dont_append);
   void write(Real time);
   void write();
 };
@@ -194,16 +206,86 @@ class FullWriter {
 namespace binary {
 
 void write(filesystem::path const& path, Mesh* mesh);
+/* aligned = true stores arrays uncompressed, each starting at a multiple
+   of array_alignment bytes, so that read_mapped can use them in place */
+void write(filesystem::path const& path, Mesh* mesh, bool aligned);
+
+struct DeferredWrite;
+
+/**
+ * \brief Handle to a checkpoint being written in the background.
+ *
+ * Destroying a pending handle waits for the write to finish.
+ */
+class WriteFuture {
+ public:
+  WriteFuture();
+  WriteFuture(std::unique_ptr<DeferredWrite> state, std::future<void> result);
+  WriteFuture(WriteFuture&&);
+  WriteFuture& operator=(WriteFuture&&);
+  ~WriteFuture();
+  /// \return true if this rank's part file has been written
+  bool completed();
+  /// wait for this rank's part file to be written, rethrowing any error
+  /// raised while writing it. This method can only be called once.
+  void get();
+
+ private:
+  std::unique_ptr<DeferredWrite> state_;
+  std::future<void> result_;
+};
+
+/* same file contents as write(), but only the directory setup and a
+   snapshot of the mesh's array handles happen on the calling thread.
+   byte swapping, compression and file output run on a background
+   thread, and the mesh may be modified or destroyed meanwhile.
+   get() is local: call it on every rank (and barrier) before
+   reading the checkpoint back */
+WriteFuture write_async(
+    filesystem::path const& path, Mesh* mesh, bool aligned = false);
+
 Mesh read(filesystem::path const& path, Library* lib, bool strict = false);
 Mesh read(filesystem::path const& path, CommPtr comm, bool strict = false);
 I32 read(filesystem::path const& path, CommPtr comm, Mesh* mesh,
     bool strict = false);
+/* like read(), but memory-maps each part file instead of streaming it.
+   on host builds without Kokkos, native-endian arrays of files written
+   with aligned = true are views of the mapped pages rather than copies */
+Mesh read_mapped(filesystem::path const& path, CommPtr comm,
+    bool strict = false);
+I32 read_mapped(filesystem::path const& path, CommPtr comm, Mesh* mesh,
+    bool strict = false);
+/* a single file for all ranks instead of a directory of part files:
+   each rank writes its owned entities into rank-ordered global arrays
+   with collective MPI-IO, indexed by a header of array offsets.
+   read_shared works with any number of ranks; it reads contiguous
+   slices and partitions them like exodus::read_sliced, producing an
+   element-based mesh. parents and rc tags are not stored */
+void write_shared(filesystem::path const& path, Mesh* mesh);
+Mesh read_shared(filesystem::path const& path, CommPtr comm);
 I32 read_nparts(filesystem::path const& path, CommPtr comm);
 I32 read_version(filesystem::path const& path, CommPtr comm);
 void read_in_comm(
     filesystem::path const& path, CommPtr comm, Mesh* mesh, I32 version);
 
-constexpr I32 latest_version = 10;
+constexpr I32 latest_version = 12;
+constexpr std::size_t array_alignment = 64;
+
+/* how a file's arrays are compressed, stored once per file.
+   files before version 12 only use NONE and ZLIB_WHOLE;
+   the other modes split each array into compression_chunk_bytes
+   pieces which are (de)compressed independently and in parallel */
+enum Compression : I8 {
+  COMPRESSION_NONE = 0,
+  COMPRESSION_ZLIB_WHOLE = 1,
+  COMPRESSION_ZLIB = 2,
+  COMPRESSION_ZSTD = 3,
+};
+constexpr I64 compression_chunk_bytes = I64(1) << 20;
+
+/* the fastest chunked mode this build supports */
+Compression default_compression();
+bool can_compress(I8 compression);
 
 template <typename T>
 void swap_bytes(T&);
@@ -216,16 +298,17 @@ void write_value(std::ostream& stream, T val, bool needs_swapping);
 template <typename T>
 void read_value(std::istream& stream, T& val, bool needs_swapping);
 template <typename T>
-void write_array(std::ostream& stream, Read<T> array, bool is_compressed,
-    bool needs_swapping);
+void write_array(std::ostream& stream, Read<T> array, I8 compression,
+    bool needs_swapping, bool is_aligned = false);
 template <typename T>
-void read_array(std::istream& stream, Read<T>& array, bool is_compressed,
-    bool needs_swapping);
+void read_array(std::istream& stream, Read<T>& array, I8 compression,
+    bool needs_swapping, bool is_aligned = false);
 
 void write(std::ostream& stream, std::string const& val, bool needs_swapping);
 void read(std::istream& stream, std::string& val, bool needs_swapping);
 
 void write(std::ostream& stream, Mesh* mesh);
+void write(std::ostream& stream, Mesh* mesh, bool aligned);
 void read(std::istream& stream, Mesh* mesh, I32 version);
 
 #define INST_DECL(T)                                                           \
@@ -234,9 +317,9 @@ void read(std::istream& stream, Mesh* mesh, I32 version);
   extern template void write_value(std::ostream& stream, T val, bool);         \
   extern template void read_value(std::istream& stream, T& val, bool);         \
   extern template void write_array(                                            \
-      std::ostream& stream, Read<T> array, bool, bool);                        \
+      std::ostream& stream, Read<T> array, I8, bool, bool);                    \
   extern template void read_array(                                             \
-      std::istream& stream, Read<T>& array, bool, bool);
+      std::istream& stream, Read<T>& array, I8, bool, bool);
 INST_DECL(I8)
 INST_DECL(I32)
 INST_DECL(I64)
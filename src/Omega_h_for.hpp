@@ -85,6 +85,7 @@ void for_each(InputIterator first, InputIterator last, UnaryFunction&& f) {
 template <typename UnaryFunction>
 void parallel_for(LO n, UnaryFunction&& f) {
   OMEGA_H_TIME_FUNCTION;
+  profile::ScopedKernel kernel(n);
   auto const first = IntIterator(0);
   auto const last = IntIterator(n);
   ::Omega_h::for_each(first, last, f);
@@ -92,6 +93,7 @@ void parallel_for(LO n, UnaryFunction&& f) {
 
 template <typename T>
 void parallel_for(LO n, T const& f, char const* name = "") {
+  profile::ScopedKernel kernel(n, name);
 #if defined(OMEGA_H_USE_KOKKOS)
   if (n > 0) {
     Kokkos::parallel_for(name, policy(n), f);
@@ -100,6 +100,7 @@ static Dist close_down(Mesh* mesh, Remotes old_use_owners, Dist elems2owners) {
 }
 
 void ghost_mesh(Mesh* mesh, Int nlayers, bool verbose) {
+  OMEGA_H_TIME_FUNCTION;
   OMEGA_H_CHECK(mesh->nghost_layers() >= 0);
   OMEGA_H_CHECK(nlayers > mesh->nghost_layers());
   auto nnew_layers = nlayers - mesh->nghost_layers();
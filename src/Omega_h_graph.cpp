@@ -1,9 +1,11 @@
 #include "Omega_h_graph.hpp"
 
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_atomics.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_int_scan.hpp"
 #include "Omega_h_map.hpp"
+#include "Omega_h_sort.hpp"
 
 namespace Omega_h {
 
@@ -164,6 +166,209 @@ Read<T> map_onto(Read<T> a_data, Graph a2b, LO nb, T init_val, Int width) {
   return out;
 }
 
+/* the edges leaving a frontier of nodes: fan2front is the position
+   of each edge's source in the frontier and fan2node its target.
+   the work is proportional to the edges of the frontier, not to
+   the size of the graph */
+static void get_frontier_fan(Graph g, LOs degrees, LOs frontier,
+    LOs* fan2front_out, LOs* fan2node_out) {
+  auto const a2ab = g.a2ab;
+  auto const ab2b = g.ab2b;
+  auto const front2fan = offset_scan(read(unmap(frontier, degrees, 1)));
+  auto const fan2node = Write<LO>(front2fan.last());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto const a = frontier[i];
+    auto fan = front2fan[i];
+    for (auto ab = a2ab[a]; ab < a2ab[a + 1]; ++ab) fan2node[fan++] = ab2b[ab];
+  };
+  parallel_for(frontier.size(), f, "get_frontier_fan");
+  *fan2front_out = invert_fan(front2fan);
+  *fan2node_out = fan2node;
+}
+
+/* breadth-first search from start within its connected component,
+   expanding one frontier per level. visited holds the id of the last
+   search to reach each node, so one array serves every search without
+   being reset. returns the number of levels and the last level */
+static LO search_breadth_first(Graph g, LOs degrees, LO start,
+    Write<LO> visited, LO search, LOs* last_out) {
+  visited.set(start, search);
+  auto frontier = LOs({start});
+  LO nlevels = 1;
+  while (true) {
+    LOs fan2front, fan2node;
+    get_frontier_fan(g, degrees, frontier, &fan2front, &fan2node);
+    Write<I8> claimed(fan2node.size());
+    auto f = OMEGA_H_LAMBDA(LO fan) {
+      auto const b = fan2node[fan];
+      I8 claim = 0;
+      auto old = visited[b];
+      while (old != search) {
+        auto const prev = atomic_compare_exchange(&visited[b], old, search);
+        if (prev == old) {
+          claim = 1;
+          break;
+        }
+        old = prev;
+      }
+      claimed[fan] = claim;
+    };
+    parallel_for(fan2node.size(), f, "bfs_claim");
+    auto const next = read(unmap(collect_marked(read(claimed)), fan2node, 1));
+    if (next.size() == 0) {
+      *last_out = frontier;
+      return nlevels;
+    }
+    frontier = next;
+    ++nlevels;
+  }
+}
+
+/* the node with the lowest (degree, index) among the given nodes */
+static LO get_lowest_degree(LOs degrees, LOs nodes) {
+  auto const n = degrees.size();
+  Write<GO> keys(nodes.size());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto const a = nodes[i];
+    keys[i] = GO(degrees[a]) * n + a;
+  };
+  parallel_for(nodes.size(), f, "lowest_degree_keys");
+  return LO(get_min(read(keys)) % n);
+}
+
+/* the George-Liu search for a node of (nearly) maximal eccentricity:
+   restart from the lowest-degree node of the last level for as long
+   as that adds levels */
+static LO find_pseudo_peripheral(
+    Graph g, LOs degrees, LO start, Write<LO> visited, LO* nsearches) {
+  constexpr Int max_searches = 8;
+  auto root = start;
+  auto best_root = start;
+  LO best_nlevels = 0;
+  for (Int i = 0; i < max_searches; ++i) {
+    LOs last;
+    auto const nlevels =
+        search_breadth_first(g, degrees, root, visited, (*nsearches)++, &last);
+    if (nlevels <= best_nlevels) break;
+    best_root = root;
+    best_nlevels = nlevels;
+    root = get_lowest_degree(degrees, last);
+  }
+  return best_root;
+}
+
+/* numbers the connected component of root in Cuthill-McKee order,
+   starting from offset, and returns the next free number.
+   a level is numbered all at once: its nodes are sorted by
+   their lowest-numbered neighbor in the previous level, then by
+   degree, which is the order in which the serial algorithm
+   would visit them.
+   parents holds, negated, the lowest position in the frontier adjacent
+   to each node. a node is only ever adjacent to one frontier before
+   being numbered, so it is never reset.
+   numbered is a host copy of which nodes have a number */
+static LO number_cuthill_mckee(Graph g, LOs degrees, GO max_degree, LO root,
+    LO offset, Write<LO> old2new, Write<LO> parents,
+    HostWrite<I8> numbered) {
+  old2new.set(root, offset);
+  numbered[root] = 1;
+  auto frontier = LOs({root});
+  auto end = offset + 1;
+  while (true) {
+    LOs fan2front, fan2node;
+    get_frontier_fan(g, degrees, frontier, &fan2front, &fan2node);
+    auto f = OMEGA_H_LAMBDA(LO fan) {
+      auto const b = fan2node[fan];
+      if (old2new[b] == -1) atomic_max(&parents[b], -fan2front[fan]);
+    };
+    parallel_for(fan2node.size(), f, "cuthill_mckee_parent");
+    Write<I8> is_child(fan2node.size());
+    auto g2 = OMEGA_H_LAMBDA(LO fan) {
+      auto const b = fan2node[fan];
+      is_child[fan] = (old2new[b] == -1 && parents[b] == -fan2front[fan]);
+    };
+    parallel_for(fan2node.size(), g2, "cuthill_mckee_child");
+    auto const children = collect_marked(read(is_child));
+    if (children.size() == 0) return end;
+    auto const next = read(unmap(children, fan2node, 1));
+    auto const next_parents = read(unmap(children, fan2front, 1));
+    Write<GO> keys(next.size());
+    auto h = OMEGA_H_LAMBDA(LO i) {
+      keys[i] = GO(next_parents[i]) * max_degree + degrees[next[i]];
+    };
+    parallel_for(next.size(), h, "cuthill_mckee_keys");
+    auto const order = read(unmap(sort_by_keys(read(keys)), next, 1));
+    auto const next_begin = end;
+    auto k = OMEGA_H_LAMBDA(LO i) { old2new[order[i]] = next_begin + i; };
+    parallel_for(order.size(), k, "cuthill_mckee_number");
+    auto const host_order = HostRead<LO>(order);
+    for (LO i = 0; i < host_order.size(); ++i) numbered[host_order[i]] = 1;
+    frontier = order;
+    end += order.size();
+  }
+}
+
+LOs reverse_cuthill_mckee(Graph g) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const n = g.nnodes();
+  auto const degrees = get_degrees(g.a2ab);
+  auto const max_degree = GO(get_max(degrees)) + 1;
+  Write<LO> old2new(n, -1);
+  Write<LO> visited(n, -1);
+  Write<LO> parents(n, ArithTraits<LO>::min());
+  HostWrite<I8> numbered(n);
+  for (LO a = 0; a < n; ++a) numbered[a] = 0;
+  LO nsearches = 0;
+  LO numbered_count = 0;
+  /* each connected component starts from the first node not yet
+     numbered, which the cursor carries forward */
+  for (LO start = 0; numbered_count < n; ++start) {
+    if (numbered[start]) continue;
+    auto const root =
+        find_pseudo_peripheral(g, degrees, start, visited, &nsearches);
+    numbered_count = number_cuthill_mckee(g, degrees, max_degree, root,
+        numbered_count, old2new, parents, numbered);
+  }
+  Write<LO> new2old(n);
+  auto f = OMEGA_H_LAMBDA(LO a) { new2old[n - 1 - old2new[a]] = a; };
+  parallel_for(n, f, "reverse_cuthill_mckee");
+  return new2old;
+}
+
+LO get_bandwidth(Graph g) {
+  auto const a2ab = g.a2ab;
+  auto const ab2b = g.ab2b;
+  auto const n = g.nnodes();
+  if (n == 0) return 0;
+  Write<LO> widths(n);
+  auto f = OMEGA_H_LAMBDA(LO a) {
+    LO w = 0;
+    for (auto ab = a2ab[a]; ab < a2ab[a + 1]; ++ab) {
+      auto const d = ab2b[ab] - a;
+      w = max2(w, (d < 0) ? -d : d);
+    }
+    widths[a] = w;
+  };
+  parallel_for(n, f, "get_bandwidth");
+  return get_max(read(widths));
+}
+
+GO get_profile(Graph g) {
+  auto const a2ab = g.a2ab;
+  auto const ab2b = g.ab2b;
+  auto const n = g.nnodes();
+  Write<GO> widths(n);
+  auto f = OMEGA_H_LAMBDA(LO a) {
+    auto lowest = a;
+    for (auto ab = a2ab[a]; ab < a2ab[a + 1]; ++ab) {
+      lowest = min2(lowest, ab2b[ab]);
+    }
+    widths[a] = a - lowest;
+  };
+  parallel_for(n, f, "get_profile");
+  return get_sum(read(widths));
+}
+
 #define INST(T)                                                                \
   template Read<T> graph_reduce(Graph, Read<T>, Int, Omega_h_Op);              \
   template void map_into(                                                      \
@@ -54,6 +54,22 @@ Graph identity_graph(LO nnodes);
 
 Graph add_self_edges(Graph g);
 
+/**
+ * \brief reverse Cuthill-McKee ordering of an undirected graph
+ * \details each connected component is numbered breadth-first from
+ *          a pseudo-peripheral node, which keeps the bandwidth and
+ *          profile of the graph's adjacency matrix low
+ * \return the old node of each new node (new2old)
+ */
+LOs reverse_cuthill_mckee(Graph g);
+/** \brief the largest index distance between adjacent nodes */
+LO get_bandwidth(Graph g);
+/**
+ * \brief the profile (envelope size) of the adjacency matrix:
+ *        the sum over nodes of the distance to the lowest adjacent node
+ */
+GO get_profile(Graph g);
+
 template <typename T>
 void map_into(Read<T> a_data, Graph a2b, Write<T> b_data, Int width);
 template <typename T>
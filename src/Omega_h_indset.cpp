@@ -1,5 +1,7 @@
 #include "Omega_h_indset_inline.hpp"
 
+#include "Omega_h_timer.hpp"
+
 namespace Omega_h {
 
 struct QualityCompare {
@@ -14,23 +16,74 @@ struct QualityCompare {
   }
 };
 
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Graph graph, Reals quality, Read<I8> candidates) {
+/* the splitmix64 finalizer: neighboring global IDs get unrelated
+   priorities, and since it is a bijection, distinct ones */
+OMEGA_H_INLINE GO hash_global(GO global) {
+  auto x = std::uint64_t(global);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  x = x ^ (x >> 31);
+  return GO(x);
+}
+
+GOs hash_globals(GOs globals) {
+  Write<GO> out(globals.size());
+  auto f = OMEGA_H_LAMBDA(LO i) { out[i] = hash_global(globals[i]); };
+  parallel_for(out.size(), f, "hash_globals");
+  return out;
+}
+
+struct HashedQualityCompare {
+  Reals quality;
+  GOs hashed;
+  GOs global;
+  OMEGA_H_DEVICE bool operator()(LO u, LO v) const {
+    auto const v_qual = quality[v];
+    auto const u_qual = quality[u];
+    if (u_qual != v_qual) return u_qual < v_qual;
+    if (hashed[u] != hashed[v]) return hashed[u] < hashed[v];
+    return global[u] < global[v];
+  }
+};
+
+static IndsetStats indset_stats = {0, 0, 0, 0.0};
+
+IndsetStats get_indset_stats() { return indset_stats; }
+
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Graph graph, Reals quality,
+    Read<I8> candidates, IndsetEngine engine) {
+  auto const t0 = now();
   auto xadj = graph.a2ab;
   auto adj = graph.ab2b;
-  QualityCompare compare;
-  compare.quality = quality;
-  compare.global = mesh->globals(ent_dim);
-  return indset::find(mesh, ent_dim, xadj, adj, candidates, compare);
+  auto global = mesh->globals(ent_dim);
+  Read<I8> out;
+  if (engine == RELAXED_INDSET) {
+    HashedQualityCompare compare;
+    compare.quality = quality;
+    compare.hashed = hash_globals(global);
+    compare.global = global;
+    out = indset::find(mesh, ent_dim, xadj, adj, candidates, compare, engine,
+        &indset_stats);
+  } else {
+    QualityCompare compare;
+    compare.quality = quality;
+    compare.global = global;
+    out = indset::find(mesh, ent_dim, xadj, adj, candidates, compare, engine,
+        &indset_stats);
+  }
+  ++indset_stats.ncalls;
+  indset_stats.time += now() - t0;
+  return out;
 }
 
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Reals quality, Read<I8> candidates) {
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Reals quality,
+    Read<I8> candidates, IndsetEngine engine) {
   if (ent_dim == mesh->dim()) return candidates;
-  mesh->owners_have_all_upward(ent_dim);
-  OMEGA_H_CHECK(mesh->owners_have_all_upward(ent_dim));
+  /* element-based stars are split among the copies, which
+     indset::iteration combines */
+  OMEGA_H_CHECK(mesh->parting() != OMEGA_H_VERT_BASED);
   auto graph = mesh->ask_star(ent_dim);
-  return find_indset(mesh, ent_dim, graph, quality, candidates);
+  return find_indset(mesh, ent_dim, graph, quality, candidates, engine);
 }
 
 }  // end namespace Omega_h
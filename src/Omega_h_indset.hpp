@@ -8,10 +8,32 @@ namespace Omega_h {
 
 class Mesh;
 
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Graph graph, Reals quality, Read<I8> candidates);
-Read<I8> find_indset(
-    Mesh* mesh, Int ent_dim, Reals quality, Read<I8> candidates);
+/* SYNCHRONOUS_INDSET takes one Luby-style step over all candidates
+   per exchange of ghost states, breaking quality ties by global ID.
+   RELAXED_INDSET repeats local steps over the owned candidates until
+   none changes before each exchange, and breaks ties by a hash of
+   the global ID, so chains of equal quality do not turn into
+   chains of exchanges. both find a maximal independent set,
+   but not necessarily the same one. */
+enum IndsetEngine { SYNCHRONOUS_INDSET, RELAXED_INDSET };
+
+/* running totals over all calls to find_indset on this rank */
+struct IndsetStats {
+  Int ncalls;
+  Int nrounds;  /* exchanges of ghost states */
+  Int nsweeps;  /* local steps */
+  Real time;
+};
+
+IndsetStats get_indset_stats();
+
+/* reproducible pseudo-random priorities, distinct for distinct IDs */
+GOs hash_globals(GOs globals);
+
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Graph graph, Reals quality,
+    Read<I8> candidates, IndsetEngine engine = SYNCHRONOUS_INDSET);
+Read<I8> find_indset(Mesh* mesh, Int ent_dim, Reals quality,
+    Read<I8> candidates, IndsetEngine engine = SYNCHRONOUS_INDSET);
 
 }  // end namespace Omega_h
 
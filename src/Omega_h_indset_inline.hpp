@@ -42,17 +42,84 @@ inline Read<I8> local_iteration(
   return new_state;
 }
 
+/* without ghosts, each copy sees some of the neighbors. a node is
+   rejected if any copy rejects it and chosen only if all copies do */
+inline Read<I8> combine_copies(Mesh* mesh, Int dim, Read<I8> local_state) {
+  auto n = local_state.size();
+  Write<I8> ranked(n);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto state = local_state[v];
+    ranked[v] = (state == NOT_IN) ? 0 : ((state == UNKNOWN) ? 1 : 2);
+  };
+  parallel_for(n, std::move(f));
+  auto min_ranked = mesh->reduce_array(dim, Read<I8>(ranked), 1, OMEGA_H_MIN);
+  Write<I8> state(n);
+  auto g = OMEGA_H_LAMBDA(LO v) {
+    auto r = min_ranked[v];
+    state[v] = (r == 0) ? NOT_IN : ((r == 1) ? UNKNOWN : IN);
+  };
+  parallel_for(n, std::move(g));
+  return state;
+}
+
 template <class Compare>
 Read<I8> iteration(Mesh* mesh, Int dim, LOs xadj, LOs adj, Read<I8> old_state,
     Compare compare) {
   auto local_state = local_iteration(xadj, adj, old_state, compare);
+  if (!mesh->owners_have_all_upward(dim)) {
+    local_state = combine_copies(mesh, dim, local_state);
+  }
   auto synced_state = mesh->sync_array(dim, local_state, 1);
   return synced_state;
 }
 
+template <class Compare>
+inline Read<I8> local_relaxation(LOs xadj, LOs adj, Read<I8> owned,
+    Read<I8> old_state, Compare compare) {
+  auto n = xadj.size() - 1;
+  Write<I8> new_state = deep_copy(old_state);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    if (old_state[v] != UNKNOWN) return;
+    auto begin = xadj[v];
+    auto end = xadj[v + 1];
+    // nodes adjacent to chosen ones are rejected, even ghosts
+    for (auto j = begin; j < end; ++j) {
+      auto u = adj[j];
+      if (old_state[u] == IN) {
+        new_state[v] = NOT_IN;
+        return;
+      }
+    }
+    // a ghost may have neighbors we can't see, only its owner chooses it
+    if (!owned[v]) return;
+    for (auto j = begin; j < end; ++j) {
+      auto u = adj[j];
+      if (old_state[u] == NOT_IN) continue;
+      if (!compare(u, v)) return;
+    }
+    new_state[v] = IN;
+  };
+  parallel_for(n, std::move(f));
+  return new_state;
+}
+
+/* local steps until nothing changes, then one exchange */
+template <class Compare>
+Read<I8> relaxation(Mesh* mesh, Int dim, LOs xadj, LOs adj, Read<I8> owned,
+    Read<I8> old_state, Compare compare, IndsetStats* stats) {
+  auto state = old_state;
+  while (true) {
+    auto new_state = local_relaxation(xadj, adj, owned, state, compare);
+    ++stats->nsweeps;
+    if (new_state == state) break;
+    state = new_state;
+  }
+  return mesh->sync_array(dim, state, 1);
+}
+
 template <class Compare>
 Read<I8> find(Mesh* mesh, Int dim, LOs xadj, LOs adj, Read<I8> candidates,
-    Compare compare) {
+    Compare compare, IndsetEngine engine, IndsetStats* stats) {
   auto n = xadj.size() - 1;
   OMEGA_H_CHECK(candidates.size() == n);
   auto initial_state = Write<I8>(n);
@@ -65,11 +132,28 @@ Read<I8> find(Mesh* mesh, Int dim, LOs xadj, LOs adj, Read<I8> candidates,
   parallel_for(n, f);
   auto comm = mesh->comm();
   auto state = Read<I8>(initial_state);
+  /* an owner without ghosts may not see all neighbors of its node */
+  if (!mesh->owners_have_all_upward(dim)) engine = SYNCHRONOUS_INDSET;
+  auto owned = (engine == RELAXED_INDSET) ? mesh->owned(dim) : Read<I8>();
   while (get_max(comm, state) == UNKNOWN) {
-    state = iteration(mesh, dim, xadj, adj, state, compare);
+    if (engine == RELAXED_INDSET) {
+      state = relaxation(mesh, dim, xadj, adj, owned, state, compare, stats);
+    } else {
+      state = iteration(mesh, dim, xadj, adj, state, compare);
+      ++stats->nsweeps;
+    }
+    ++stats->nrounds;
   }
   return state;
 }
+
+template <class Compare>
+Read<I8> find(Mesh* mesh, Int dim, LOs xadj, LOs adj, Read<I8> candidates,
+    Compare compare) {
+  IndsetStats stats{};
+  return find(mesh, dim, xadj, adj, candidates, compare, SYNCHRONOUS_INDSET,
+      &stats);
+}
 }  // namespace indset
 }  // namespace Omega_h
 
@@ -1,44 +1,526 @@
 #include "Omega_h_laplace.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_int_scan.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
 #include "Omega_h_mesh.hpp"
 
 namespace Omega_h {
 
-Reals solve_laplacian(
-    Mesh* mesh, Reals initial, Int width, Real tol, Real floor) {
+namespace {
+
+/* compressed sparse rows, the diagonal entry first in each row */
+struct CsrMatrix {
+  LOs row_offsets;
+  LOs cols;
+  Reals values;
+  LO nrows() const { return row_offsets.size() - 1; }
+};
+
+struct HostCsrMatrix {
+  std::vector<LO> row_offsets;
+  std::vector<LO> cols;
+  std::vector<Real> values;
+  LO ncols;
+  LO nrows() const { return LO(row_offsets.size()) - 1; }
+};
+
+template <typename T>
+Read<T> to_device(std::vector<T> const& v) {
+  HostWrite<T> h(LO(v.size()));
+  for (LO i = 0; i < h.size(); ++i) h[i] = v[std::size_t(i)];
+  return h.write();
+}
+
+template <typename T>
+std::vector<T> to_host(Read<T> a) {
+  HostRead<T> h(a);
+  return std::vector<T>(h.data(), h.data() + h.size());
+}
+
+CsrMatrix to_device(HostCsrMatrix const& a) {
+  return {to_device(a.row_offsets), to_device(a.cols), to_device(a.values)};
+}
+
+HostCsrMatrix to_host(CsrMatrix const& a, LO ncols) {
+  return {to_host(a.row_offsets), to_host(a.cols), to_host(a.values), ncols};
+}
+
+Reals multiply(CsrMatrix const& a, Reals x) {
+  auto row_offsets = a.row_offsets;
+  auto cols = a.cols;
+  auto values = a.values;
+  Write<Real> y(a.nrows());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    Real sum = 0.0;
+    for (auto k = row_offsets[i]; k < row_offsets[i + 1]; ++k) {
+      sum += values[k] * x[cols[k]];
+    }
+    y[i] = sum;
+  };
+  parallel_for(a.nrows(), f, "csr_multiply");
+  return y;
+}
+
+/* one damped Jacobi sweep, x + weights * (b - a * x),
+   where weights holds the damping factor over each diagonal entry */
+Reals jacobi_sweep(CsrMatrix const& a, Reals weights, Reals b, Reals x) {
+  auto row_offsets = a.row_offsets;
+  auto cols = a.cols;
+  auto values = a.values;
+  Write<Real> y(a.nrows());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto r = b[i];
+    for (auto k = row_offsets[i]; k < row_offsets[i + 1]; ++k) {
+      r -= values[k] * x[cols[k]];
+    }
+    y[i] = x[i] + weights[i] * r;
+  };
+  parallel_for(a.nrows(), f, "jacobi_sweep");
+  return y;
+}
+
+std::vector<Real> get_diagonal(HostCsrMatrix const& a) {
+  std::vector<Real> diagonal(std::size_t(a.nrows()));
+  for (std::size_t i = 0; i < diagonal.size(); ++i) {
+    diagonal[i] = a.values[std::size_t(a.row_offsets[i])];
+  }
+  return diagonal;
+}
+
+/* the Gershgorin bound on the spectral radius of D^{-1} A */
+Real get_jacobi_radius(HostCsrMatrix const& a) {
+  auto const diagonal = get_diagonal(a);
+  Real radius = 0.0;
+  for (std::size_t i = 0; i < diagonal.size(); ++i) {
+    Real row_sum = 0.0;
+    for (auto k = a.row_offsets[i]; k < a.row_offsets[i + 1]; ++k) {
+      row_sum += std::abs(a.values[std::size_t(k)]);
+    }
+    radius = std::max(radius, row_sum / diagonal[i]);
+  }
+  return radius;
+}
+
+/* rows built one at a time by summing into a sparse accumulator,
+   keeping the column that matches the row (if any) first */
+struct RowBuilder {
+  std::vector<Real> sums;
+  std::vector<LO> cols;
+  std::vector<char> touched;
+  HostCsrMatrix out;
+  RowBuilder(LO ncols)
+      : sums(std::size_t(ncols), 0.0), touched(std::size_t(ncols), 0) {
+    out.row_offsets.push_back(0);
+    out.ncols = ncols;
+  }
+  void add(LO col, Real value) {
+    auto const c = std::size_t(col);
+    if (!touched[c]) {
+      touched[c] = 1;
+      cols.push_back(col);
+    }
+    sums[c] += value;
+  }
+  void end_row() {
+    auto const row = out.nrows();
+    std::sort(cols.begin(), cols.end(), [row](LO a, LO b) {
+      if ((a == row) != (b == row)) return a == row;
+      return a < b;
+    });
+    for (auto col : cols) {
+      auto const c = std::size_t(col);
+      out.cols.push_back(col);
+      out.values.push_back(sums[c]);
+      sums[c] = 0.0;
+      touched[c] = 0;
+    }
+    cols.clear();
+    out.row_offsets.push_back(LO(out.cols.size()));
+  }
+};
+
+HostCsrMatrix multiply(HostCsrMatrix const& a, HostCsrMatrix const& b) {
+  RowBuilder builder(b.ncols);
+  for (LO i = 0; i < a.nrows(); ++i) {
+    for (auto ik = a.row_offsets[std::size_t(i)];
+         ik < a.row_offsets[std::size_t(i) + 1]; ++ik) {
+      auto const k = std::size_t(a.cols[std::size_t(ik)]);
+      auto const a_ik = a.values[std::size_t(ik)];
+      for (auto kj = b.row_offsets[k]; kj < b.row_offsets[k + 1]; ++kj) {
+        builder.add(b.cols[std::size_t(kj)], a_ik * b.values[std::size_t(kj)]);
+      }
+    }
+    builder.end_row();
+  }
+  return builder.out;
+}
+
+HostCsrMatrix transpose(HostCsrMatrix const& a) {
+  HostCsrMatrix out;
+  out.ncols = a.nrows();
+  out.row_offsets.assign(std::size_t(a.ncols) + 1, 0);
+  for (auto col : a.cols) ++out.row_offsets[std::size_t(col) + 1];
+  for (std::size_t i = 0; i < std::size_t(a.ncols); ++i) {
+    out.row_offsets[i + 1] += out.row_offsets[i];
+  }
+  out.cols.resize(a.cols.size());
+  out.values.resize(a.values.size());
+  auto next = out.row_offsets;
+  for (LO i = 0; i < a.nrows(); ++i) {
+    for (auto k = a.row_offsets[std::size_t(i)];
+         k < a.row_offsets[std::size_t(i) + 1]; ++k) {
+      auto const at = std::size_t(next[std::size_t(a.cols[std::size_t(k)])]++);
+      out.cols[at] = i;
+      out.values[at] = a.values[std::size_t(k)];
+    }
+  }
+  return out;
+}
+
+/* greedy aggregation of the graph of a: first whole neighborhoods of
+   rows none of whose neighbors are taken, then each leftover row joins
+   an aggregate of the first pass it neighbors, and the remaining rows
+   form aggregates with their remaining neighbors */
+std::vector<LO> aggregate(HostCsrMatrix const& a, LO* naggregates) {
+  auto const n = std::size_t(a.nrows());
+  auto const& offsets = a.row_offsets;
+  std::vector<LO> aggs(n, -1);
+  LO nagg = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (aggs[i] != -1) continue;
+    bool free = true;
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      if (aggs[std::size_t(a.cols[std::size_t(k)])] != -1) free = false;
+    }
+    if (!free) continue;
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      aggs[std::size_t(a.cols[std::size_t(k)])] = nagg;
+    }
+    ++nagg;
+  }
+  auto const first_aggs = aggs;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (aggs[i] != -1) continue;
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      auto const agg = first_aggs[std::size_t(a.cols[std::size_t(k)])];
+      if (agg != -1) {
+        aggs[i] = agg;
+        break;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    if (aggs[i] != -1) continue;
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      auto const j = std::size_t(a.cols[std::size_t(k)]);
+      if (aggs[j] == -1) aggs[j] = nagg;
+    }
+    ++nagg;
+  }
+  *naggregates = nagg;
+  return aggs;
+}
+
+/* the tentative (piecewise constant) prolongator smoothed by one
+   damped Jacobi step, (I - omega D^{-1} A) P0 */
+HostCsrMatrix get_smoothed_prolongator(HostCsrMatrix const& a,
+    std::vector<LO> const& aggs, LO naggs, Real omega) {
+  RowBuilder builder(naggs);
+  for (LO i = 0; i < a.nrows(); ++i) {
+    auto const begin = a.row_offsets[std::size_t(i)];
+    auto const end = a.row_offsets[std::size_t(i) + 1];
+    auto const weight = omega / a.values[std::size_t(begin)];
+    builder.add(aggs[std::size_t(i)], 1.0);
+    for (auto k = begin; k < end; ++k) {
+      builder.add(aggs[std::size_t(a.cols[std::size_t(k)])],
+          -weight * a.values[std::size_t(k)]);
+    }
+    builder.end_row();
+  }
+  return builder.out;
+}
+
+constexpr LO max_coarse_rows = 128;
+constexpr Int max_levels = 20;
+constexpr Int nsmoothing_sweeps = 2;
+/* per component, far more than a converging solve needs, to stop a
+   stagnating one */
+constexpr Int max_cg_iterations = 1000;
+
+struct Level {
+  CsrMatrix a;
+  Reals smoothing_weights;
+  /* to the next coarser level and back */
+  CsrMatrix restriction;
+  CsrMatrix prolongation;
+};
+
+/* a smoothed aggregation multigrid V-cycle, set up on the host,
+   with a dense Cholesky factorization for the coarsest level
+   when it is small enough and smoothing only otherwise */
+struct Multigrid {
+  std::vector<Level> levels;
+  std::vector<Real> coarse_factor;
+};
+
+Level make_level(HostCsrMatrix const& a, Real radius) {
+  Level level;
+  level.a = to_device(a);
+  level.smoothing_weights = multiply_each_by(
+      invert_each(to_device(get_diagonal(a))), 4.0 / (3.0 * radius));
+  return level;
+}
+
+std::vector<Real> factor_dense(HostCsrMatrix const& a) {
+  auto const n = std::size_t(a.nrows());
+  std::vector<Real> l(n * n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (auto k = a.row_offsets[i]; k < a.row_offsets[i + 1]; ++k) {
+      l[i * n + std::size_t(a.cols[std::size_t(k)])] = a.values[std::size_t(k)];
+    }
+  }
+  for (std::size_t j = 0; j < n; ++j) {
+    auto d = l[j * n + j];
+    for (std::size_t k = 0; k < j; ++k) d -= l[j * n + k] * l[j * n + k];
+    OMEGA_H_CHECK(d > 0.0);
+    l[j * n + j] = std::sqrt(d);
+    for (std::size_t i = j + 1; i < n; ++i) {
+      auto s = l[i * n + j];
+      for (std::size_t k = 0; k < j; ++k) s -= l[i * n + k] * l[j * n + k];
+      l[i * n + j] = s / l[j * n + j];
+    }
+  }
+  return l;
+}
+
+Reals solve_dense(std::vector<Real> const& l, Reals b) {
+  auto x = to_host(b);
+  auto const n = x.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = 0; k < i; ++k) x[i] -= l[i * n + k] * x[k];
+    x[i] /= l[i * n + i];
+  }
+  for (std::size_t i = n; i-- > 0;) {
+    for (std::size_t k = i + 1; k < n; ++k) x[i] -= l[k * n + i] * x[k];
+    x[i] /= l[i * n + i];
+  }
+  return to_device(x);
+}
+
+Multigrid make_multigrid(HostCsrMatrix a) {
+  Multigrid mg;
+  while (true) {
+    auto const radius = get_jacobi_radius(a);
+    mg.levels.push_back(make_level(a, radius));
+    if (a.nrows() <= max_coarse_rows) break;
+    if (Int(mg.levels.size()) == max_levels) break;
+    LO naggs;
+    auto const aggs = aggregate(a, &naggs);
+    if (naggs * 5 > a.nrows() * 4) break;
+    auto const p =
+        get_smoothed_prolongator(a, aggs, naggs, 4.0 / (3.0 * radius));
+    auto const r = transpose(p);
+    auto& level = mg.levels.back();
+    level.prolongation = to_device(p);
+    level.restriction = to_device(r);
+    a = multiply(r, multiply(a, p));
+  }
+  if (a.nrows() <= max_coarse_rows) mg.coarse_factor = factor_dense(a);
+  return mg;
+}
+
+Reals smooth(Level const& level, Reals b, Reals x) {
+  for (Int sweep = 0; sweep < nsmoothing_sweeps; ++sweep) {
+    x = jacobi_sweep(level.a, level.smoothing_weights, b, x);
+  }
+  return x;
+}
+
+Reals apply_vcycle(Multigrid const& mg, std::size_t l, Reals b) {
+  auto const& level = mg.levels[l];
+  if (l + 1 == mg.levels.size()) {
+    if (!mg.coarse_factor.empty()) return solve_dense(mg.coarse_factor, b);
+    return smooth(level, b, Reals(b.size(), 0.0));
+  }
+  auto x = smooth(level, b, Reals(b.size(), 0.0));
+  auto r = subtract_each(b, multiply(level.a, x));
+  auto coarse_x = apply_vcycle(mg, l + 1, multiply(level.restriction, r));
+  x = add_each(x, multiply(level.prolongation, coarse_x));
+  return smooth(level, b, x);
+}
+
+/* the graph Laplacian of the vertex star, with the diagonal first
+   in each row and empty rows for vertices with fixed values */
+CsrMatrix get_laplacian(Graph star, Read<I8> interior) {
+  auto const nverts = star.nnodes();
+  auto const v2vv = star.a2ab;
+  auto const vv2v = star.ab2b;
+  Write<LO> degrees(nverts);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    degrees[v] = interior[v] ? (v2vv[v + 1] - v2vv[v] + 1) : 0;
+  };
+  parallel_for(nverts, f, "laplacian_degrees");
+  auto const row_offsets = offset_scan(LOs(degrees));
+  Write<LO> cols(row_offsets.last());
+  Write<Real> values(row_offsets.last());
+  auto g = OMEGA_H_LAMBDA(LO v) {
+    if (!interior[v]) return;
+    auto k = row_offsets[v];
+    cols[k] = v;
+    values[k] = Real(v2vv[v + 1] - v2vv[v]);
+    for (auto vv = v2vv[v]; vv < v2vv[v + 1]; ++vv) {
+      ++k;
+      cols[k] = vv2v[vv];
+      values[k] = -1.0;
+    }
+  };
+  parallel_for(nverts, g, "laplacian_entries");
+  return {row_offsets, LOs(cols), Reals(values)};
+}
+
+/* the rows and columns of the laplacian for unknowns only,
+   which is the operator the local multigrid preconditions */
+HostCsrMatrix get_unknown_block(CsrMatrix const& laplacian,
+    LOs unknowns2verts, LO nverts) {
+  auto const a = to_host(laplacian, nverts);
+  auto const u2v = to_host(unknowns2verts);
+  std::vector<LO> v2u(std::size_t(nverts), -1);
+  for (std::size_t u = 0; u < u2v.size(); ++u) v2u[std::size_t(u2v[u])] = LO(u);
+  HostCsrMatrix out;
+  out.ncols = LO(u2v.size());
+  out.row_offsets.push_back(0);
+  for (auto v : u2v) {
+    for (auto k = a.row_offsets[std::size_t(v)];
+         k < a.row_offsets[std::size_t(v) + 1]; ++k) {
+      auto const u = v2u[std::size_t(a.cols[std::size_t(k)])];
+      if (u == -1) continue;
+      out.cols.push_back(u);
+      out.values.push_back(a.values[std::size_t(k)]);
+    }
+    out.row_offsets.push_back(LO(out.cols.size()));
+  }
+  return out;
+}
+
+/* the owned parts of r.u, w.u and r.r summed over all ranks
+   in a single reduction */
+Few<Real, 3> get_dots(CommPtr comm, Read<I8> owned, Reals r, Reals u, Reals w) {
+  auto const n = r.size();
+  Write<Real> products(n * 3);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto const o = Real(owned[i]);
+    products[i * 3 + 0] = o * r[i] * u[i];
+    products[i * 3 + 1] = o * w[i] * u[i];
+    products[i * 3 + 2] = o * r[i] * r[i];
+  };
+  parallel_for(n, f, "cg_dot_products");
+  HostWrite<Real> local(3);
+  for (Int c = 0; c < 3; ++c) {
+    local[c] = get_sum(get_component(Reals(products), 3, c));
+  }
+  HostRead<Real> global(comm->allreduce(Reals(local.write()), OMEGA_H_SUM));
+  return {global[0], global[1], global[2]};
+}
+
+}  // end anonymous namespace
+
+Reals solve_laplacian(Mesh* mesh, Reals initial, Int width, Real reduction,
+    Real floor, bool use_multigrid) {
   OMEGA_H_CHECK(mesh->owners_have_all_upward(VERT));
   OMEGA_H_CHECK(initial.size() == mesh->nverts() * width);
   auto comm = mesh->comm();
-  auto state = initial;
+  auto nverts = mesh->nverts();
   auto star = mesh->ask_star(VERT);
   auto interior = mark_by_class_dim(mesh, VERT, mesh->dim());
-  auto boundary = invert_marks(interior);
-  auto b2v = collect_marked(boundary);
-  auto weights = Reals(star.ab2b.size(), 1.0);
-  auto bc_data = read(unmap(b2v, initial, width));
-  bool done = false;
+  auto owned = mesh->owned(VERT);
+  auto unknowns2verts = collect_marked(land_each(interior, owned));
+  auto laplacian = get_laplacian(star, interior);
+  auto block = get_unknown_block(laplacian, unknowns2verts, nverts);
+  Multigrid mg;
+  Reals jacobi_weights;
+  if (use_multigrid) {
+    mg = make_multigrid(block);
+  } else {
+    jacobi_weights = invert_each(to_device(get_diagonal(block)));
+  }
+  /* the preconditioner acts on owned unknowns only (block Jacobi
+     across ranks), so its result is synchronized to the ghosts */
+  auto precondition = [&](Reals r) {
+    auto r_unknowns = Reals(unmap(unknowns2verts, r, 1));
+    auto z_unknowns = use_multigrid ? apply_vcycle(mg, 0, r_unknowns)
+                                    : multiply_each(r_unknowns, jacobi_weights);
+    auto z = Write<Real>(nverts, 0.0);
+    map_into(Reals(z_unknowns), unknowns2verts, z, 1);
+    return mesh->sync_array(VERT, Reals(z), 1);
+  };
+  auto out = Write<Real>(nverts * width);
   Int niters = 0;
-  do {
-    auto new_state_nobc = graph_weighted_average(star, weights, state, width);
-    auto new_state_w = deep_copy(new_state_nobc);
-    map_into(bc_data, b2v, new_state_w, width);
-    auto new_state = Reals(new_state_w);
-    new_state = mesh->sync_array(VERT, new_state, width);
-    auto local_done = are_close(state, new_state, tol, floor);
-    done = comm->reduce_and(local_done);
-    state = new_state;
-    ++niters;
-  } while (!done);
+  for (Int comp = 0; comp < width; ++comp) {
+    /* conjugate gradients in the single-reduction form of
+       Chronopoulos and Gear, on the correction to the initial state,
+       which is zero at the vertices with fixed values */
+    auto x = get_component(initial, width, comp);
+    auto r = multiply_each_by(multiply(laplacian, x), -1.0);
+    auto u = precondition(r);
+    auto w = multiply(laplacian, u);
+    auto dots = get_dots(comm, owned, r, u, w);
+    auto const stop = std::max(reduction * std::sqrt(dots[2]), floor);
+    if (!std::isfinite(dots[2])) {
+      Omega_h_fail("solve_laplacian: the initial residual is not finite\n");
+    }
+    auto gamma = dots[0];
+    auto pap = dots[1];
+    auto alpha = 0.0;
+    auto beta = 0.0;
+    auto p = Reals(nverts, 0.0);
+    auto s = Reals(nverts, 0.0);
+    Int comp_niters = 0;
+    while (std::sqrt(dots[2]) > stop) {
+      if (comp_niters == max_cg_iterations) {
+        if (comm->rank() == 0) {
+          std::cout << "WARNING: solve_laplacian stopped after "
+                    << max_cg_iterations << " iterations at residual "
+                    << std::sqrt(dots[2]) << " (wanted " << stop << ")\n";
+        }
+        break;
+      }
+      /* p.Ap of the new search direction, which an SPD operator and
+         preconditioner keep positive and finite */
+      if (!(pap > 0.0) || !std::isfinite(pap)) {
+        Omega_h_fail("solve_laplacian: conjugate gradients broke down "
+                     "(p.Ap = %g)\n", pap);
+      }
+      alpha = gamma / pap;
+      p = add_each(u, multiply_each_by(p, beta));
+      s = add_each(w, multiply_each_by(s, beta));
+      x = add_each(x, multiply_each_by(p, alpha));
+      r = subtract_each(r, multiply_each_by(s, alpha));
+      u = precondition(r);
+      w = multiply(laplacian, u);
+      dots = get_dots(comm, owned, r, u, w);
+      if (!std::isfinite(dots[2])) {
+        Omega_h_fail("solve_laplacian: the residual is not finite\n");
+      }
+      beta = dots[0] / gamma;
+      pap = dots[1] - beta * dots[0] / alpha;
+      gamma = dots[0];
+      ++comp_niters;
+    }
+    niters += comp_niters;
+    set_component(out, x, width, comp);
+  }
   if (comm->rank() == 0) {
     std::cout << "laplacian solve took " << niters << " iterations\n";
   }
-  return state;
+  return out;
 }
 
 }  // end namespace Omega_h
@@ -7,8 +7,16 @@ namespace Omega_h {
 
 class Mesh;
 
-Reals solve_laplacian(
-    Mesh* mesh, Reals initial, Int width, Real tol, Real floor = EPSILON);
+/* solves for values at the vertices classified on the interior of
+   the domain which are the averages of their neighbors' values,
+   keeping the initial values at the other vertices. each of the width
+   components is solved by conjugate gradients until the residual norm
+   drops by a factor of reduction or below floor, warning after 1000
+   iterations and failing on breakdown. the preconditioner is a
+   smoothed aggregation multigrid V-cycle, or the operator's diagonal
+   if use_multigrid is false, set up on every call */
+Reals solve_laplacian(Mesh* mesh, Reals initial, Int width, Real reduction,
+    Real floor = EPSILON, bool use_multigrid = true);
 
 }  // end namespace Omega_h
 
@@ -1,8 +1,11 @@
 #include <Omega_h_config.h>
+#include <Omega_h_adj.hpp>
 #include <Omega_h_cmdline.hpp>
 #include <Omega_h_library.hpp>
 #include <Omega_h_malloc.hpp>
+#include <Omega_h_pool.hpp>
 #include <Omega_h_profile.hpp>
+#include <Omega_h_shared_alloc.hpp>
 #include <Omega_h_dbg.hpp>
 
 #include <csignal>
@@ -104,11 +107,28 @@ void Library::initialize(char const* head_desc, int* argc, char*** argv
       "--osh-time-chop", "only print functions whose percent time is greater than given value (e.g. --osh-time[-percent] --osh-time-chop 2)");
   osh_time_chop_flag.add_arg<double>("0.0");
   cmdline.add_flag("--osh-time-with-filename", "add file name to function name in profile output");
+  auto& trace_flag = cmdline.add_flag("--osh-trace",
+      "record a timeline of timed functions and write it as a Chrome trace");
+  trace_flag.add_arg<std::string>("path");
+  auto& trace_capacity_flag = cmdline.add_flag("--osh-trace-capacity",
+      "number of latest events --osh-trace keeps per rank");
+  trace_capacity_flag.add_arg<int>("events");
+  cmdline.add_flag("--osh-kernel-counters",
+      "count items, allocated bytes and (with perf_event) cycles, "
+      "instructions and cache misses per parallel_for kernel; implies "
+      "--osh-time");
 
   cmdline.add_flag("--osh-signal", "catch signals and print a stacktrace");
   cmdline.add_flag("--osh-fpe", "enable floating-point exceptions");
   cmdline.add_flag("--osh-silent", "suppress all output");
   cmdline.add_flag("--osh-pool", "use memory pooling");
+  cmdline.add_flag("--osh-no-pool",
+      "disable memory pooling (enabled by default without Kokkos)");
+  auto& pool_cap_flag = cmdline.add_flag(
+      "--osh-pool-cap", "maximum megabytes the memory pool keeps cached");
+  pool_cap_flag.add_arg<int>("megabytes");
+  cmdline.add_flag("--osh-hash-unique",
+      "use a hash table instead of sorting to derive edges and faces");
   auto& self_send_flag =
       cmdline.add_flag("--osh-self-send", "control self send threshold");
   self_send_flag.add_arg<int>("value");
@@ -131,6 +151,22 @@ void Library::initialize(char const* head_desc, int* argc, char*** argv
     Omega_h::profile::global_singleton_history =
       new Omega_h::profile::History(world_, true, chop, add_filename);
   }
+  if (cmdline.parsed("--osh-kernel-counters")) {
+    if (!Omega_h::profile::global_singleton_history) {
+      Omega_h::profile::global_singleton_history =
+          new Omega_h::profile::History(world_, false, chop, add_filename);
+    }
+    profile::global_kernel_counters = new profile::KernelCounters();
+  }
+  if (cmdline.parsed("--osh-trace")) {
+    auto capacity = profile::trace_default_capacity;
+    if (cmdline.parsed("--osh-trace-capacity")) {
+      capacity =
+          std::size_t(cmdline.get<int>("--osh-trace-capacity", "events"));
+    }
+    profile::global_singleton_trace = new profile::Trace(
+        world_, cmdline.get<std::string>("--osh-trace", "path"), capacity);
+  }
   if (cmdline.parsed("--osh-fpe")) {
     enable_floating_point_exceptions();
   }
@@ -174,7 +210,26 @@ void Library::initialize(char const* head_desc, int* argc, char*** argv
   // and prevent it from polluting later timings
   cudaFree(nullptr);
 #endif
-  if (cmdline.parsed("--osh-pool")) enable_pooling();
+#ifdef OMEGA_H_USE_KOKKOS
+  bool const pool_by_default = false;
+#else
+  bool const pool_by_default = true;
+#endif
+  if (cmdline.parsed("--osh-pool") ||
+      (pool_by_default && !cmdline.parsed("--osh-no-pool"))) {
+    auto max_cached_bytes = pool_default_max_cached_bytes;
+    if (cmdline.parsed("--osh-pool-cap")) {
+      auto const megabytes = cmdline.get<int>("--osh-pool-cap", "megabytes");
+      if (megabytes < 0) {
+        Omega_h_fail("--osh-pool-cap needs a nonnegative number of megabytes,"
+                     " got %d\n", megabytes);
+      }
+      max_cached_bytes = std::size_t(megabytes) << 20;
+    }
+    enable_pooling(max_cached_bytes);
+  }
+  if (cmdline.parsed("--osh-memory")) start_tracking_allocations();
+  if (cmdline.parsed("--osh-hash-unique")) enable_hashed_find_unique();
 }
 
 Library::Library(Library const& other)
@@ -198,12 +253,25 @@ Library::~Library() {
       // FIXME - parallelize?
       Omega_h::profile::print_top_down_and_bottom_up(
           *Omega_h::profile::global_singleton_history, total_runtime);
+      if (profile::global_kernel_counters) {
+        profile::print_kernel_counts(
+            *Omega_h::profile::global_singleton_history);
+      }
     }
     Omega_h::profile::print_top_sorted(
           *Omega_h::profile::global_singleton_history, total_runtime);
     delete Omega_h::profile::global_singleton_history;
     Omega_h::profile::global_singleton_history = nullptr;
   }
+  delete profile::global_kernel_counters;
+  profile::global_kernel_counters = nullptr;
+  if (profile::global_singleton_trace) {
+    profile::write_chrome_trace(*profile::global_singleton_trace,
+        profile::global_singleton_trace->path);
+    delete profile::global_singleton_trace;
+    profile::global_singleton_trace = nullptr;
+  }
+  if (global_allocs) stop_tracking_allocations(this);
   // need to destroy all Comm objects prior to MPI_Finalize()
   world_ = CommPtr();
   self_ = CommPtr();
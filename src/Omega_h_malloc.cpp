@@ -3,6 +3,7 @@
 #include <Omega_h_pool.hpp>
 #include <Omega_h_profile.hpp>
 #include <cstdlib>
+#include <ostream>
 
 namespace Omega_h {
 
@@ -61,9 +62,23 @@ static Pool* host_pool = nullptr;
 
 static bool pooling_enabled = false;
 
-void enable_pooling() {
-  device_pool = new Pool(device_malloc, device_free);
-  host_pool = new Pool(host_malloc, host_free);
+void enable_pooling() { enable_pooling(pool_default_max_cached_bytes); }
+
+static Pool* replace_pool(Pool* old, MallocFunc malloc_in, FreeFunc free_in,
+    std::size_t max_cached_bytes) {
+  auto pool = new Pool(malloc_in, free_in, max_cached_bytes);
+  if (old) adopt_used_blocks(*pool, *old);
+  delete old;
+  return pool;
+}
+
+/* arrays allocated by a previous pool stay freeable through the new
+   one. arrays allocated while pooling was disabled must be gone
+   before it is enabled again */
+void enable_pooling(std::size_t max_cached_bytes) {
+  device_pool =
+      replace_pool(device_pool, device_malloc, device_free, max_cached_bytes);
+  host_pool = replace_pool(host_pool, host_malloc, host_free, max_cached_bytes);
   pooling_enabled = true;
 }
 
@@ -77,6 +92,34 @@ void disable_pooling() {
 
 bool is_pooling_enabled() { return pooling_enabled; }
 
+void trim_pools() {
+  if (device_pool) trim(*device_pool);
+  if (host_pool) trim(*host_pool);
+}
+
+static void print_pool_stats(
+    std::ostream& stream, char const* name, Pool* pool) {
+  if (!pool) return;
+  auto const stats = get_stats(*pool);
+  auto const requests = stats.hits + stats.misses;
+  stream << name << " pool: " << requests << " allocations, " << stats.hits
+         << " hits, " << stats.misses << " misses";
+  if (requests) {
+    stream << " (" << (100.0 * double(stats.hits) / double(requests))
+           << "% hit rate)";
+  }
+  stream << ", " << stats.trimmed_blocks << " blocks trimmed\n";
+  stream << name << " pool: " << stats.used_bytes << " bytes in use ("
+         << stats.waste_bytes() << " wasted by rounding), "
+         << stats.cached_bytes << " bytes cached, high water "
+         << stats.high_water_bytes << " bytes\n";
+}
+
+void print_pooling_stats(std::ostream& stream) {
+  print_pool_stats(stream, "device", device_pool);
+  print_pool_stats(stream, "host", host_pool);
+}
+
 void* maybe_pooled_device_malloc(std::size_t size) {
   if (device_pool) return allocate(*device_pool, size);
   return device_malloc(size);
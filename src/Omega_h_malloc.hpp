@@ -2,6 +2,7 @@
 #define OMEGA_H_MALLOC_HPP
 
 #include <cstddef>
+#include <iosfwd>
 
 namespace Omega_h {
 
@@ -10,11 +11,20 @@ void device_free(void* ptr, std::size_t size);
 void* host_malloc(std::size_t size);
 void host_free(void* ptr, std::size_t size);
 
+/* pooling caches freed blocks by size class for reuse,
+   see Omega_h_pool.hpp. it is enabled by default in builds
+   without Kokkos, which has its own pool */
 void enable_pooling();
+void enable_pooling(std::size_t max_cached_bytes);
 void disable_pooling();
 
 bool is_pooling_enabled();
 
+/* return all cached blocks to the system */
+void trim_pools();
+/* prints hit/miss/waste/high water counters of the pools */
+void print_pooling_stats(std::ostream& stream);
+
 void* maybe_pooled_device_malloc(std::size_t size);
 void maybe_pooled_device_free(void* ptr, std::size_t size);
 void* maybe_pooled_host_malloc(std::size_t size);
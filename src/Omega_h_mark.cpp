@@ -187,8 +187,21 @@ Read<I8> mark_class_closures(Mesh* mesh,
   return marks;
 }
 
+/* in element-based parting, an entity with only one copy
+   has all of its upward adjacent entities on this rank */
+Read<I8> mark_unshared(Mesh* mesh, Int ent_dim) {
+  auto nents = mesh->nents(ent_dim);
+  if (!mesh->could_be_shared(ent_dim)) return Read<I8>(nents, I8(1));
+  OMEGA_H_CHECK(mesh->parting() == OMEGA_H_ELEM_BASED);
+  auto ncopies =
+      mesh->reduce_array(ent_dim, Read<I32>(nents, 1), 1, OMEGA_H_SUM);
+  ncopies = mesh->sync_array(ent_dim, ncopies, 1);
+  return each_eq_to(ncopies, I32(1));
+}
+
+/* without ghosts the layers stop at part boundaries */
 Read<I8> mark_dual_layers(Mesh* mesh, Read<I8> marks, Int nlayers) {
-  OMEGA_H_CHECK(mesh->parting() == OMEGA_H_GHOSTED);
+  OMEGA_H_CHECK(mesh->parting() != OMEGA_H_VERT_BASED);
   auto dual = mesh->ask_dual();
   for (Int i = 0; i < nlayers; ++i) {
     marks = graph_reduce(dual, marks, 1, OMEGA_H_MAX);
@@ -205,7 +218,7 @@ GO count_owned_marks(Mesh* mesh, Int ent_dim, Read<I8> marks) {
 }
 
 Read<I8> mark_sliver_layers(Mesh* mesh, Real qual_ceil, Int nlayers) {
-  OMEGA_H_CHECK(mesh->parting() == OMEGA_H_GHOSTED);
+  OMEGA_H_CHECK(mesh->parting() != OMEGA_H_VERT_BASED);
   auto quals = mesh->ask_qualities();
   auto elems_are_slivers = each_lt(quals, qual_ceil);
   return mark_dual_layers(mesh, elems_are_slivers, nlayers);
@@ -14,6 +14,7 @@
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
 #include "Omega_h_migrate.hpp"
+#include "Omega_h_multisect.hpp"
 #include "Omega_h_quality.hpp"
 #include "Omega_h_shape.hpp"
 #include "Omega_h_timer.hpp"
@@ -28,7 +29,9 @@ Mesh::Mesh() {
   dim_ = -1;
   for (Int i = 0; i <= 3; ++i) nents_[i] = -1;
   parting_ = -1;
+  partitioner_ = OMEGA_H_RIB;
   nghost_layers_ = -1;
+  caches_elem_verts_ = false;
   library_ = nullptr;
   matched_ = -1;
 }
@@ -97,6 +100,12 @@ void Mesh::set_ents(Int ent_dim, Adj down) {
   add_adj(ent_dim, ent_dim - 1, down);
 }
 
+void Mesh::set_up(Int from, Int to, Adj up) {
+  OMEGA_H_CHECK(from < to);
+  check_dim2(to);
+  add_adj(from, to, up);
+}
+
 void Mesh::set_model_ents(Int ent_dim, LOs Ids) {
   OMEGA_H_TIME_FUNCTION;
   check_dim(ent_dim);
@@ -178,6 +187,7 @@ void Mesh::add_tag(Int ent_dim, std::string const& name, Int ncomps,
   } else {
     tags_[ent_dim].push_back(std::move(ptr));
   }
+  forget_elem_verts(ent_dim, name);
   /* internal typically indicates migration/adaptation/file reading,
      when we do not want any invalidation to take place.
      the invalidation is there to prevent users changing coordinates
@@ -207,6 +217,13 @@ void Mesh::react_to_set_tag(Int ent_dim, std::string const& name) {
   }
 }
 
+void Mesh::forget_elem_verts(Int ent_dim, std::string const& name) {
+  /* unlike the tags above, these are forgotten for internal changes too */
+  if (ent_dim != VERT) return;
+  if (name == "coordinates") elem_coords_ = Reals();
+  if (name == "metric") elem_metrics_ = Reals();
+}
+
 TagBase const* Mesh::get_tagbase(Int ent_dim, std::string const& name) const {
   check_dim2(ent_dim);
   auto it = tag_iter(ent_dim, name);
@@ -231,6 +248,7 @@ void Mesh::remove_tag(Int ent_dim, std::string const& name) {
   if (!has_tag(ent_dim, name)) return;
   check_dim2(ent_dim);
   tags_[ent_dim].erase(tag_iter(ent_dim, name));
+  forget_elem_verts(ent_dim, name);
 }
 
 bool Mesh::has_tag(Int ent_dim, std::string const& name) const {
@@ -436,6 +454,34 @@ Reals Mesh::ask_qualities() {
   return get_array<Real>(dim(), "quality");
 }
 
+void Mesh::set_elem_vert_caching(bool on) {
+  caches_elem_verts_ = on;
+  if (!on) {
+    elem_coords_ = Reals();
+    elem_metrics_ = Reals();
+  }
+}
+
+bool Mesh::caches_elem_verts() const { return caches_elem_verts_; }
+
+Reals Mesh::ask_elem_coords() {
+  if (!caches_elem_verts_) return unmap(ask_elem_verts(), coords(), dim());
+  if (!elem_coords_.exists()) {
+    elem_coords_ = unmap(ask_elem_verts(), coords(), dim());
+  }
+  return elem_coords_;
+}
+
+Reals Mesh::ask_elem_metrics() {
+  auto metrics = get_array<Real>(VERT, "metric");
+  auto ncomps = divide_no_remainder(metrics.size(), nverts());
+  if (!caches_elem_verts_) return unmap(ask_elem_verts(), metrics, ncomps);
+  if (!elem_metrics_.exists()) {
+    elem_metrics_ = unmap(ask_elem_verts(), metrics, ncomps);
+  }
+  return elem_metrics_;
+}
+
 Reals Mesh::ask_sizes() {
   if (!has_tag(dim(), "size")) {
     auto sizes = measure_elements_real(this);
@@ -613,34 +659,20 @@ void Mesh::balance(bool predictive) {
   OMEGA_H_TIME_FUNCTION;
   if (comm_->size() == 1) return;
   set_parting(OMEGA_H_ELEM_BASED);
-  inertia::Rib hints;
-  if (rib_hints_) hints = *rib_hints_;
-  auto ecoords =
-      average_field(this, dim(), LOs(nelems(), 0, 1), dim(), coords());
-  if (dim() < 3) ecoords = resize_vectors(ecoords, dim(), 3);
-  Reals masses;
-  Real abs_tol;
-  if (predictive) {
-    masses = get_complexity_per_elem(this, get_array<Real>(VERT, "metric"));
-    /* average between input mesh weight (1.0)
-       and predicted output mesh weight */
-    masses = add_to_each(masses, 1.);
-    masses = multiply_each_by(masses, 1. / 2.);
-    abs_tol = max2(0.0, get_max(comm_, masses));
-  } else {
-    masses = Reals(nelems(), 1);
-    abs_tol = 1.0;
+  if (!predictive) {
+    balance(Reals(nelems(), 1));
+    return;
   }
-  abs_tol *= 2.0;  // fudge factor ?
-  auto owners = ask_owners(dim());
-  recursively_bisect(comm(), abs_tol, &ecoords, &masses, &owners, &hints);
-  rib_hints_ = std::make_shared<inertia::Rib>(hints);
-  auto unsorted_new2owners = Dist(comm_, owners, nelems());
-  auto owners2new = unsorted_new2owners.invert();
-  auto owner_globals = this->globals(dim());
-  owners2new.set_dest_globals(owner_globals);
-  auto sorted_new2owners = owners2new.invert();
-  migrate_mesh(this, sorted_new2owners, OMEGA_H_ELEM_BASED, false);
+  balance(predictive_weights());
+}
+
+Reals Mesh::predictive_weights() {
+  auto masses =
+      get_complexity_per_elem(this, get_array<Real>(VERT, "metric"));
+  /* average between input mesh weight (1.0)
+     and predicted output mesh weight */
+  masses = add_to_each(masses, 1.);
+  return multiply_each_by(masses, 1. / 2.);
 }
 
 void Mesh::migrate(Remotes& owners) {
@@ -691,8 +723,6 @@ void Mesh::balance(Reals weights) {
   OMEGA_H_TIME_FUNCTION;
   if (comm_->size() == 1) return;
   set_parting(OMEGA_H_ELEM_BASED);
-  inertia::Rib hints;
-  if (rib_hints_) hints = *rib_hints_;
   auto ecoords =
       average_field(this, dim(), LOs(nelems(), 0, 1), dim(), coords());
   if (dim() < 3) ecoords = resize_vectors(ecoords, dim(), 3);
@@ -700,8 +730,15 @@ void Mesh::balance(Reals weights) {
   abs_tol = max2(0.0, get_max(comm_, weights));
   abs_tol *= 2.0;
   auto owners = ask_owners(dim());
-  recursively_bisect(comm(), abs_tol, &ecoords, &weights, &owners, &hints);
-  rib_hints_ = std::make_shared<inertia::Rib>(hints);
+  if (partitioner_ == OMEGA_H_MULTISECTION) {
+    multisect::recursively_multisect(
+        comm(), abs_tol, &ecoords, &weights, &owners);
+  } else {
+    inertia::Rib hints;
+    if (rib_hints_) hints = *rib_hints_;
+    recursively_bisect(comm(), abs_tol, &ecoords, &weights, &owners, &hints);
+    rib_hints_ = std::make_shared<inertia::Rib>(hints);
+  }
   auto unsorted_new2owners = Dist(comm_, owners, nelems());
   auto owners2new = unsorted_new2owners.invert();
   auto owner_globals = this->globals(dim());
@@ -711,6 +748,12 @@ void Mesh::balance(Reals weights) {
   return;
 }
 
+void Mesh::set_partitioner(Omega_h_Partitioner partitioner_in) {
+  partitioner_ = partitioner_in;
+}
+
+Omega_h_Partitioner Mesh::partitioner() const { return partitioner_; }
+
 Graph Mesh::ask_graph(Int from, Int to) {
   if (to > from) {
     return ask_up(from, to);
@@ -748,6 +791,13 @@ Future<T> Mesh::isync_array(Int ent_dim, Read<T> a, Int width) {
   return ask_dist(ent_dim).invert().iexch(a, width);
 }
 
+template <typename T>
+DistPlan<T> Mesh::sync_plan(Int ent_dim, Int width) {
+  OMEGA_H_CHECK(ent_dim >= 0 && ent_dim <= dim_);
+  if (!could_be_shared(ent_dim)) return DistPlan<T>();
+  return DistPlan<T>(ask_dist(ent_dim).invert(), width);
+}
+
 template <typename T>
 Read<T> Mesh::sync_subset_array(
     Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width) {
@@ -813,6 +863,115 @@ void Mesh::sync_tag(Int ent_dim, std::string const& name) {
     }
   }
 }
+/* arrays exchanged together are packed as bytes, one row of
+   packed_width bytes per entity, each array at its own offset */
+
+template <typename T>
+static void pack_bytes(
+    Read<T> a, Int width, Write<I8> packed, Int packed_width, Int offset) {
+  OMEGA_H_CHECK(offset + width * Int(sizeof(T)) <= packed_width);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    for (Int j = 0; j < width; ++j) {
+      T const value = a[i * width + j];
+      auto const bytes = reinterpret_cast<I8 const*>(&value);
+      for (Int b = 0; b < Int(sizeof(T)); ++b) {
+        packed[i * packed_width + offset + j * Int(sizeof(T)) + b] = bytes[b];
+      }
+    }
+  };
+  parallel_for(packed.size() / packed_width, f, "pack_bytes");
+}
+
+template <typename T>
+static Read<T> unpack_bytes(
+    Read<I8> packed, Int packed_width, Int offset, Int width) {
+  auto const n = packed.size() / packed_width;
+  Write<T> out(n * width);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    for (Int j = 0; j < width; ++j) {
+      T value;
+      auto const bytes = reinterpret_cast<I8*>(&value);
+      for (Int b = 0; b < Int(sizeof(T)); ++b) {
+        bytes[b] = packed[i * packed_width + offset + j * Int(sizeof(T)) + b];
+      }
+      out[i * width + j] = value;
+    }
+  };
+  parallel_for(n, f, "unpack_bytes");
+  return out;
+}
+
+static Int type_size(Omega_h_Type type) {
+  switch (type) {
+    case OMEGA_H_I8:
+      return Int(sizeof(I8));
+    case OMEGA_H_I32:
+      return Int(sizeof(I32));
+    case OMEGA_H_I64:
+      return Int(sizeof(I64));
+    case OMEGA_H_F64:
+      return Int(sizeof(Real));
+  }
+  OMEGA_H_NORETURN(0);
+}
+
+std::vector<Mesh::TagPtr> Mesh::sync_arrays(
+    Int ent_dim, std::vector<TagPtr> const& arrays) {
+  OMEGA_H_TIME_FUNCTION;
+  check_dim2(ent_dim);
+  if (!could_be_shared(ent_dim)) return arrays;
+  Int packed_width = 0;
+  for (auto& tag : arrays) {
+    OMEGA_H_CHECK(tag->ncomps() >= 0);
+    packed_width += tag->ncomps() * type_size(tag->type());
+  }
+  if (packed_width == 0) return arrays;
+  Write<I8> packed(nents(ent_dim) * packed_width);
+  Int offset = 0;
+  for (auto& tag : arrays) {
+    apply_to_omega_h_types(tag->type(), [&](auto t) {
+      using T = decltype(t);
+      auto const array = as<T>(tag.get())->array();
+      OMEGA_H_CHECK(array.size() == nents(ent_dim) * tag->ncomps());
+      pack_bytes(array, tag->ncomps(), packed, packed_width, offset);
+    });
+    offset += tag->ncomps() * type_size(tag->type());
+  }
+  auto const synced = sync_array(ent_dim, Read<I8>(packed), packed_width);
+  std::vector<TagPtr> out;
+  offset = 0;
+  for (auto& tag : arrays) {
+    apply_to_omega_h_types(tag->type(), [&](auto t) {
+      using T = decltype(t);
+      auto synced_tag = std::make_shared<Tag<T>>(tag->name(), tag->ncomps());
+      synced_tag->set_array(
+          unpack_bytes<T>(synced, packed_width, offset, tag->ncomps()));
+      out.push_back(synced_tag);
+    });
+    offset += tag->ncomps() * type_size(tag->type());
+  }
+  return out;
+}
+
+void Mesh::sync_tags(Int ent_dim, std::vector<std::string> const& names) {
+  if (names.size() == 1) {
+    sync_tag(ent_dim, names.front());
+    return;
+  }
+  std::vector<TagPtr> arrays;
+  for (auto& name : names) {
+    get_tagbase(ent_dim, name);
+    arrays.push_back(*tag_iter(ent_dim, name));
+  }
+  auto const synced = sync_arrays(ent_dim, arrays);
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    apply_to_omega_h_types(synced[i]->type(), [&](auto t) {
+      using T = decltype(t);
+      set_tag(ent_dim, names[i], as<T>(synced[i].get())->array());
+    });
+  }
+}
+
 void Mesh::sync_tag_matched(Int ent_dim, std::string const& name) {
   auto tagbase = get_tagbase(ent_dim, name);
   switch (tagbase->type()) {
@@ -914,6 +1073,8 @@ Mesh Mesh::copy_meta() const {
   m.parting_ = this->parting_;
   m.nghost_layers_ = this->nghost_layers_;
   m.rib_hints_ = this->rib_hints_;
+  m.caches_elem_verts_ = this->caches_elem_verts_;
+  m.partitioner_ = this->partitioner_;
   m.class_sets = this->class_sets;
   if (this->matched_ > 0) {
     m.matched_ = this->matched_;
@@ -1119,6 +1280,7 @@ __host__
       Int dim, std::string const& name, Read<T> array, bool internal);         \
   template Read<T> Mesh::sync_array(Int ent_dim, Read<T> a, Int width);        \
   template Future<T> Mesh::isync_array(Int ent_dim, Read<T> a, Int width);     \
+  template DistPlan<T> Mesh::sync_plan(Int ent_dim, Int width);                \
   template Read<T> Mesh::owned_array(Int ent_dim, Read<T> a, Int width);       \
   template Read<T> Mesh::sync_subset_array(                                    \
       Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width);         \
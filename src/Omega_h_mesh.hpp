@@ -43,6 +43,8 @@ class Mesh {
   virtual void set_dim(Int dim_in);
   void set_verts(LO nverts_in);
   void set_ents(Int ent_dim, Adj down);
+  /* provide an upward adjacency instead of deriving it on request */
+  void set_up(Int from, Int to, Adj up);
   void set_parents(Int ent_dim, Parents parents);
   Library* library() const;
   CommPtr comm() const;
@@ -244,10 +246,12 @@ class Mesh {
   Adj derive_adj(Int from, Int to);
   Adj ask_adj(Int from, Int to);
   void react_to_set_tag(Int dim, std::string const& name);
+  void forget_elem_verts(Int ent_dim, std::string const& name);
   Omega_h_Family family_;
   I8 matched_ = -1;
   CommPtr comm_;
   Int parting_;
+  Omega_h_Partitioner partitioner_;
   Int nghost_layers_;
   LO nents_[DIMS];
   TagVector tags_[DIMS];
@@ -257,6 +261,9 @@ class Mesh {
   Remotes owners_[DIMS];
   DistPtr dists_[DIMS];
   RibPtr rib_hints_;
+  bool caches_elem_verts_;
+  Reals elem_coords_;
+  Reals elem_metrics_;
   ParentPtr parents_[DIMS];
   ChildrenPtr children_[DIMS][DIMS];
   Library* library_;
@@ -279,6 +286,20 @@ protected:
   Reals ask_lengths();
   Reals ask_qualities();
   Reals ask_sizes();
+  /* copies of the vertex coordinates and metrics of each element,
+     (dim + 1) consecutive vectors or symmetric tensors per element,
+     which element loops can read without going through the
+     element-to-vertex map. since they repeat each vertex's data
+     once per adjacent element, they are only kept while caching is
+     turned on (and are built anew on every request otherwise).
+     they are built on first request and forgotten when
+     the coordinates or the metric change; meshes produced by
+     adaptation inherit the setting but not the copies,
+     so adapt builds them at most once per pass */
+  void set_elem_vert_caching(bool on);
+  bool caches_elem_verts() const;
+  Reals ask_elem_coords();
+  Reals ask_elem_metrics();
   Bytes ask_levels(Int dim);
   Bytes ask_leaves(Int dim);
   Parents ask_parents(Int child_dim);
@@ -291,8 +312,16 @@ protected:
   Int nghost_layers() const;
   void set_parting(Omega_h_Parting parting_in, Int nlayers, bool verbose);
   void set_parting(Omega_h_Parting parting_in, bool verbose = false);
+  /* repartitions the elements by weight with partitioner(),
+     which is either unit weights or, if predictive, the average of
+     those with the element counts the "metric" tag implies */
   void balance(bool predictive = false);
   void balance(Reals weights);
+  /* the element weights of balance(true): the average of the current
+     count (one) and the count implied by the "metric" tag */
+  Reals predictive_weights();
+  void set_partitioner(Omega_h_Partitioner partitioner_in);
+  Omega_h_Partitioner partitioner() const;
   /**
    * migrate mesh elements by constructing a distributed graph
    * where each rank defines which elements it will own via
@@ -307,6 +336,10 @@ protected:
   Read<T> sync_array(Int ent_dim, Read<T> a, Int width);
   template <typename T>
   Future<T> isync_array(Int ent_dim, Read<T> a, Int width);
+  /* a plan repeating sync_array(ent_dim, a, width) for new arrays,
+     which stays valid until the mesh is migrated or its owners change */
+  template <typename T>
+  DistPlan<T> sync_plan(Int ent_dim, Int width);
   template <typename T>
   Read<T> sync_subset_array(
       Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width);
@@ -318,6 +351,13 @@ protected:
   Read<T> owned_subset_array(
       Int ent_dim, Read<T> a_data, LOs a2e, T default_val, Int width);
   void sync_tag(Int dim, std::string const& name);
+  /* synchronizes several tags of one dimension in a single exchange */
+  void sync_tags(Int dim, std::vector<std::string> const& names);
+  /* synchronizes arrays of mixed types and widths in a single exchange.
+     each array is passed as a tag holding it, whose name is not used,
+     and the synchronized arrays come back as tags in the same order */
+  std::vector<TagPtr> sync_arrays(
+      Int ent_dim, std::vector<TagPtr> const& arrays);
   void reduce_tag(Int dim, std::string const& name, Omega_h_Op op);
   bool operator==(Mesh& other);
   Real min_quality();
@@ -391,6 +431,23 @@ void ask_for_mesh_tags(Mesh* mesh, TagSet const& tags);
 
 void reorder_by_hilbert(Mesh* mesh);
 void reorder_by_globals(Mesh* mesh);
+/* orders the elements along a Hilbert curve through their centroids
+   and every other entity by the first element using it.
+   unlike reorder_by_hilbert(), this works in parallel and keeps
+   global numbers, so it can follow adaptation */
+void reorder_by_elements(Mesh* mesh);
+/* the average distance, over element-vertex uses, between the index
+   of the vertex and the element's index scaled to vertex indices.
+   lower means better cache locality of element-to-vertex gathers */
+Real get_locality(Mesh* mesh);
+/* calls reorder_by_elements() if that would lower get_locality()
+   by more than a factor of min_improvement, returning whether it did */
+bool reorder_for_locality(Mesh* mesh, Real min_improvement);
+/* numbers the vertices in reverse Cuthill-McKee order of the vertex
+   graph, for a low bandwidth of matrices assembled over vertices,
+   and the other entities by their first vertex as reorder_by_hilbert()
+   does. works in parallel, ordering each part, and keeps global numbers */
+void reorder_by_rcm(Mesh* mesh);
 
 LOs ents_on_closure(
     Mesh* mesh, std::set<std::string> const& class_names, Int ent_dim);
@@ -421,6 +478,7 @@ __host__
   extern template Read<T> Mesh::sync_array(Int ent_dim, Read<T> a, Int width); \
   extern template Future<T> Mesh::isync_array(                                 \
       Int ent_dim, Read<T> a, Int width);                                      \
+  extern template DistPlan<T> Mesh::sync_plan(Int ent_dim, Int width);         \
   extern template Read<T> Mesh::owned_array(                                   \
       Int ent_dim, Read<T> a, Int width);                                      \
   extern template Read<T> Mesh::sync_subset_array(                             \
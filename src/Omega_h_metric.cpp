@@ -3,9 +3,11 @@
 #include <iostream>
 
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_atomics.hpp"
 #include "Omega_h_confined.hpp"
 #include "Omega_h_for.hpp"
 #include "Omega_h_host_few.hpp"
+#include "Omega_h_int_scan.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
 #include "Omega_h_metric_intersect.hpp"
@@ -150,15 +152,23 @@ Reals delinearize_metrics(LO nmetrics, Reals linear_metrics) {
   OMEGA_H_NORETURN(Reals());
 }
 
-/* gradation limiting code: */
+/* gradation limiting code:
+   the metric of each vertex is intersected with those its neighbors'
+   metrics imply at its position, growing at max_rate with distance.
+   sweeps repeat until no metric changes by more than tol.
+   rather than sweeping the whole mesh each time, a sweep only visits
+   the owned vertices that neighbor a metric changed by the previous
+   sweep, and only the changed metrics are sent to their ghost copies,
+   so once the first sweep is done the cost follows the front of
+   vertices still changing. */
 
 template <Int mesh_dim, Int metric_dim>
-Reals limit_gradation_once_tmpl(
-    Mesh* mesh, Reals values, Real max_rate) {
+Reals limit_gradation_of(Mesh* mesh, Reals values, LOs active, Real max_rate) {
   auto v2v = mesh->ask_star(VERT);
   auto coords = mesh->coords();
-  auto out = Write<Real>(mesh->nverts() * symm_ncomps(metric_dim));
-  auto f = OMEGA_H_LAMBDA(LO v) {
+  auto out = Write<Real>(active.size() * symm_ncomps(metric_dim));
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto v = active[i];
     auto m = get_symm<metric_dim>(values, v);
     auto x = get_vector<mesh_dim>(coords, v);
     for (auto vv = v2v.a2ab[v]; vv < v2v.a2ab[v + 1]; ++vv) {
@@ -172,41 +182,189 @@ Reals limit_gradation_once_tmpl(
       auto limited = intersect_metrics(m, limiter);
       m = limited;
     }
-    set_symm(out, v, m);
+    set_symm(out, i, m);
   };
-  parallel_for(mesh->nverts(), f, "limit_metric_gradation");
-  values = Reals(out);
-  values = mesh->sync_array(VERT, values, symm_ncomps(metric_dim));
-  return values;
+  parallel_for(active.size(), f, "limit_metric_gradation");
+  return out;
 }
 
-static Reals limit_gradation_once(Mesh* mesh, Reals values, Real max_rate) {
+static Reals limit_gradation_of(
+    Mesh* mesh, Reals values, LOs active, Real max_rate) {
   auto metric_dim = get_metrics_dim(mesh->nverts(), values);
   if (mesh->dim() == 3 && metric_dim == 3) {
-    return limit_gradation_once_tmpl<3, 3>(mesh, values, max_rate);
+    return limit_gradation_of<3, 3>(mesh, values, active, max_rate);
   } else if (mesh->dim() == 2 && metric_dim == 2) {
-    return limit_gradation_once_tmpl<2, 2>(mesh, values, max_rate);
+    return limit_gradation_of<2, 2>(mesh, values, active, max_rate);
   } else if (mesh->dim() == 3 && metric_dim == 1) {
-    return limit_gradation_once_tmpl<3, 1>(mesh, values, max_rate);
+    return limit_gradation_of<3, 1>(mesh, values, active, max_rate);
   } else if (mesh->dim() == 2 && metric_dim == 1) {
-    return limit_gradation_once_tmpl<2, 1>(mesh, values, max_rate);
+    return limit_gradation_of<2, 1>(mesh, values, active, max_rate);
   } else if (mesh->dim() == 1) {
-    return limit_gradation_once_tmpl<1, 1>(mesh, values, max_rate);
+    return limit_gradation_of<1, 1>(mesh, values, active, max_rate);
   }
   OMEGA_H_NORETURN(Reals());
 }
 
+/* the vertices whose metric changed by more than tol,
+   as indices into active */
+static LOs find_changed(
+    Reals values, LOs active, Reals limited, Int ncomps, Real tol) {
+  auto changed = Write<I8>(active.size());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto v = active[i];
+    I8 c = 0;
+    for (Int j = 0; j < ncomps; ++j) {
+      if (!are_close(values[v * ncomps + j], limited[i * ncomps + j], tol)) {
+        c = 1;
+      }
+    }
+    changed[i] = c;
+  };
+  parallel_for(active.size(), f, "find_changed_metrics");
+  return collect_marked(Read<I8>(changed));
+}
+
+/* sends the new metrics of changed owned vertices to their copies on
+   other ranks, writing them into values and returning the vertices
+   this rank received new metrics for */
+static LOs send_changed(Mesh* mesh, Dist const& owners2copies,
+    LOs changed_verts, Reals changed_values, Write<Real> values, Int ncomps) {
+  auto comm = mesh->comm();
+  auto rank = comm->rank();
+  auto v2copies = owners2copies.roots2items();
+  auto copies = owners2copies.items2dests();
+  auto degrees = Write<LO>(changed_verts.size());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto v = changed_verts[i];
+    LO n = 0;
+    for (auto vc = v2copies[v]; vc < v2copies[v + 1]; ++vc) {
+      n += (copies.ranks[vc] != rank);
+    }
+    degrees[i] = n;
+  };
+  parallel_for(changed_verts.size(), f, "count_changed_copies");
+  auto offsets = offset_scan(LOs(degrees));
+  auto nsends = offsets.last();
+  auto ranks = Write<I32>(nsends);
+  auto idxs = Write<LO>(nsends);
+  auto data = Write<Real>(nsends * ncomps);
+  auto g = OMEGA_H_LAMBDA(LO i) {
+    auto v = changed_verts[i];
+    auto send = offsets[i];
+    for (auto vc = v2copies[v]; vc < v2copies[v + 1]; ++vc) {
+      if (copies.ranks[vc] == rank) continue;
+      ranks[send] = copies.ranks[vc];
+      idxs[send] = copies.idxs[vc];
+      for (Int j = 0; j < ncomps; ++j) {
+        data[send * ncomps + j] = changed_values[i * ncomps + j];
+      }
+      ++send;
+    }
+  };
+  parallel_for(changed_verts.size(), g, "pack_changed_copies");
+  Dist dist;
+  dist.set_parent_comm(comm);
+  dist.set_dest_ranks(ranks);
+  auto received = dist.exch(LOs(idxs), 1);
+  map_into(dist.exch(Reals(data), ncomps), received, values, ncomps);
+  return received;
+}
+
+/* the owned vertices adjacent to the given ones, without repeats.
+   claims is zero on entry and exit */
+static LOs get_owned_neighbors(
+    Graph v2v, Read<I8> owned, LOs verts, Write<I32> claims) {
+  auto degrees = Write<LO>(verts.size());
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto v = verts[i];
+    degrees[i] = v2v.a2ab[v + 1] - v2v.a2ab[v];
+  };
+  parallel_for(verts.size(), f, "count_neighbors");
+  auto offsets = offset_scan(LOs(degrees));
+  auto candidates = Write<LO>(offsets.last());
+  auto keep = Write<I8>(offsets.last());
+  auto g = OMEGA_H_LAMBDA(LO i) {
+    auto v = verts[i];
+    auto c = offsets[i];
+    for (auto vv = v2v.a2ab[v]; vv < v2v.a2ab[v + 1]; ++vv, ++c) {
+      auto av = v2v.ab2b[vv];
+      candidates[c] = av;
+      keep[c] = owned[av] && (atomic_fetch_add(&claims[av], 1) == 0);
+    }
+  };
+  parallel_for(verts.size(), g, "claim_neighbors");
+  auto neighbors = unmap(collect_marked(Read<I8>(keep)), LOs(candidates), 1);
+  auto h = OMEGA_H_LAMBDA(LO i) { claims[candidates[i]] = 0; };
+  parallel_for(candidates.size(), h, "release_neighbors");
+  return neighbors;
+}
+
 Reals limit_metric_gradation(
     Mesh* mesh, Reals values, Real max_rate, Real tol, bool verbose) {
   OMEGA_H_TIME_FUNCTION;
   OMEGA_H_CHECK(mesh->owners_have_all_upward(VERT));
   OMEGA_H_CHECK(max_rate > 0.0);
   auto comm = mesh->comm();
+  auto ncomps = divide_no_remainder(values.size(), mesh->nverts());
+  auto v2v = mesh->ask_star(VERT);
+  auto owned = mesh->owned(VERT);
+  auto is_parallel = comm->size() > 1;
+  auto owners2copies = is_parallel ? mesh->ask_dist(VERT).invert() : Dist();
+  auto claims = Write<I32>(mesh->nverts(), 0);
+  auto out = deep_copy(values);
+  auto active = collect_marked(owned);
+  Int nsweeps = 0;
+  GO nvisits = 0;
+  GO max_active = 0;
+  while (true) {
+    auto nactive = comm->allreduce(GO(active.size()), OMEGA_H_SUM);
+    if (nactive == 0) break;
+    nvisits += nactive;
+    max_active = max2(max_active, nactive);
+    ++nsweeps;
+    if (verbose && can_print(mesh) && nsweeps % 50 == 0) {
+      std::cout << "warning: gradation limiting is up to step " << nsweeps
+                << " with " << nactive << " vertices active\n";
+    }
+    auto limited = limit_gradation_of(mesh, Reals(out), active, max_rate);
+    auto changed = find_changed(Reals(out), active, limited, ncomps, tol);
+    auto changed_verts = LOs(unmap(changed, active, 1));
+    auto changed_values = Reals(unmap(changed, limited, ncomps));
+    map_into(changed_values, changed_verts, out, ncomps);
+    auto sources = changed_verts;
+    if (is_parallel) {
+      auto received = send_changed(
+          mesh, owners2copies, changed_verts, changed_values, out, ncomps);
+      auto nsources = changed_verts.size() + received.size();
+      auto sources_w = Write<LO>(nsources);
+      map_into_range(changed_verts, 0, changed_verts.size(), sources_w, 1);
+      map_into_range(received, changed_verts.size(), nsources, sources_w, 1);
+      sources = sources_w;
+    }
+    active = get_owned_neighbors(v2v, owned, sources, claims);
+  }
+  if (verbose && can_print(mesh)) {
+    std::cout << "limited gradation in " << nsweeps << " steps, visiting "
+              << nvisits << " vertices (at most " << max_active
+              << " per step)\n";
+  }
+  return out;
+}
+
+Reals limit_metric_gradation_by_sweeps(
+    Mesh* mesh, Reals values, Real max_rate, Real tol, bool verbose) {
+  OMEGA_H_TIME_FUNCTION;
+  OMEGA_H_CHECK(mesh->owners_have_all_upward(VERT));
+  OMEGA_H_CHECK(max_rate > 0.0);
+  auto comm = mesh->comm();
+  auto ncomps = divide_no_remainder(values.size(), mesh->nverts());
+  auto all = LOs(mesh->nverts(), 0, 1);
   Reals values2 = values;
   Int i = 0;
   do {
     values = values2;
-    values2 = limit_gradation_once(mesh, values, max_rate);
+    values2 = limit_gradation_of(mesh, values, all, max_rate);
+    values2 = mesh->sync_array(VERT, values2, ncomps);
     ++i;
     if (verbose && can_print(mesh) && i > 0 && i % 50 == 0) {
       std::cout << "warning: gradation limiting is up to step " << i << '\n';
@@ -261,10 +419,16 @@ Reals element_implied_length_metrics_dim(Mesh* mesh) {
   auto ev2v = mesh->ask_elem_verts();
   auto coords = mesh->coords();
   auto sizes = mesh->ask_sizes();
+  auto packed = mesh->caches_elem_verts();
+  auto elem_coords = packed ? mesh->ask_elem_coords() : Reals();
   auto out = Write<Real>(mesh->nelems() * symm_ncomps(dim));
   auto f = OMEGA_H_LAMBDA(LO e) {
-    auto v = gather_verts<dim + 1>(ev2v, e);
-    auto p = gather_vectors<dim + 1, dim>(coords, v);
+    Few<Vector<dim>, dim + 1> p;
+    if (packed) {
+      p = get_packed_vectors<dim + 1, dim>(elem_coords, e);
+    } else {
+      p = gather_vectors<dim + 1, dim>(coords, gather_verts<dim + 1>(ev2v, e));
+    }
     auto m = element_implied_metric(p);
     set_symm(out, e, m);
   };
@@ -203,8 +203,19 @@ Reals get_implied_isos(Mesh* mesh);
 Reals get_element_implied_length_metrics(Mesh* mesh);
 Reals get_pure_implied_metrics(Mesh* mesh);
 Reals get_implied_metrics(Mesh* mesh);
+/* limits the growth of the metric between neighboring vertices to
+   max_rate. a vertex is revisited only while a neighbor's metric
+   changes, and its metric is only replaced when the new one differs
+   by more than tol (relatively, per component), so every vertex ends
+   within tol of the limit its neighbors imply. */
 Reals limit_metric_gradation(Mesh* mesh, Reals values, Real max_rate,
     Real tol = 1e-2, bool verbose = true);
+/* the reference for limit_metric_gradation: every step limits all
+   vertices and replaces all metrics, until no metric changes by more
+   than tol. changes below tol are still applied in each step, so the
+   two agree to within a small multiple of tol rather than exactly */
+Reals limit_metric_gradation_by_sweeps(Mesh* mesh, Reals values,
+    Real max_rate, Real tol = 1e-2, bool verbose = true);
 Reals get_complexity_per_elem(Mesh* mesh, Reals v2m);
 Reals get_nelems_per_elem(Mesh* mesh, Reals v2m);
 Real get_complexity(Mesh* mesh, Reals v2m);
@@ -11,6 +11,7 @@
 #include "Omega_h_map.hpp"
 #include "Omega_h_mark.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_migrate.hpp"
 #include "Omega_h_owners.hpp"
 #include "Omega_h_timer.hpp"
 #include "Omega_h_unmap_mesh.hpp"
@@ -69,6 +70,143 @@ static void modify_conn(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
   new_mesh->set_ents(ent_dim, new_ents2new_lows);
 }
 
+static bool incremental_up_adjs_enabled = false;
+
+void enable_incremental_up_adjs() { incremental_up_adjs_enabled = true; }
+
+void disable_incremental_up_adjs() { incremental_up_adjs_enabled = false; }
+
+bool is_incremental_up_adjs_enabled() { return incremental_up_adjs_enabled; }
+
+/* carries the upward adjacency from (ent_dim - 1) to (ent_dim) from the
+   old mesh into the new one, if the old mesh had derived it.
+   the only rows that change are those of low entities of products and
+   of old entities which did not survive. every other row keeps its old
+   degree and its entries, renumbered, with the same codes (their
+   downward adjacency is copied unchanged), and since renumbering
+   preserves the order of surviving entities it stays sorted.
+   the changed rows are rebuilt from their surviving entries merged with
+   product entries found by inverting the products' downward adjacency,
+   so the inversion and sorting work is proportional to the number of
+   products rather than the size of the mesh. */
+static void modify_up_adj(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
+    LOs old_lows2new_lows, LOs prods2new_ents, LOs old_ents2new_ents) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const low_dim = ent_dim - 1;
+  if (!old_mesh->has_adj(low_dim, ent_dim)) return;
+  auto const old_up = old_mesh->get_adj(low_dim, ent_dim);
+  auto const old_ent_lows2old_lows = old_mesh->ask_down(ent_dim, low_dim).ab2b;
+  auto const new_down = new_mesh->ask_down(ent_dim, low_dim);
+  auto const deg = element_degree(old_mesh->family(), ent_dim, low_dim);
+  auto const nold_ents = old_mesh->nents(ent_dim);
+  auto const nold_lows = old_mesh->nents(low_dim);
+  auto const nnew_lows = new_mesh->nents(low_dim);
+  auto const nprod_uses = prods2new_ents.size() * deg;
+  Write<LO> prod_uses2new_lows(nprod_uses);
+  auto const new_ent_lows2new_lows = new_down.ab2b;
+  auto get_prod_lows = OMEGA_H_LAMBDA(LO prod_use) {
+    auto const new_ent = prods2new_ents[prod_use / deg];
+    prod_uses2new_lows[prod_use] =
+        new_ent_lows2new_lows[new_ent * deg + prod_use % deg];
+  };
+  parallel_for(nprod_uses, std::move(get_prod_lows), "modify_up_adj(prods)");
+  auto const new_lows2prod_uses =
+      invert_map_by_atomics(prod_uses2new_lows, nnew_lows);
+  Write<I8> old_lows_lost_ents(nold_lows, 0);
+  auto mark_lost = OMEGA_H_LAMBDA(LO old_ent) {
+    if (old_ents2new_ents[old_ent] >= 0) return;
+    for (Int i = 0; i < deg; ++i) {
+      old_lows_lost_ents[old_ent_lows2old_lows[old_ent * deg + i]] = 1;
+    }
+  };
+  parallel_for(nold_ents, std::move(mark_lost), "modify_up_adj(lost)");
+  Write<LO> new_lows2old_lows(nnew_lows, -1);
+  auto invert_lows = OMEGA_H_LAMBDA(LO old_low) {
+    auto const new_low = old_lows2new_lows[old_low];
+    if (new_low >= 0) new_lows2old_lows[new_low] = old_low;
+  };
+  parallel_for(nold_lows, std::move(invert_lows), "modify_up_adj(lows)");
+  Write<I8> new_lows_changed(nnew_lows);
+  Write<LO> degrees(nnew_lows);
+  auto count = OMEGA_H_LAMBDA(LO new_low) {
+    auto n = new_lows2prod_uses.a2ab[new_low + 1] -
+             new_lows2prod_uses.a2ab[new_low];
+    auto const old_low = new_lows2old_lows[new_low];
+    auto const changed = n > 0 || old_low < 0 || old_lows_lost_ents[old_low];
+    new_lows_changed[new_low] = I8(changed);
+    if (!changed) {
+      degrees[new_low] = old_up.a2ab[old_low + 1] - old_up.a2ab[old_low];
+      return;
+    }
+    if (old_low >= 0) {
+      for (auto lh = old_up.a2ab[old_low]; lh < old_up.a2ab[old_low + 1];
+           ++lh) {
+        if (old_ents2new_ents[old_up.ab2b[lh]] >= 0) ++n;
+      }
+    }
+    degrees[new_low] = n;
+  };
+  parallel_for(nnew_lows, std::move(count), "modify_up_adj(count)");
+  auto const new_l2lh = offset_scan(LOs(degrees));
+  auto const nnew_lh = new_l2lh.last();
+  Write<LO> new_lh2h(nnew_lh);
+  Write<I8> new_codes(nnew_lh);
+  auto copy = OMEGA_H_LAMBDA(LO new_low) {
+    if (new_lows_changed[new_low]) return;
+    auto const old_low = new_lows2old_lows[new_low];
+    auto lh = new_l2lh[new_low];
+    for (auto old_lh = old_up.a2ab[old_low]; old_lh < old_up.a2ab[old_low + 1];
+         ++old_lh, ++lh) {
+      new_lh2h[lh] = old_ents2new_ents[old_up.ab2b[old_lh]];
+      new_codes[lh] = old_up.codes[old_lh];
+    }
+  };
+  parallel_for(nnew_lows, std::move(copy), "modify_up_adj(copy)");
+  auto const changed2new_lows = collect_marked(Read<I8>(new_lows_changed));
+  auto const new_ent_low_codes = new_down.codes;
+  auto const has_codes = new_ent_low_codes.exists();
+  auto rebuild = OMEGA_H_LAMBDA(LO changed) {
+    auto const new_low = changed2new_lows[changed];
+    auto lh = new_l2lh[new_low];
+    auto const old_low = new_lows2old_lows[new_low];
+    if (old_low >= 0) {
+      for (auto old_lh = old_up.a2ab[old_low];
+           old_lh < old_up.a2ab[old_low + 1]; ++old_lh) {
+        auto const new_ent = old_ents2new_ents[old_up.ab2b[old_lh]];
+        if (new_ent < 0) continue;
+        new_lh2h[lh] = new_ent;
+        new_codes[lh] = old_up.codes[old_lh];
+        ++lh;
+      }
+    }
+    /* insert product entries into the sorted row */
+    for (auto lp = new_lows2prod_uses.a2ab[new_low];
+         lp < new_lows2prod_uses.a2ab[new_low + 1]; ++lp) {
+      auto const prod_use = new_lows2prod_uses.ab2b[lp];
+      auto const new_ent = prods2new_ents[prod_use / deg];
+      auto const which_down = prod_use % deg;
+      I8 code = make_code(false, 0, which_down);
+      if (has_codes) {
+        auto const down_code = new_ent_low_codes[new_ent * deg + which_down];
+        code = make_code(
+            code_is_flipped(down_code), code_rotation(down_code), which_down);
+      }
+      auto j = lh;
+      for (; j > new_l2lh[new_low] && new_lh2h[j - 1] > new_ent; --j) {
+        new_lh2h[j] = new_lh2h[j - 1];
+        new_codes[j] = new_codes[j - 1];
+      }
+      new_lh2h[j] = new_ent;
+      new_codes[j] = code;
+      ++lh;
+    }
+  };
+  parallel_for(
+      changed2new_lows.size(), std::move(rebuild), "modify_up_adj(rebuild)");
+  new_mesh->set_up(
+      low_dim, ent_dim, Adj(new_l2lh, LOs(new_lh2h), Read<I8>(new_codes)));
+}
+
 /* this is the case of AMR-style refinement where
    some entities being split (mods) are actually on
    the partition boundary.
@@ -277,7 +415,42 @@ LOs get_rep2md_order_adapt(
   auto all_orders =
       get_rep2md_order(mesh, rep_dim, mods2mds, mods2nprods, mods_have_prods);
   OMEGA_H_CHECK(all_orders[key_dim].exists());
-  return all_orders[key_dim];
+  if (mesh->owners_have_all_upward(rep_dim)) return all_orders[key_dim];
+  /* without ghosts, each copy of a representative only orders the keys
+     it holds, which must not be shared. the copies then take turns
+     in the order their owner lists them */
+  auto keys2kds = mods2mds[key_dim];
+  auto kds2reps = mesh->ask_down(key_dim, rep_dim).ab2b;
+  auto deg = element_degree(mesh->family(), key_dim, rep_dim);
+  Write<LO> rep_counts(mesh->nents(rep_dim), 0);
+  auto count = OMEGA_H_LAMBDA(LO key) {
+    atomic_add(&rep_counts[kds2reps[keys2kds[key] * deg]], 1);
+  };
+  parallel_for(keys2kds.size(), count, "get_rep2md_order_adapt(count)");
+  auto copies2owners = mesh->ask_dist(rep_dim);
+  auto serv_counts = copies2owners.exch(Read<LO>(rep_counts), 1);
+  auto owners2copies = copies2owners.invert();
+  auto owners2serv_copies = owners2copies.roots2items();
+  Write<LO> serv_offsets(serv_counts.size());
+  auto scan = OMEGA_H_LAMBDA(LO owner) {
+    LO offset = 0;
+    for (auto serv_copy = owners2serv_copies[owner];
+         serv_copy < owners2serv_copies[owner + 1]; ++serv_copy) {
+      serv_offsets[serv_copy] = offset;
+      offset += serv_counts[serv_copy];
+    }
+  };
+  parallel_for(owners2serv_copies.size() - 1, scan, "get_rep2md_order_adapt");
+  owners2copies.set_roots2items(LOs());
+  auto rep_offsets = owners2copies.exch(Read<LO>(serv_offsets), 1);
+  auto orders = all_orders[key_dim];
+  Write<LO> out(orders.size());
+  auto shift = OMEGA_H_LAMBDA(LO kd) {
+    out[kd] = orders[kd];
+    if (orders[kd] >= 0) out[kd] += rep_offsets[kds2reps[kd * deg]];
+  };
+  parallel_for(orders.size(), shift, "get_rep2md_order_adapt(shift)");
+  return out;
 }
 
 Few<LOs, 4> get_rep2md_order(Mesh* mesh, Int rep_dim, Few<LOs, 4> mods2mds,
@@ -379,6 +552,8 @@ void assign_new_numbering(Read<T> old_ents2new_numbers,
       OMEGA_H_CHECK(mods2mds[mod_dim].exists());
       auto rep2md_order_dim = rep2md_order[mod_dim];
       auto write_prod_offsets = OMEGA_H_LAMBDA(LO mod) {
+        /* a modified entity without products here need not be ordered */
+        if (mods2prods_dim[mod] == mods2prods_dim[mod + 1]) return;
         auto md = mods2mds_dim[mod];
         auto md_order = rep2md_order_dim[md];
         OMEGA_H_CHECK(md_order >= 0);
@@ -503,6 +678,10 @@ void modify_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
     modify_conn(old_mesh, new_mesh, ent_dim, prod_verts2verts,
         *p_prods2new_ents, *p_same_ents2old_ents, *p_same_ents2new_ents,
         old_lows2new_lows);
+    if (incremental_up_adjs_enabled) {
+      modify_up_adj(old_mesh, new_mesh, ent_dim, old_lows2new_lows,
+          *p_prods2new_ents, *p_old_ents2new_ents);
+    }
   }
   if (old_mesh->comm()->size() > 1) {
     modify_owners(old_mesh, new_mesh, ent_dim, mods2mds, mods2prods,
@@ -525,7 +704,6 @@ void set_owners_by_indset(
   auto kds2kd_elems = kds2elems.a2ab;
   auto kd_elems2elems = kds2elems.ab2b;
   auto elem_owners = mesh->ask_owners(elem_dim);
-  auto elems2owners = mesh->ask_dist(elem_dim);
   auto new_elem_ranks = deep_copy(elem_owners.ranks);
   auto f = OMEGA_H_LAMBDA(LO key) {
     auto kd = keys2kds[key];
@@ -537,6 +715,22 @@ void set_owners_by_indset(
     }
   };
   parallel_for(nkeys, f, "set_owners_by_indset");
+  if (mesh->parting() == OMEGA_H_ELEM_BASED) {
+    /* without ghosts, each copy of a key holds part of its cavity.
+       those parts move to the key owner now, the rest stays put */
+    auto comm = mesh->comm();
+    auto elem_ranks = Read<I32>(new_elem_ranks);
+    if (!comm->reduce_or(!(elem_ranks == elem_owners.ranks))) return;
+    auto nelems = mesh->nelems();
+    Dist elems2new_elems;
+    elems2new_elems.set_parent_comm(comm);
+    elems2new_elems.set_dest_ranks(elem_ranks);
+    elems2new_elems.set_roots2items(LOs(nelems + 1, 0, 1));
+    elems2new_elems.set_dest_globals(mesh->globals(elem_dim));
+    migrate_mesh(mesh, elems2new_elems.invert(), OMEGA_H_ELEM_BASED, false);
+    return;
+  }
+  auto elems2owners = mesh->ask_dist(elem_dim);
   elem_owners = update_ownership(elems2owners, new_elem_ranks);
   mesh->set_owners(elem_dim, elem_owners);
 }
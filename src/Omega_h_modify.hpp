@@ -8,6 +8,7 @@
 namespace Omega_h {
 
 class Mesh;
+struct AdaptOpts;
 
 LOs get_rep2md_order_adapt(
     Mesh* mesh, Int key_dim, Int rep_dim, Bytes kds_are_keys);
@@ -26,9 +27,23 @@ void modify_ents(Mesh* old_mesh, Mesh* new_mesh, Int ent_dim,
     bool mods_can_be_shared, LOs* p_prods2new_ents, LOs* p_same_ents2old_ents,
     LOs* p_same_ents2new_ents, LOs* p_old_ents2new_ents);
 
+/* when enabled, modify_ents carries the upward adjacencies between
+   consecutive dimensions (vertices to edges, edges to faces, ...) that
+   the old mesh had already derived into the new mesh, patching only
+   the rows around products instead of inverting from scratch */
+void enable_incremental_up_adjs();
+void disable_incremental_up_adjs();
+bool is_incremental_up_adjs_enabled();
+
 void set_owners_by_indset(
     Mesh* mesh, Int key_dim, LOs keys2kds, Graph kds2elems);
 
+/* the parting in which refine, coarsen and swap choose their cavities */
+void set_cavity_parting(Mesh* mesh, AdaptOpts const& opts);
+/* drops the candidate keys whose cavities are not all on this rank */
+Read<I8> filter_local_cavities(
+    Mesh* mesh, AdaptOpts const& opts, Int key_dim, Read<I8> cands);
+
 }  // end namespace Omega_h
 
 #endif
@@ -0,0 +1,212 @@
+#include "Omega_h_multisect.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Omega_h_array_ops.hpp"
+#include "Omega_h_atomics.hpp"
+#include "Omega_h_bipart.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_profile.hpp"
+
+namespace Omega_h {
+
+namespace multisect {
+
+namespace {
+
+struct Extent {
+  Int axis;
+  Real lo;
+  Real hi;
+};
+
+Extent get_longest_extent(CommPtr comm, Reals coords) {
+  HostWrite<Real> h_lo(3);
+  HostWrite<Real> h_hi(3);
+  for (Int d = 0; d < 3; ++d) {
+    auto const x = get_component(coords, 3, d);
+    h_lo[d] = get_min(x);
+    h_hi[d] = get_max(x);
+  }
+  HostRead<Real> const lo(comm->allreduce(Reals(h_lo.write()), OMEGA_H_MIN));
+  HostRead<Real> const hi(comm->allreduce(Reals(h_hi.write()), OMEGA_H_MAX));
+  Extent out{0, lo[0], hi[0]};
+  for (Int d = 1; d < 3; ++d) {
+    if (hi[d] - lo[d] > out.hi - out.lo) out = Extent{d, lo[d], hi[d]};
+  }
+  return out;
+}
+
+/* weights in fixed point, in units of 2^-30 of the total weight,
+   so that local bin sums fit in 32 bits and global sums are exact
+   (hence independent of the order of summation) */
+LOs to_fixed_point(Reals weights, Real unit) {
+  Write<LO> out(weights.size());
+  auto f = OMEGA_H_LAMBDA(LO i) { out[i] = LO(weights[i] / unit + 0.5); };
+  parallel_for(weights.size(), f, "to_fixed_point");
+  return out;
+}
+
+/* bin b of [lo, hi) is [boundary(b), boundary(b + 1)) */
+OMEGA_H_INLINE Real boundary(Real lo, Real hi, Int b) {
+  return (b == nbins) ? hi : lo + (hi - lo) * (Real(b) / Real(nbins));
+}
+
+OMEGA_H_INLINE Int bin_of(Real x, Real lo, Real hi) {
+  auto b = Int((x - lo) / (hi - lo) * Real(nbins));
+  if (b < 0) b = 0;
+  if (b >= nbins) b = nbins - 1;
+  while (b > 0 && x < boundary(lo, hi, b)) --b;
+  while (b + 1 < nbins && !(x < boundary(lo, hi, b + 1))) ++b;
+  return b;
+}
+
+/* one histogram of nbins bins per cut, over the cut's interval [lo, hi).
+   a cut which has been found has an empty interval (lo == hi) */
+Read<I64> get_histograms(
+    CommPtr comm, Reals x, LOs units, Reals los, Reals his) {
+  auto const ncuts = los.size();
+  Write<LO> local(ncuts * nbins, 0);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    auto const xi = x[i];
+    for (Int c = 0; c < ncuts; ++c) {
+      auto const lo = los[c];
+      auto const hi = his[c];
+      if (!(lo <= xi && xi < hi)) continue;
+      atomic_add(&local[c * nbins + bin_of(xi, lo, hi)], units[i]);
+    }
+  };
+  parallel_for(x.size(), f, "multisect_histogram");
+  Write<I64> wide(local.size());
+  auto g = OMEGA_H_LAMBDA(LO i) { wide[i] = I64(local[i]); };
+  parallel_for(wide.size(), g, "multisect_widen");
+  return comm->allreduce(Read<I64>(wide), OMEGA_H_SUM);
+}
+
+}  // end anonymous namespace
+
+Int choose_nsections(I32 nparts, Int max_sections) {
+  Int nsections = 1;
+  auto rest = nparts;
+  while (rest > 1) {
+    I32 p = 2;
+    while (rest % p) ++p;
+    if (nsections > 1 && nsections * p > max_sections) break;
+    nsections *= p;
+    rest /= p;
+  }
+  return nsections;
+}
+
+Read<I32> mark_multisection(CommPtr comm, Reals coords, Reals weights,
+    Int nsections, Real tolerance) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const n = weights.size();
+  OMEGA_H_CHECK(coords.size() == n * 3);
+  OMEGA_H_CHECK(nsections >= 1);
+  if (nsections == 1) return Read<I32>(n, 0);
+  auto total = repro_sum(comm, weights);
+  if (!(total > 0.)) {
+    weights = Reals(n, 1.);
+    total = comm->allreduce(Real(n), OMEGA_H_SUM);
+    if (!(total > 0.)) return Read<I32>(n, 0);
+  }
+  auto const unit = total / Real(LO(1) << 30);
+  auto const units = to_fixed_point(weights, unit);
+  auto const tol_units = tolerance / unit;
+  auto const extent = get_longest_extent(comm, coords);
+  auto const x = get_component(coords, 3, extent.axis);
+  auto const ncuts = nsections - 1;
+  auto const top =
+      std::nextafter(extent.hi, std::numeric_limits<Real>::infinity());
+  std::vector<Real> lo(std::size_t(ncuts), extent.lo);
+  std::vector<Real> hi(std::size_t(ncuts), top);
+  /* weight below lo, in units */
+  std::vector<Real> below(std::size_t(ncuts), 0.);
+  HostWrite<Real> cuts(ncuts);
+  Real total_units = 0.;
+  for (Int round = 0; round < max_histogram_rounds; ++round) {
+    HostWrite<Real> h_los(ncuts);
+    HostWrite<Real> h_his(ncuts);
+    bool searching = false;
+    for (Int c = 0; c < ncuts; ++c) {
+      h_los[c] = lo[std::size_t(c)];
+      h_his[c] = hi[std::size_t(c)];
+      searching = searching || (h_los[c] < h_his[c]);
+    }
+    if (!searching) break;
+    auto const hists = HostRead<I64>(get_histograms(
+        comm, x, units, Reals(h_los.write()), Reals(h_his.write())));
+    if (round == 0) {
+      for (Int b = 0; b < nbins; ++b) total_units += Real(hists[b]);
+    }
+    auto const last_round = (round + 1 == max_histogram_rounds);
+    for (Int c = 0; c < ncuts; ++c) {
+      auto const ci = std::size_t(c);
+      if (!(lo[ci] < hi[ci])) continue;
+      auto const target = total_units * Real(c + 1) / Real(nsections);
+      auto left_weight = below[ci];
+      auto right_weight = left_weight;
+      Int b = 0;
+      for (; b < nbins; ++b) {
+        right_weight = left_weight + Real(hists[c * nbins + b]);
+        if (right_weight >= target) break;
+        left_weight = right_weight;
+      }
+      if (b == nbins) {
+        cuts[c] = hi[ci];
+      } else {
+        auto const left = boundary(lo[ci], hi[ci], b);
+        auto const right = boundary(lo[ci], hi[ci], b + 1);
+        if (right_weight - target <= tol_units) {
+          cuts[c] = right;
+        } else if (target - left_weight <= tol_units) {
+          cuts[c] = left;
+        } else if (last_round || !(left < right)) {
+          cuts[c] =
+              (target - left_weight <= right_weight - target) ? left : right;
+        } else {
+          lo[ci] = left;
+          hi[ci] = right;
+          below[ci] = left_weight;
+          continue;
+        }
+      }
+      lo[ci] = hi[ci] = cuts[c];
+    }
+  }
+  Reals const cuts_d = cuts.write();
+  Write<I32> sections(n);
+  auto f = OMEGA_H_LAMBDA(LO i) {
+    I32 s = 0;
+    for (Int c = 0; c < ncuts; ++c) s += (x[i] >= cuts_d[c]);
+    sections[i] = s;
+  };
+  parallel_for(n, f, "mark_multisection");
+  return sections;
+}
+
+void recursively_multisect(CommPtr comm, Real tolerance, Reals* p_coords,
+    Reals* p_weights, Remotes* p_owners, Int max_sections) {
+  OMEGA_H_TIME_FUNCTION;
+  auto& coords = *p_coords;
+  auto& weights = *p_weights;
+  auto& owners = *p_owners;
+  while (comm->size() > 1) {
+    auto const nsections = choose_nsections(comm->size(), max_sections);
+    auto const sections =
+        mark_multisection(comm, coords, weights, nsections, tolerance);
+    auto const dist = multi_partition(comm, sections, nsections);
+    coords = dist.exch(coords, 3);
+    weights = dist.exch(weights, 1);
+    owners = dist.exch(owners, 1);
+    auto const groupsize = divide_no_remainder(comm->size(), nsections);
+    comm = comm->split(comm->rank() / groupsize, comm->rank() % groupsize);
+  }
+}
+
+}  // namespace multisect
+
+}  // end namespace Omega_h
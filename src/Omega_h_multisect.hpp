@@ -0,0 +1,42 @@
+#ifndef OMEGA_H_MULTISECT_HPP
+#define OMEGA_H_MULTISECT_HPP
+
+#include "Omega_h_remotes.hpp"
+
+namespace Omega_h {
+
+namespace multisect {
+
+/* recursive coordinate multi-section:
+   each level splits the ranks of a group into k subgroups and
+   the items into k slabs of equal weight along the longest axis
+   of their bounding box, sending each slab to one subgroup.
+   all k - 1 cuts of a level are searched for together,
+   using global weight histograms of nbins bins which narrow down
+   around each cut, so a level costs a few collectives
+   rather than one per bisection step. */
+
+constexpr Int nbins = 256;
+constexpr Int max_histogram_rounds = 8;
+constexpr Int default_max_sections = 4;
+
+/* the number of sections for a group of nparts ranks:
+   a product of the smallest prime factors of nparts,
+   at most max_sections unless nparts has a larger prime factor */
+Int choose_nsections(I32 nparts, Int max_sections);
+
+/* the section in [0, nsections) of each item, such that each section
+   weighs within tolerance of an equal share.
+   coords are 3D, weights must be non-negative */
+Read<I32> mark_multisection(CommPtr comm, Reals coords, Reals weights,
+    Int nsections, Real tolerance);
+
+void recursively_multisect(CommPtr comm, Real tolerance, Reals* p_coords,
+    Reals* p_weights, Remotes* p_owners,
+    Int max_sections = default_max_sections);
+
+}  // namespace multisect
+
+}  // end namespace Omega_h
+
+#endif
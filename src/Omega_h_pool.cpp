@@ -1,76 +1,145 @@
 #include <Omega_h_fail.hpp>
 #include <Omega_h_pool.hpp>
 #include <Omega_h_profile.hpp>
-#include <algorithm>
 
 namespace Omega_h {
 
-static void call_underlying_frees(Pool& pool, BlockList list[]) {
-  for (std::size_t i = 0; i < 64; ++i) {
-    for (auto block : list[i]) {
-      pool.underlying_free(block, (std::size_t(1) << i));
-    }
-    list[i].clear();
-  }
+static std::size_t min_block_shift() {
+  std::size_t shift = 0;
+  while ((std::size_t(1) << shift) < pool_min_block) ++shift;
+  return shift;
 }
 
-Pool::Pool(MallocFunc malloc_in, FreeFunc free_in)
-    : underlying_malloc(malloc_in), underlying_free(free_in) {}
+static std::size_t size_class(std::size_t size) {
+  if (size <= pool_min_block) return 0;
+  /* find k such that 2^k < size <= 2^(k+1) */
+  std::size_t k = min_block_shift();
+  while ((std::size_t(1) << (k + 1)) < size) ++k;
+  auto const base = std::size_t(1) << k;
+  auto const step = base / pool_subclasses;
+  auto const sub = (size - base + step - 1) / step;
+  return (k - min_block_shift()) * pool_subclasses + sub;
+}
+
+static std::size_t class_block_size(std::size_t c) {
+  if (c == 0) return pool_min_block;
+  auto const k = (c - 1) / pool_subclasses + min_block_shift();
+  auto const sub = (c - 1) % pool_subclasses + 1;
+  auto const base = std::size_t(1) << k;
+  return base + sub * (base / pool_subclasses);
+}
 
-Pool::~Pool() {
-  call_underlying_frees(*this, used_blocks);
-  call_underlying_frees(*this, free_blocks);
+std::size_t pool_block_size(std::size_t size) {
+  return class_block_size(size_class(size));
 }
 
-static std::size_t underlying_total_size(Pool& pool) {
-  std::size_t total_size = 0;
-  for (std::size_t i = 0; i < 64; ++i) {
-    total_size += (std::size_t(1) << i) * pool.used_blocks[i].size();
-    total_size += (std::size_t(1) << i) * pool.free_blocks[i].size();
+PoolStats::PoolStats()
+    : hits(0),
+      misses(0),
+      trimmed_blocks(0),
+      requested_bytes(0),
+      used_bytes(0),
+      cached_bytes(0),
+      high_water_bytes(0) {}
+
+Pool::Pool(MallocFunc malloc_in, FreeFunc free_in,
+    std::size_t max_cached_bytes_in)
+    : free_blocks(
+          (sizeof(std::size_t) * 8 - min_block_shift()) * pool_subclasses + 1),
+      underlying_malloc(malloc_in),
+      underlying_free(free_in),
+      max_cached_bytes(max_cached_bytes_in) {}
+
+static void trim_locked(Pool& pool, std::size_t max_cached_bytes) {
+  for (std::size_t c = pool.free_blocks.size(); c-- > 0;) {
+    auto& list = pool.free_blocks[c];
+    auto const block_size = class_block_size(c);
+    while (!list.empty() && pool.stats.cached_bytes > max_cached_bytes) {
+      pool.underlying_free(list.back(), block_size);
+      list.pop_back();
+      pool.stats.cached_bytes -= block_size;
+      ++pool.stats.trimmed_blocks;
+    }
   }
-  return total_size;
 }
 
+/* blocks still in use belong to live arrays, which will
+   hand them to the underlying allocator once pooling is disabled */
+Pool::~Pool() { trim_locked(*this, 0); }
+
 void* allocate(Pool& pool, std::size_t size) {
   ScopedTimer timer("pool allocate");
-  std::size_t shift;
-  for (shift = 0; ((std::size_t(1) << shift) < size); ++shift)
-    ;
-  if (!pool.free_blocks[shift].empty()) {
-    auto const data = pool.free_blocks[shift].back();
-    pool.used_blocks[shift].push_back(data);
-    pool.free_blocks[shift].pop_back();
-    return data;
-  }
-  auto const size_to_alloc = (std::size_t(1) << shift);
-  auto data = pool.underlying_malloc(size_to_alloc);
-  if (data == nullptr) {
-    call_underlying_frees(pool, pool.free_blocks);
-    data = pool.underlying_malloc(size_to_alloc);
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  auto const c = size_class(size);
+  auto const block_size = class_block_size(c);
+  auto& list = pool.free_blocks[c];
+  void* data;
+  if (!list.empty()) {
+    data = list.back();
+    list.pop_back();
+    pool.stats.cached_bytes -= block_size;
+    ++pool.stats.hits;
+  } else {
+    ++pool.stats.misses;
+    data = pool.underlying_malloc(block_size);
+    if (data == nullptr) {
+      trim_locked(pool, 0);
+      data = pool.underlying_malloc(block_size);
+    }
+    if (data == nullptr) {
+      Omega_h_fail(
+          "Pool failed to allocate %zu bytes, %zu bytes already allocated\n",
+          block_size, pool.stats.used_bytes);
+    }
   }
-  if (data == nullptr) {
-    Omega_h_fail(
-        "Pool failed to allocate %zu bytes, %zu bytes already allocated\n",
-        size_to_alloc, underlying_total_size(pool));
+  pool.used_blocks.insert(data);
+  pool.stats.requested_bytes += size;
+  pool.stats.used_bytes += block_size;
+  auto const total_bytes = pool.stats.used_bytes + pool.stats.cached_bytes;
+  if (total_bytes > pool.stats.high_water_bytes) {
+    pool.stats.high_water_bytes = total_bytes;
   }
-  pool.used_blocks[shift].push_back(data);
   return data;
 }
 
 void deallocate(Pool& pool, void* data, std::size_t size) {
   ScopedTimer timer("pool deallocate");
-  std::size_t shift;
-  for (shift = 0; ((std::size_t(1) << shift) < size); ++shift)
-    ;
-  auto const end = pool.used_blocks[shift].end();
-  auto const it = std::find_if(pool.used_blocks[shift].begin(), end,
-      [=](VoidPtr b) -> bool { return b == data; });
-  if (it == end) {
-    Omega_h_fail(
-        "Tried to deallocate %p from pool, but pool didn't allocate it\n",
-        data);
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  if (pool.used_blocks.erase(data) == 0) {
+    if (pool.adopted_blocks.erase(data) == 0) {
+      Omega_h_fail(
+          "Tried to deallocate %p from pool, but pool didn't allocate it\n",
+          data);
+    }
+    pool.underlying_free(data, size);
+    return;
   }
-  pool.free_blocks[shift].push_back(*it);
-  pool.used_blocks[shift].erase(it);
+  auto const c = size_class(size);
+  auto const block_size = class_block_size(c);
+  pool.free_blocks[c].push_back(data);
+  pool.stats.requested_bytes -= size;
+  pool.stats.used_bytes -= block_size;
+  pool.stats.cached_bytes += block_size;
+  if (pool.stats.cached_bytes > pool.max_cached_bytes) {
+    trim_locked(pool, pool.max_cached_bytes);
+  }
+}
+
+void trim(Pool& pool, std::size_t max_cached_bytes) {
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  trim_locked(pool, max_cached_bytes);
+}
+
+void adopt_used_blocks(Pool& pool, Pool& old) {
+  std::lock_guard<std::mutex> old_lock(old.mutex);
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.adopted_blocks.insert(old.used_blocks.begin(), old.used_blocks.end());
+  pool.adopted_blocks.insert(
+      old.adopted_blocks.begin(), old.adopted_blocks.end());
+}
+
+PoolStats get_stats(Pool& pool) {
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  return pool.stats;
 }
 }  // namespace Omega_h
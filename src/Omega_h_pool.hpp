@@ -1,7 +1,10 @@
 #ifndef OMEGA_H_POOL_HPP
 #define OMEGA_H_POOL_HPP
 
+#include <cstddef>
 #include <functional>
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 
 namespace Omega_h {
@@ -11,21 +14,65 @@ using BlockList = std::vector<VoidPtr>;
 using MallocFunc = std::function<VoidPtr(std::size_t)>;
 using FreeFunc = std::function<void(VoidPtr, std::size_t)>;
 
+/* A caching allocator: freed blocks are kept in per-size-class lists
+   and handed back out to later requests of the same class.
+   Requests up to pool_min_block bytes share the smallest class,
+   above that every power of two is split into pool_subclasses classes,
+   so at most 1/pool_subclasses of a block is wasted.
+   Cached (free) bytes are capped at max_cached_bytes, beyond which
+   the largest cached blocks are returned to the underlying allocator.
+   Freeing a block the pool did not hand out is an error, except for
+   blocks adopted from a previous pool, which go straight back to the
+   underlying allocator.
+   All operations are guarded by a mutex so they can be called
+   from any host thread. */
+
+constexpr std::size_t pool_min_block = 256;
+constexpr std::size_t pool_subclasses = 4;
+constexpr std::size_t pool_default_max_cached_bytes =
+    std::size_t(1) << 30;
+
+struct PoolStats {
+  std::size_t hits;
+  std::size_t misses;
+  std::size_t trimmed_blocks;
+  std::size_t requested_bytes;
+  std::size_t used_bytes;
+  std::size_t cached_bytes;
+  std::size_t high_water_bytes;
+  PoolStats();
+  std::size_t waste_bytes() const { return used_bytes - requested_bytes; }
+};
+
 struct Pool {
-  Pool(MallocFunc, FreeFunc);
+  Pool(MallocFunc, FreeFunc,
+      std::size_t max_cached_bytes_in = pool_default_max_cached_bytes);
   ~Pool();
   Pool(Pool const&) = delete;
   Pool(Pool&&) = delete;
   Pool& operator=(Pool const&) = delete;
   Pool& operator=(Pool&&) = delete;
-  BlockList used_blocks[64];
-  BlockList free_blocks[64];
+  std::vector<BlockList> free_blocks;
+  std::unordered_set<VoidPtr> used_blocks;
+  std::unordered_set<VoidPtr> adopted_blocks;
   MallocFunc underlying_malloc;
   FreeFunc underlying_free;
+  std::size_t max_cached_bytes;
+  PoolStats stats;
+  std::mutex mutex;
 };
 
+std::size_t pool_block_size(std::size_t size);
+
 void* allocate(Pool&, std::size_t);
 void deallocate(Pool&, void*, std::size_t);
+/* return cached blocks to the underlying allocator,
+   largest first, until at most max_cached_bytes remain cached */
+void trim(Pool&, std::size_t max_cached_bytes = 0);
+/* lets pool free the blocks old still has in use, so that
+   arrays outlive the replacement of one pool by another */
+void adopt_used_blocks(Pool& pool, Pool& old);
+PoolStats get_stats(Pool&);
 }  // namespace Omega_h
 
 #endif
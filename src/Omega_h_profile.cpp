@@ -3,18 +3,40 @@
 #include <Omega_h_comm.hpp>
 #include <Omega_h_dbg.hpp>
 #include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
 #include <algorithm>
 #include <queue>
+#include <sstream>
 #include <limits>
 #include <iomanip>
 #include <map>
+#include <unordered_map>
 #include <utility>
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace Omega_h {
 namespace profile {
 
 OMEGA_H_DLL History* global_singleton_history = nullptr;
+OMEGA_H_DLL Trace* global_singleton_trace = nullptr;
+OMEGA_H_DLL KernelCounters* global_kernel_counters = nullptr;
+
+void add_counts(KernelCounts& into, KernelCounts const& counts) {
+  into.kernels += counts.kernels;
+  into.items += counts.items;
+  into.allocated_bytes += counts.allocated_bytes;
+  into.cycles += counts.cycles;
+  into.instructions += counts.instructions;
+  into.llc_misses += counts.llc_misses;
+}
 
 History::History(CommPtr comm_in, bool dopercent, double chop_in, bool add_filename_in) : 
   current_frame(invalid), last_root(invalid), start_time(now()), 
@@ -131,6 +153,7 @@ History invert(History const& h) {
     q.pop();
     auto self_time = h.time(node);
     auto calls = h.calls(node);
+    auto const counts = h.frames[node].counts;
     for (auto child = h.first(node); child != invalid; child = h.next(child)) {
       self_time -= h.time(child);
       q.push(child);
@@ -143,6 +166,7 @@ History invert(History const& h) {
       inv_node = invh.find_or_create_child_of(inv_node, name);
       invh.frames[inv_node].total_runtime += self_time;
       invh.frames[inv_node].number_of_calls += calls;
+      add_counts(invh.frames[inv_node].counts, counts);
     }
   }
   return invh;
@@ -337,5 +361,283 @@ void print_top_sorted(History const& h_in, double total_runtime) {
   }
 }
 
+struct OpenTraceEvent {
+  std::size_t name_ptr;
+  Now start_time;
+};
+
+/* events are opened and closed by the same thread,
+   so only the finished events need the lock */
+static thread_local std::vector<OpenTraceEvent> open_trace_events;
+static thread_local int trace_thread = -1;
+static std::atomic<int> ntrace_threads(0);
+
+/* each thread remembers where the names it has begun were saved,
+   keyed on the name pointer (almost always a string literal); the
+   copy of the name catches a pointer reused for another name, and
+   a new Trace starts a new generation that drops the stale entries */
+struct CachedTraceName {
+  std::string name;
+  std::size_t name_ptr = invalid;
+};
+static thread_local std::unordered_map<char const*, CachedTraceName>
+    trace_name_cache;
+static thread_local unsigned trace_name_generation = 0;
+static std::atomic<unsigned> ntrace_generations(0);
+
+Trace::Trace(CommPtr comm_in, std::string const& path_in,
+    std::size_t capacity_in)
+    : comm(comm_in),
+      path(path_in),
+      capacity(capacity_in),
+      next_event(0),
+      nrecorded(0),
+      generation(++ntrace_generations) {
+  OMEGA_H_CHECK(capacity > 0);
+  open_trace_events.clear();
+  if (comm) comm->barrier();
+  start_time = now();
+}
+
+void Trace::begin(char const* name) {
+  if (trace_name_generation != generation) {
+    trace_name_cache.clear();
+    trace_name_generation = generation;
+  }
+  auto& cached = trace_name_cache[name];
+  if (cached.name_ptr == invalid || cached.name != name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = name_ptrs.find(name);
+    if (it == name_ptrs.end()) {
+      cached.name_ptr = names.save(name);
+      name_ptrs[name] = cached.name_ptr;
+    } else {
+      cached.name_ptr = it->second;
+    }
+    cached.name = name;
+  }
+  open_trace_events.push_back({cached.name_ptr, now()});
+}
+
+void Trace::end() {
+  auto const end_time = now();
+  /* the trace started inside this scope */
+  if (open_trace_events.empty()) return;
+  auto const open = open_trace_events.back();
+  open_trace_events.pop_back();
+  if (trace_thread == -1) trace_thread = ntrace_threads++;
+  TraceEvent event;
+  event.name_ptr = open.name_ptr;
+  event.thread = trace_thread;
+  event.start = open.start_time - start_time;
+  event.duration = end_time - open.start_time;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (events.size() < capacity) {
+    events.push_back(event);
+  } else {
+    events[next_event] = event;
+  }
+  next_event = (next_event + 1) % capacity;
+  ++nrecorded;
+}
+
+#ifdef __linux__
+static int open_perf_event(std::uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = (group_fd == -1) ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return int(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+
+/* counting is per thread: with OpenMP only the calling thread's
+   share of a kernel is seen */
+KernelCounters::KernelCounters() : allocated_bytes(0), perf_fd(-1) {
+#ifdef __linux__
+  auto const leader = open_perf_event(PERF_COUNT_HW_CPU_CYCLES, -1);
+  if (leader < 0) return;
+  auto const instructions = open_perf_event(PERF_COUNT_HW_INSTRUCTIONS, leader);
+  auto const misses = open_perf_event(PERF_COUNT_HW_CACHE_MISSES, leader);
+  if (instructions < 0 || misses < 0) {
+    if (instructions >= 0) close(instructions);
+    if (misses >= 0) close(misses);
+    close(leader);
+    return;
+  }
+  ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  perf_fd = leader;
+#endif
+}
+
+/* closing the leader releases the whole group */
+KernelCounters::~KernelCounters() {
+#ifdef __linux__
+  if (perf_fd >= 0) close(perf_fd);
+#endif
+}
+
+void KernelCounters::read_hardware(std::uint64_t values[3]) const {
+  values[0] = values[1] = values[2] = 0;
+#ifdef __linux__
+  if (perf_fd < 0) return;
+  std::uint64_t group[4];
+  if (::read(perf_fd, group, sizeof(group)) != ssize_t(sizeof(group))) return;
+  values[0] = group[1];
+  values[1] = group[2];
+  values[2] = group[3];
+#endif
+}
+
+void ScopedKernel::begin(LO n, char const* name) {
+  active = true;
+  opened_frame = (name != nullptr);
+  items = n;
+  if (opened_frame) begin_code(name[0] ? name : "parallel_for");
+  global_kernel_counters->read_hardware(start_values);
+}
+
+void ScopedKernel::end() {
+  std::uint64_t end_values[3];
+  global_kernel_counters->read_hardware(end_values);
+  auto history = global_singleton_history;
+  if (history && history->current_frame != invalid) {
+    auto& counts = history->frames[history->current_frame].counts;
+    counts.kernels += 1;
+    counts.items += std::size_t(items);
+    counts.allocated_bytes +=
+        global_kernel_counters->allocated_bytes.exchange(0);
+    counts.cycles += end_values[0] - start_values[0];
+    counts.instructions += end_values[1] - start_values[1];
+    counts.llc_misses += end_values[2] - start_values[2];
+  } else {
+    global_kernel_counters->allocated_bytes = 0;
+  }
+  if (opened_frame) end_code();
+}
+
+void print_kernel_counts(History const& h) {
+  std::map<std::string, std::pair<double, KernelCounts>> by_name;
+  for (std::size_t frame = 0; frame < h.frames.size(); ++frame) {
+    auto const& counts = h.frames[frame].counts;
+    if (counts.kernels == 0) continue;
+    auto& entry = by_name[h.get_name(frame)];
+    entry.first += h.time(frame);
+    add_counts(entry.second, counts);
+  }
+  using Entry = std::pair<std::string, std::pair<double, KernelCounts>>;
+  std::vector<Entry> sorted(by_name.begin(), by_name.end());
+  std::stable_sort(sorted.begin(), sorted.end(),
+      [](Entry const& a, Entry const& b) {
+        return a.second.first > b.second.first;
+      });
+  auto const hardware =
+      global_kernel_counters && global_kernel_counters->has_hardware();
+  auto coutflags(std::cout.flags());
+  std::cout << "\nKERNELS (time(seconds) kernels Mitems/s alloc_MB alloc_GB/s";
+  if (hardware) std::cout << " IPC LLC_misses/item bound";
+  std::cout << " name):\n";
+  std::cout << "========\n";
+  std::cout << std::setprecision(3);
+  for (auto const& entry : sorted) {
+    auto const time = entry.second.first;
+    auto const& counts = entry.second.second;
+    auto const seconds = std::max(time, 1e-12);
+    std::cout << time << ' ' << counts.kernels << ' '
+              << (Real(counts.items) / seconds / 1e6) << ' '
+              << (Real(counts.allocated_bytes) / 1e6) << ' '
+              << (Real(counts.allocated_bytes) / seconds / 1e9) << ' ';
+    if (hardware) {
+      auto const ipc = Real(counts.instructions) /
+                       Real(std::max(counts.cycles, std::uint64_t(1)));
+      auto const misses = Real(counts.llc_misses) /
+                          Real(std::max(counts.items, std::size_t(1)));
+      /* a few instructions per cycle means the core is kept busy,
+         much less means it mostly waits on memory */
+      std::cout << ipc << ' ' << misses << ' '
+                << (ipc < 1.0 ? "memory" : "compute") << ' ';
+    }
+    std::cout << entry.first << '\n';
+  }
+  std::cout.flags(coutflags);
+}
+
+static void write_json_string(std::ostream& stream, char const* str) {
+  stream << '"';
+  for (; *str; ++str) {
+    auto const c = *str;
+    if (c == '"' || c == '\\') {
+      stream << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      stream << ' ';
+    } else {
+      stream << c;
+    }
+  }
+  stream << '"';
+}
+
+/* this rank's events, each followed by a comma and newline */
+static std::string serialize_trace(Trace& trace, int rank) {
+  std::lock_guard<std::mutex> lock(trace.mutex);
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(3);
+  stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+         << ",\"args\":{\"name\":\"rank " << rank << "\"}},\n";
+  stream << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << rank
+         << ",\"args\":{\"sort_index\":" << rank << "}},\n";
+  std::vector<bool> seen_threads;
+  for (auto const& event : trace.events) {
+    if (std::size_t(event.thread) >= seen_threads.size()) {
+      seen_threads.resize(std::size_t(event.thread) + 1, false);
+    }
+    if (!seen_threads[std::size_t(event.thread)]) {
+      seen_threads[std::size_t(event.thread)] = true;
+      stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank
+             << ",\"tid\":" << event.thread
+             << ",\"args\":{\"name\":\"thread " << event.thread << "\"}},\n";
+    }
+    stream << "{\"name\":";
+    write_json_string(stream, trace.names.get(event.name_ptr));
+    stream << ",\"cat\":\"omega_h\",\"ph\":\"X\",\"ts\":"
+           << (event.start * 1e6) << ",\"dur\":" << (event.duration * 1e6)
+           << ",\"pid\":" << rank << ",\"tid\":" << event.thread << "},\n";
+  }
+  return stream.str();
+}
+
+void write_chrome_trace(Trace& trace, std::string const& path) {
+  auto const rank = trace.comm ? trace.comm->rank() : 0;
+  auto const nranks = trace.comm ? trace.comm->size() : 1;
+  auto ndropped = I64(trace.ndropped());
+  if (trace.comm) ndropped = trace.comm->allreduce(ndropped, OMEGA_H_SUM);
+  auto const local = serialize_trace(trace, rank);
+  if (rank != 0) {
+    trace.comm->send(0, std::vector<char>(local.begin(), local.end()));
+    return;
+  }
+  auto all = local;
+  for (int i = 1; i < nranks; ++i) {
+    std::vector<char> chars;
+    trace.comm->recv(i, chars);
+    all.append(chars.begin(), chars.end());
+  }
+  /* drop the comma after the last event */
+  all.resize(all.size() - 2);
+  std::ofstream file(path.c_str());
+  if (!file.is_open()) {
+    Omega_h_fail("couldn't open trace file \"%s\"\n", path.c_str());
+  }
+  file << "{\"traceEvents\":[\n" << all << "\n],\n"
+       << "\"displayTimeUnit\":\"ms\",\n"
+       << "\"otherData\":{\"dropped_events\":" << ndropped << "}}\n";
+}
+
 }  // namespace profile
 }  // namespace Omega_h
@@ -3,9 +3,14 @@
 
 #include <Omega_h_timer.hpp>
 #include <Omega_h_filesystem.hpp>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
-#include <vector>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #ifdef OMEGA_H_USE_KOKKOS
 #include <Omega_h_kokkos.hpp>
 #endif
@@ -33,6 +38,19 @@ struct Strings {
 
 static constexpr std::size_t invalid = std::numeric_limits<std::size_t>::max();
 
+/* what parallel_for kernels did inside a frame, when kernel counters
+   are enabled. the hardware counts stay zero without perf_event */
+struct KernelCounts {
+  std::size_t kernels;
+  std::size_t items;
+  std::size_t allocated_bytes;
+  std::uint64_t cycles;
+  std::uint64_t instructions;
+  std::uint64_t llc_misses;
+};
+
+void add_counts(KernelCounts& into, KernelCounts const& counts);
+
 struct Frame {
   std::size_t parent;
   std::size_t first_child;
@@ -42,6 +60,7 @@ struct Frame {
   Now start_time;
   double total_runtime;
   std::size_t number_of_calls;
+  KernelCounts counts;
 };
 
 struct History {
@@ -91,6 +110,7 @@ struct History {
     frame.name_ptr = names.save(name);
     frame.total_runtime = 0.0;
     frame.number_of_calls = 0;
+    frame.counts = KernelCounts();
     return index;
   }
   inline std::size_t create_child_of_current(char const* name) {
@@ -121,6 +141,7 @@ struct History {
     frame.name_ptr = names.save(name);
     frame.total_runtime = 0.0;
     frame.number_of_calls = 0;
+    frame.counts = KernelCounts();
     return index;
   }
   inline std::size_t find(char const* name) {
@@ -171,11 +192,97 @@ struct History {
 
 OMEGA_H_DLL extern History* global_singleton_history;
 
+/* event recording for timeline views: every begin_code/end_code pair
+   becomes one complete event (name, thread, start, duration) in a
+   ring buffer that keeps the latest `capacity` events.
+   timestamps count from a barrier over comm in the constructor,
+   which lines the ranks up with each other. */
+struct TraceEvent {
+  std::size_t name_ptr;
+  int thread;
+  double start;
+  double duration;
+};
+
+constexpr std::size_t trace_default_capacity = std::size_t(1) << 20;
+
+struct Trace {
+  CommPtr comm;
+  std::string path;
+  std::size_t capacity;
+  std::vector<TraceEvent> events;
+  std::size_t next_event;
+  std::size_t nrecorded;
+  Strings names;
+  std::map<std::string, std::size_t> name_ptrs;
+  Now start_time;
+  std::mutex mutex;
+  unsigned generation;
+  Trace(CommPtr comm_in, std::string const& path_in = "",
+      std::size_t capacity_in = trace_default_capacity);
+  Trace(Trace const&) = delete;
+  Trace& operator=(Trace const&) = delete;
+  void begin(char const* name);
+  void end();
+  std::size_t ndropped() const { return nrecorded - events.size(); }
+};
+
+OMEGA_H_DLL extern Trace* global_singleton_trace;
+
+/* per-kernel instrumentation of parallel_for, reported through the
+   History: named kernels get their own frame, and every kernel adds
+   its item count, the bytes given to Write<T> since the previous
+   kernel (usually the arrays it fills) and, where Linux perf_event
+   allows it, the cycles, instructions and last-level cache misses
+   of the calling thread to the current frame */
+struct KernelCounters {
+  KernelCounters();
+  ~KernelCounters();
+  KernelCounters(KernelCounters const&) = delete;
+  KernelCounters& operator=(KernelCounters const&) = delete;
+  bool has_hardware() const { return perf_fd >= 0; }
+  /* cycles, instructions, LLC misses */
+  void read_hardware(std::uint64_t values[3]) const;
+  /* atomic because Write<T> may be built off the main thread,
+     e.g. by the thread of binary::write_async */
+  std::atomic<std::size_t> allocated_bytes;
+  int perf_fd;
+};
+
+OMEGA_H_DLL extern KernelCounters* global_kernel_counters;
+
+struct ScopedKernel {
+  /* with a name the kernel opens its own frame, otherwise
+     its counts go to the frame that is current */
+  ScopedKernel(LO n, char const* name = nullptr) : active(false) {
+    if (global_kernel_counters && global_singleton_history) begin(n, name);
+  }
+  ~ScopedKernel() {
+    if (active) end();
+  }
+  ScopedKernel(ScopedKernel const&) = delete;
+  ScopedKernel& operator=(ScopedKernel const&) = delete;
+  void begin(LO n, char const* name);
+  void end();
+  bool active;
+  bool opened_frame;
+  LO items;
+  std::uint64_t start_values[3];
+};
+
 void simple_print(profile::History const& history);
 History invert(History const& h);
 void print_time_sorted(History const& h);
 void print_top_down_and_bottom_up(History const& h, double total_runtime);
 void print_top_sorted(History const& h, double total_runtime);
+/* collective over trace.comm: gathers the events of all ranks
+   (one process per rank, one thread track per host thread)
+   into a Chrome Trace Event file, which Perfetto and
+   chrome://tracing load, written by rank 0 */
+void write_chrome_trace(Trace& trace, std::string const& path);
+/* kernel counts summed by frame name, with throughput and
+   a memory/compute-bound guess for each kernel */
+void print_kernel_counts(History const& h);
 
 }  // namespace profile
 }  // namespace Omega_h
@@ -186,6 +293,9 @@ inline void begin_code(char const* name, char const* file=0) {
 #ifdef OMEGA_H_USE_KOKKOS
   Kokkos::Profiling::pushRegion(name);
 #endif
+  if (profile::global_singleton_trace) {
+    profile::global_singleton_trace->begin(name);
+  }
   if (profile::global_singleton_history) {
     if (file == 0) {
       file = "Omega_h";
@@ -214,6 +324,9 @@ inline void end_code() {
   if (profile::global_singleton_history) {
     profile::global_singleton_history->stop();
   }
+  if (profile::global_singleton_trace) {
+    profile::global_singleton_trace->end();
+  }
 }
 
 struct ScopedTimer {
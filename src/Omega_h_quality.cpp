@@ -19,6 +19,34 @@ Reals measure_qualities_tmpl(Mesh* mesh, LOs a2e, Reals metrics) {
   return qualities;
 }
 
+template <Int mesh_dim, Int metric_dim>
+Reals measure_packed_qualities_tmpl(Mesh* mesh, LOs a2e) {
+  PackedElementQualities<mesh_dim, metric_dim> measurer(mesh);
+  auto na = a2e.size();
+  Write<Real> qualities(na);
+  auto f = OMEGA_H_LAMBDA(LO a) { qualities[a] = measurer.measure(a2e[a]); };
+  parallel_for(na, f, "measure_packed_qualities");
+  return qualities;
+}
+
+static Reals measure_packed_qualities(Mesh* mesh, LOs a2e) {
+  auto metric_dim =
+      get_metrics_dim(mesh->nverts(), mesh->get_array<Real>(VERT, "metric"));
+  if (mesh->dim() == 3 && metric_dim == 3) {
+    return measure_packed_qualities_tmpl<3, 3>(mesh, a2e);
+  }
+  if (mesh->dim() == 2 && metric_dim == 2) {
+    return measure_packed_qualities_tmpl<2, 2>(mesh, a2e);
+  }
+  if (mesh->dim() == 3 && metric_dim == 1) {
+    return measure_packed_qualities_tmpl<3, 1>(mesh, a2e);
+  }
+  if (mesh->dim() == 2 && metric_dim == 1) {
+    return measure_packed_qualities_tmpl<2, 1>(mesh, a2e);
+  }
+  OMEGA_H_NORETURN(Reals());
+}
+
 Reals measure_qualities(Mesh* mesh, LOs a2e, Reals metrics) {
   if (a2e.size() == 0) return Reals({});
   auto metric_dim = get_metrics_dim(mesh->nverts(), metrics);
@@ -41,6 +69,9 @@ Reals measure_qualities(Mesh* mesh, LOs a2e, Reals metrics) {
 }
 
 Reals measure_qualities(Mesh* mesh, LOs a2e) {
+  if (mesh->caches_elem_verts() && mesh->dim() > 1 && a2e.size()) {
+    return measure_packed_qualities(mesh, a2e);
+  }
   return measure_qualities(mesh, a2e, mesh->get_array<Real>(VERT, "metric"));
 }
 
@@ -51,7 +51,26 @@ struct MetricElementQualities {
   }
 };
 
+/* the same measure, reading the per-element copies of the coordinates
+   and the "metric" tag instead of gathering them through the element's
+   vertices */
+template <Int space_dim, Int metric_dim>
+struct PackedElementQualities {
+  Reals elem_coords;
+  Reals elem_metrics;
+  PackedElementQualities(Mesh* mesh)
+      : elem_coords(mesh->ask_elem_coords()),
+        elem_metrics(mesh->ask_elem_metrics()) {}
+  OMEGA_H_DEVICE Real measure(LO e) const {
+    auto p = get_packed_vectors<space_dim + 1, space_dim>(elem_coords, e);
+    auto ms = get_packed_symms<space_dim + 1, metric_dim>(elem_metrics, e);
+    auto m = maxdet_metric(ms);
+    return metric_element_quality(p, m);
+  }
+};
+
 Reals measure_qualities(Mesh* mesh, LOs a2e, Reals metrics);
+/* uses PackedElementQualities when the mesh caches element vertex data */
 Reals measure_qualities(Mesh* mesh, LOs a2e);
 Reals measure_qualities(Mesh* mesh);
 Reals measure_qualities(Mesh* mesh, Reals metrics);
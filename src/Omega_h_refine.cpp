@@ -10,6 +10,7 @@
 #include "Omega_h_profile.hpp"
 #include "Omega_h_refine_qualities.hpp"
 #include "Omega_h_refine_topology.hpp"
+#include "Omega_h_swap.hpp"
 #include "Omega_h_transfer.hpp"
 
 namespace Omega_h {
@@ -26,10 +27,9 @@ static bool refine_ghosted(Mesh* mesh, AdaptOpts const& opts) {
   auto edges_are_initial =
       map_onto(cands_are_good, cands2edges, nedges, I8(0), 1);
   auto edge_quals = map_onto(cand_quals, cands2edges, nedges, 0.0, 1);
-  auto edges_are_keys = find_indset(mesh, EDGE, edge_quals, edges_are_initial);
+  auto edges_are_keys = find_indset(
+      mesh, EDGE, edge_quals, edges_are_initial, opts.indset_engine);
   mesh->add_tag(EDGE, "key", 1, edges_are_keys);
-  mesh->add_tag(EDGE, "rep_vertex2md_order", 1,
-      get_rep2md_order_adapt(mesh, EDGE, VERT, edges_are_keys));
   auto keys2edges = collect_marked(edges_are_keys);
   Graph edges2elems;
   if (mesh->dim() == 1)
@@ -37,6 +37,10 @@ static bool refine_ghosted(Mesh* mesh, AdaptOpts const& opts) {
   else
     edges2elems = mesh->ask_up(EDGE, mesh->dim());
   set_owners_by_indset(mesh, EDGE, keys2edges, edges2elems);
+  /* without ghosts, the line above may have moved the keys */
+  edges_are_keys = mesh->get_array<I8>(EDGE, "key");
+  mesh->add_tag(EDGE, "rep_vertex2md_order", 1,
+      get_rep2md_order_adapt(mesh, EDGE, VERT, edges_are_keys));
   return true;
 }
 
@@ -83,22 +87,170 @@ static void refine_element_based(Mesh* mesh, AdaptOpts const& opts) {
 }
 
 static bool refine(Mesh* mesh, AdaptOpts const& opts) {
-
-  mesh->set_parting(OMEGA_H_GHOSTED);
+  set_cavity_parting(mesh, opts);
   if (!refine_ghosted(mesh, opts)) return false;
   mesh->set_parting(OMEGA_H_ELEM_BASED);
   refine_element_based(mesh, opts);
   return true;
 }
 
-bool refine_by_size(Mesh* mesh, AdaptOpts const& opts) {
-  OMEGA_H_TIME_FUNCTION;
+static bool mark_long_edges(Mesh* mesh, AdaptOpts const& opts) {
   auto comm = mesh->comm();
   auto lengths = mesh->ask_lengths();
   auto edge_is_cand = each_gt(lengths, opts.max_length_desired);
   if (get_max(comm, edge_is_cand) != 1) return false;
   mesh->add_tag(EDGE, "candidate", 1, edge_is_cand);
+  return true;
+}
+
+bool refine_by_size(Mesh* mesh, AdaptOpts const& opts) {
+  OMEGA_H_TIME_FUNCTION;
+  if (!mark_long_edges(mesh, opts)) return false;
   return refine(mesh, opts);
 }
 
+/* splitting an edge and swapping it both replace the elements around it,
+   so one independent set over the edges can choose cavities of both kinds.
+   splits come first (their qualities are offset by one), swaps fill in
+   around them. swaps may not create edges which would need splitting,
+   otherwise swaps, splits and collapses can undo each other forever */
+static bool refine_and_swap_ghosted(Mesh* mesh, AdaptOpts const& opts) {
+  auto comm = mesh->comm();
+  auto edges_are_cands = mesh->get_array<I8>(EDGE, "candidate");
+  mesh->remove_tag(EDGE, "candidate");
+  auto cands2edges = collect_marked(edges_are_cands);
+  auto cand_quals = refine_qualities(mesh, cands2edges);
+  auto cands_are_good = each_geq_to(cand_quals, opts.min_quality_allowed);
+  if (get_max(comm, cands_are_good) != 1) return false;
+  auto nedges = mesh->nedges();
+  auto edges_are_refines =
+      map_onto(cands_are_good, cands2edges, nedges, I8(0), 1);
+  auto edge_quals = Write<Real>(nedges, 0.0);
+  map_into(add_to_each(cand_quals, 1.0), cands2edges, edge_quals, 1);
+  auto edges_are_swaps = Read<I8>(nedges, I8(0));
+  if (get_min(comm, mesh->ask_qualities()) < opts.min_quality_desired) {
+    /* long edges are left to refinement */
+    auto swap_cands = land_each(mark_swap_candidates(mesh, opts),
+        each_eq_to(edges_are_cands, I8(0)));
+    swap_cands = filter_local_cavities(mesh, opts, EDGE, swap_cands);
+    auto swap_opts = opts;
+    swap_opts.max_length_allowed = opts.max_length_desired;
+    auto swaps2edges = LOs();
+    auto swap_quals = Reals();
+    auto swap_configs = Read<I8>();
+    choose_swaps(
+        mesh, swap_opts, swap_cands, &swaps2edges, &swap_quals, &swap_configs);
+    map_into(swap_quals, swaps2edges, edge_quals, 1);
+    edges_are_swaps = mark_image(swaps2edges, nedges);
+    if (mesh->dim() == 3) {
+      mesh->add_tag(EDGE, "config", 1,
+          map_onto(swap_configs, swaps2edges, nedges, I8(-1), 1));
+    }
+  }
+  auto edges_are_keys =
+      find_indset(mesh, EDGE, Reals(edge_quals),
+          lor_each(edges_are_refines, edges_are_swaps), opts.indset_engine);
+  auto edges_are_refine_keys = land_each(edges_are_keys, edges_are_refines);
+  mesh->add_tag(EDGE, "key", 1, edges_are_refine_keys);
+  mesh->add_tag(EDGE, "swap_key", 1, land_each(edges_are_keys, edges_are_swaps));
+  auto keys2edges = collect_marked(edges_are_keys);
+  set_owners_by_indset(
+      mesh, EDGE, keys2edges, mesh->ask_up(EDGE, mesh->dim()));
+  /* without ghosts, the line above may have moved the keys */
+  edges_are_refine_keys = mesh->get_array<I8>(EDGE, "key");
+  mesh->add_tag(EDGE, "rep_vertex2md_order", 1,
+      get_rep2md_order_adapt(mesh, EDGE, VERT, edges_are_refine_keys));
+  return true;
+}
+
+/* the product offsets of the splits followed by those of the swaps */
+static LOs concat_offsets(LOs splits2prods, LOs swaps2prods) {
+  auto swap_offsets = unmap_range(1, swaps2prods.size(), swaps2prods, 1);
+  return concat(splits2prods, add_to_each(swap_offsets, splits2prods.last()));
+}
+
+/* one migration gathers both kinds of cavities, and one rebuild
+   replaces them. since the keys are independent, the products of the
+   splits and those of the swaps can be numbered as the products of
+   one operation whose keys are all the edges, the swapped edges
+   producing no vertices */
+static void refine_and_swap_element_based(Mesh* mesh, AdaptOpts const& opts) {
+  auto comm = mesh->comm();
+  auto splits2edges = collect_marked(mesh->get_array<I8>(EDGE, "key"));
+  auto swaps2edges = collect_marked(mesh->get_array<I8>(EDGE, "swap_key"));
+  mesh->remove_tag(EDGE, "swap_key");
+  auto edge_configs = Read<I8>();
+  if (mesh->has_tag(EDGE, "config")) {
+    edge_configs = mesh->get_array<I8>(EDGE, "config");
+    mesh->remove_tag(EDGE, "config");
+  }
+  auto nsplits = splits2edges.size();
+  if (opts.verbosity >= EACH_REBUILD) {
+    auto ntotal_splits = comm->allreduce(GO(nsplits), OMEGA_H_SUM);
+    auto ntotal_swaps = comm->allreduce(GO(swaps2edges.size()), OMEGA_H_SUM);
+    if (comm->rank() == 0) {
+      std::cout << "refining " << ntotal_splits << " edges and swapping "
+                << ntotal_swaps << " edges\n";
+    }
+  }
+  HostFew<LOs, 4> swaps2prods;
+  HostFew<LOs, 4> swap_prod_verts2verts;
+  swap_topology(mesh, swaps2edges, edge_configs, &swaps2prods,
+      &swap_prod_verts2verts);
+  auto keys2edges = LOs(concat(splits2edges, swaps2edges));
+  auto new_mesh = mesh->copy_meta();
+  auto splits2midverts = LOs();
+  auto old_verts2new_verts = LOs();
+  auto old_lows2new_lows = LOs();
+  for (Int ent_dim = 0; ent_dim <= mesh->dim(); ++ent_dim) {
+    auto splits2prods = LOs();
+    auto split_prod_verts2verts = LOs();
+    auto swap_prod_verts2verts_dim = swap_prod_verts2verts[ent_dim];
+    if (ent_dim == VERT) {
+      splits2prods = LOs(nsplits + 1, 0, 1);
+      split_prod_verts2verts = LOs({});
+    } else {
+      refine_products(mesh, ent_dim, splits2edges, splits2midverts,
+          old_verts2new_verts, splits2prods, split_prod_verts2verts);
+      swap_prod_verts2verts_dim =
+          unmap(swap_prod_verts2verts_dim, old_verts2new_verts, 1);
+    }
+    auto keys2prods = concat_offsets(splits2prods, swaps2prods[ent_dim]);
+    auto prod_verts2verts =
+        concat(split_prod_verts2verts, swap_prod_verts2verts_dim);
+    auto prods2new_ents = LOs();
+    auto same_ents2old_ents = LOs();
+    auto same_ents2new_ents = LOs();
+    auto old_ents2new_ents = LOs();
+    modify_ents_adapt(mesh, &new_mesh, ent_dim, EDGE, keys2edges, keys2prods,
+        prod_verts2verts, old_lows2new_lows, &prods2new_ents,
+        &same_ents2old_ents, &same_ents2new_ents, &old_ents2new_ents);
+    auto nsplit_prods = splits2prods.last();
+    auto split_prods2new_ents = unmap_range(0, nsplit_prods, prods2new_ents, 1);
+    auto swap_prods2new_ents = unmap_range(
+        nsplit_prods, prods2new_ents.size(), prods2new_ents, 1);
+    if (ent_dim == VERT) {
+      splits2midverts = split_prods2new_ents;
+      old_verts2new_verts = old_ents2new_ents;
+    }
+    transfer_refine_and_swap(mesh, opts.xfer_opts, &new_mesh, ent_dim,
+        splits2edges, splits2midverts, splits2prods, split_prods2new_ents,
+        swaps2edges, swaps2prods[ent_dim], swap_prods2new_ents,
+        same_ents2old_ents, same_ents2new_ents);
+    old_lows2new_lows = old_ents2new_ents;
+  }
+  *mesh = new_mesh;
+}
+
+bool refine_and_swap_by_size(Mesh* mesh, AdaptOpts const& opts) {
+  OMEGA_H_TIME_FUNCTION;
+  if (mesh->dim() == 1) return refine_by_size(mesh, opts);
+  if (!mark_long_edges(mesh, opts)) return false;
+  set_cavity_parting(mesh, opts);
+  if (!refine_and_swap_ghosted(mesh, opts)) return false;
+  mesh->set_parting(OMEGA_H_ELEM_BASED);
+  refine_and_swap_element_based(mesh, opts);
+  return true;
+}
+
 }  // end namespace Omega_h
@@ -6,6 +6,10 @@
 namespace Omega_h {
 
 bool refine_by_size(Mesh* mesh, AdaptOpts const& opts);
+/* refine_by_size, also swapping the edges that swap_edges would swap
+   in the same pass and rebuild, as long as their cavities don't
+   overlap those of the split edges */
+bool refine_and_swap_by_size(Mesh* mesh, AdaptOpts const& opts);
 
 }  // end namespace Omega_h
 
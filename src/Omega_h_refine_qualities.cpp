@@ -2,6 +2,7 @@
 
 #include "Omega_h_align.hpp"
 #include "Omega_h_for.hpp"
+#include "Omega_h_map.hpp"
 #include "Omega_h_metric.hpp"
 #include "Omega_h_quality.hpp"
 #include "Omega_h_refine_topology.hpp"
@@ -82,6 +83,12 @@ Reals refine_qualities_tmpl(Mesh* mesh, LOs candidates) {
   };
   parallel_for(ncands, f, "refine_qualities");
   auto cand_quals = Reals(quals_w);
+  if (!mesh->owners_have_all_upward(EDGE)) {
+    /* without ghosts, each copy of an edge sees part of its cavity */
+    auto edge_quals = map_onto(cand_quals, candidates, mesh->nedges(), 1.0, 1);
+    edge_quals = mesh->reduce_array(EDGE, edge_quals, 1, OMEGA_H_MIN);
+    cand_quals = unmap(candidates, edge_quals, 1);
+  }
   return mesh->sync_subset_array(EDGE, cand_quals, candidates, -1.0, 1);
 }
 
@@ -1,5 +1,8 @@
+#include "Omega_h_align.hpp"
 #include "Omega_h_array_ops.hpp"
 #include "Omega_h_element.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_graph.hpp"
 #include "Omega_h_hilbert.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mesh.hpp"
@@ -66,6 +69,108 @@ void reorder_by_hilbert(Mesh* mesh) {
   }
 }
 
+/* orders the entities of dimension ent_dim by the first element,
+   in the new element order, which uses them */
+static LOs ent_order_from_elem_order(
+    Mesh* mesh, Int ent_dim, LOs old_elems2new_elems) {
+  auto const elem_dim = mesh->dim();
+  auto const nents = mesh->nents(ent_dim);
+  auto const deg = element_degree(mesh->family(), elem_dim, ent_dim);
+  auto const ents2elems = mesh->ask_up(ent_dim, elem_dim);
+  auto const a2ab = ents2elems.a2ab;
+  auto const ab2b = ents2elems.ab2b;
+  auto const codes = ents2elems.codes;
+  /* entities no element uses go last, in their current order */
+  auto const unused = GO(mesh->nelems()) * deg;
+  Write<GO> keys(nents);
+  auto f = OMEGA_H_LAMBDA(LO ent) {
+    auto key = unused + ent;
+    for (auto ab = a2ab[ent]; ab < a2ab[ent + 1]; ++ab) {
+      auto const elem = old_elems2new_elems[ab2b[ab]];
+      auto const use = GO(elem) * deg + code_which_down(codes[ab]);
+      if (use < key) key = use;
+    }
+    keys[ent] = key;
+  };
+  parallel_for(nents, f, "ent_order_from_elem_order");
+  return sort_by_keys(GOs(keys));
+}
+
+static void get_elem_first_orders(Mesh* mesh, LOs new_ents2old_ents[]) {
+  auto const dim = mesh->dim();
+  auto const centroids = average_field(
+      mesh, dim, LOs(mesh->nelems(), 0, 1), dim, mesh->coords());
+  new_ents2old_ents[dim] = hilbert::sort_coords(centroids, dim);
+  auto const old_elems2new_elems =
+      invert_permutation(new_ents2old_ents[dim]);
+  for (Int ent_dim = 0; ent_dim < dim; ++ent_dim) {
+    new_ents2old_ents[ent_dim] =
+        ent_order_from_elem_order(mesh, ent_dim, old_elems2new_elems);
+  }
+}
+
+/* the sum over element-vertex uses of the distance between the vertex
+   index and the index the element would have if it were a vertex */
+static Real sum_vert_distances(LOs elems2verts, Int deg, LO nverts) {
+  auto const nelems = divide_no_remainder(elems2verts.size(), deg);
+  if (nelems == 0) return 0.0;
+  auto const scale = Real(nverts) / Real(nelems);
+  Write<Real> distances(nelems);
+  auto f = OMEGA_H_LAMBDA(LO e) {
+    auto const center = Real(e) * scale;
+    Real d = 0.0;
+    for (Int i = 0; i < deg; ++i) {
+      d += std::abs(Real(elems2verts[e * deg + i]) - center);
+    }
+    distances[e] = d;
+  };
+  parallel_for(nelems, f, "sum_vert_distances");
+  return get_sum(Reals(distances));
+}
+
+static Real get_locality(Mesh* mesh, LOs elems2verts) {
+  auto const comm = mesh->comm();
+  auto const deg = element_degree(mesh->family(), mesh->dim(), VERT);
+  auto const sum = comm->allreduce(
+      sum_vert_distances(elems2verts, deg, mesh->nverts()), OMEGA_H_SUM);
+  auto const nuses = comm->allreduce(Real(elems2verts.size()), OMEGA_H_SUM);
+  return (nuses > 0.0) ? (sum / nuses) : 0.0;
+}
+
+Real get_locality(Mesh* mesh) {
+  return get_locality(mesh, mesh->ask_elem_verts());
+}
+
+void reorder_by_elements(Mesh* mesh) {
+  OMEGA_H_TIME_FUNCTION;
+  LOs new_ents2old_ents[4];
+  get_elem_first_orders(mesh, new_ents2old_ents);
+  unmap_mesh(mesh, new_ents2old_ents);
+}
+
+bool reorder_for_locality(Mesh* mesh, Real min_improvement) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const dim = mesh->dim();
+  auto const deg = element_degree(mesh->family(), dim, VERT);
+  LOs new_ents2old_ents[4];
+  get_elem_first_orders(mesh, new_ents2old_ents);
+  auto const ev2v = mesh->ask_elem_verts();
+  auto const new_ev2v =
+      compound_maps(unmap(new_ents2old_ents[dim], ev2v, deg),
+          invert_permutation(new_ents2old_ents[VERT]));
+  auto const before = get_locality(mesh, ev2v);
+  auto const after = get_locality(mesh, new_ev2v);
+  if (!(before > after * min_improvement)) return false;
+  unmap_mesh(mesh, new_ents2old_ents);
+  return true;
+}
+
+void reorder_by_rcm(Mesh* mesh) {
+  OMEGA_H_TIME_FUNCTION;
+  auto const star = mesh->ask_star(VERT);
+  reorder_mesh_by_verts(mesh, reverse_cuthill_mckee(star));
+}
+
 void reorder_by_globals(Mesh* mesh) {
   LOs new_ents2old_ents[4];
   for (Int ent_dim = 0; ent_dim <= mesh->dim(); ++ent_dim) {
@@ -80,7 +80,26 @@ Reals measure_ents_real(Mesh* mesh, Int ent_dim, LOs a2e, Reals coords) {
   OMEGA_H_NORETURN(Reals());
 }
 
+template <Int dim>
+Reals measure_packed_elements_tmpl(Mesh* mesh, LOs a2e) {
+  OMEGA_H_TIME_FUNCTION;
+  auto elem_coords = mesh->ask_elem_coords();
+  auto na = a2e.size();
+  Write<Real> sizes(na);
+  auto f = OMEGA_H_LAMBDA(LO a) {
+    auto p = get_packed_vectors<dim + 1, dim>(elem_coords, a2e[a]);
+    sizes[a] = real_simplex_size<dim, dim>(p);
+  };
+  parallel_for(na, f, "measure_packed_elements");
+  return sizes;
+}
+
 Reals measure_elements_real(Mesh* mesh, LOs a2e) {
+  if (mesh->caches_elem_verts()) {
+    if (mesh->dim() == 3) return measure_packed_elements_tmpl<3>(mesh, a2e);
+    if (mesh->dim() == 2) return measure_packed_elements_tmpl<2>(mesh, a2e);
+    if (mesh->dim() == 1) return measure_packed_elements_tmpl<1>(mesh, a2e);
+  }
   return measure_ents_real(mesh, mesh->dim(), a2e, mesh->coords());
 }
 
@@ -180,6 +180,7 @@ struct RealSimplexSizes {
 };
 
 Reals measure_ents_real(Mesh* mesh, Int ent_dim, LOs a2e, Reals coords);
+/* reads the per-element coordinates when the mesh caches them */
 Reals measure_elements_real(Mesh* mesh, LOs a2e);
 Reals measure_elements_real(Mesh* mesh);
 
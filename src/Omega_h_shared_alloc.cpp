@@ -38,6 +38,7 @@ void stop_tracking_allocations(Library* lib) {
     for (auto& rec : global_allocs->high_water_records) {
       ss << rec.name << ": " << rec.bytes << " bytes.\n";
     }
+    print_pooling_stats(ss);
     auto s = ss.str();
     std::printf("%s\n", s.c_str());
   }
@@ -55,10 +56,23 @@ Alloc::Alloc(std::size_t size_in, std::string&& name_in)
   init();
 }
 
+Alloc::Alloc(std::size_t size_in, std::string const& name_in,
+    void* external_ptr, std::shared_ptr<void> external_owner_in)
+    : size(size_in),
+      name(name_in),
+      ptr(external_ptr),
+      use_count(1),
+      prev(nullptr),
+      next(nullptr),
+      external_owner(std::move(external_owner_in)) {
+  track();
+}
+
 OMEGA_H_DLL Alloc::~Alloc() {
-  ::Omega_h::maybe_pooled_device_free(ptr, size);
+  if (!external_owner) ::Omega_h::maybe_pooled_device_free(ptr, size);
   auto ga = global_allocs;
-  if (ga) {
+  /* allocations made before tracking began are not in the list */
+  if (ga && (prev || next || ga->first == this)) {
     if (next == nullptr) {
       ga->last = prev;
     } else {
@@ -76,6 +90,8 @@ OMEGA_H_DLL Alloc::~Alloc() {
 void Alloc::init() {
   ptr = ::Omega_h::maybe_pooled_device_malloc(size);
   use_count = 1;
+  prev = nullptr;
+  next = nullptr;
   auto ga = global_allocs;
   if (size && (ptr == nullptr)) {
     std::stringstream ss;
@@ -90,6 +106,11 @@ void Alloc::init() {
     auto s = ss.str();
     Omega_h_fail("%s\n", s.c_str());
   }
+  track();
+}
+
+void Alloc::track() {
+  auto ga = global_allocs;
   if (ga) {
     auto old_last = ga->last;
     this->prev = old_last;
@@ -98,8 +119,8 @@ void Alloc::init() {
       old_last->next = this;
     } else {
       ga->first = this;
-      ga->last = this;
     }
+    ga->last = this;
     ga->total_bytes += size;
     if (ga->total_bytes > ga->high_water_bytes) {
       Omega_h::ScopedTimer high_water_timer("high water update");
@@ -124,6 +145,12 @@ SharedAlloc::SharedAlloc(std::size_t size_in, std::string&& name_in) {
 
 SharedAlloc::SharedAlloc(std::size_t size_in) : SharedAlloc(size_in, "") {}
 
+SharedAlloc::SharedAlloc(std::size_t size_in, std::string const& name_in,
+    void* external_ptr, std::shared_ptr<void> external_owner) {
+  alloc = new Alloc(size_in, name_in, external_ptr, std::move(external_owner));
+  direct_ptr = alloc->ptr;
+}
+
 SharedAlloc SharedAlloc::identity(std::size_t size_in) {
   SharedAlloc out;
   out.direct_ptr = nullptr;
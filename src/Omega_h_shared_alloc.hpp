@@ -3,6 +3,7 @@
 
 #include <Omega_h_macros.h>
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -25,14 +26,20 @@ struct Alloc {
   int use_count;
   Alloc* prev;
   Alloc* next;
+  /* when set, ptr is memory owned by something else (e.g. a mapped file)
+     and this keeps that owner alive instead of freeing ptr */
+  std::shared_ptr<void> external_owner;
   Alloc(std::size_t size_in, std::string const& name_in);
   Alloc(std::size_t size_in, std::string&& name_in);
+  Alloc(std::size_t size_in, std::string const& name_in, void* external_ptr,
+      std::shared_ptr<void> external_owner_in);
   OMEGA_H_DLL ~Alloc();
   Alloc(Alloc const&) = delete;
   Alloc(Alloc&&) = delete;
   Alloc& operator=(Alloc const&) = delete;
   Alloc& operator=(Alloc&&) = delete;
   void init();
+  void track();
 };
 
 struct HighWaterRecord {
@@ -55,6 +62,8 @@ struct SharedAlloc {
   SharedAlloc(std::size_t size_in, std::string const& name_in);
   SharedAlloc(std::size_t size_in, std::string&& name_in);
   SharedAlloc(std::size_t size_in);
+  SharedAlloc(std::size_t size_in, std::string const& name_in,
+      void* external_ptr, std::shared_ptr<void> external_owner);
   enum : std::uintptr_t {
     FREE_BIT1 = 0x1,
     FREE_BIT2 = 0x2,
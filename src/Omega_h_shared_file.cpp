@@ -0,0 +1,507 @@
+#include "Omega_h_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "Omega_h_array_ops.hpp"
+#include "Omega_h_build.hpp"
+#include "Omega_h_dist.hpp"
+#include "Omega_h_element.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_globals.hpp"
+#include "Omega_h_linpart.hpp"
+#include "Omega_h_map.hpp"
+#include "Omega_h_mesh.hpp"
+
+namespace Omega_h {
+
+namespace binary {
+
+namespace {
+
+unsigned char const shared_magic[2] = {0xa1, 0x1b};
+
+/* the file starts with the magic number, this version and the number of
+   header bytes. bump the version whenever the layout changes */
+I32 const shared_latest_version = 1;
+
+constexpr I64 shared_prefix_bytes =
+    I64(sizeof(shared_magic) + sizeof(I32) + sizeof(I64));
+
+/* MPI-IO counts are ints, so transfers are split into pieces this big */
+constexpr I64 max_io_piece = I64(1) << 30;
+
+/* one file accessed collectively by all ranks of a communicator,
+   through MPI-IO when Omega_h uses MPI */
+class SharedFile {
+ public:
+  SharedFile(CommPtr comm, filesystem::path const& path, bool writing)
+      : comm_(comm) {
+#ifdef OMEGA_H_USE_MPI
+    int const mode =
+        writing ? (MPI_MODE_CREATE | MPI_MODE_WRONLY) : MPI_MODE_RDONLY;
+    if (MPI_SUCCESS != MPI_File_open(comm->get_impl(), path.c_str(), mode,
+                           MPI_INFO_NULL, &file_)) {
+      Omega_h_fail("could not open file \"%s\"\n", path.c_str());
+    }
+    if (writing) OMEGA_H_CHECK(MPI_SUCCESS == MPI_File_set_size(file_, 0));
+#else
+    auto const mode = writing ? (std::ios::out | std::ios::trunc)
+                              : std::ios::in;
+    file_.open(path.c_str(), mode | std::ios::binary);
+    if (!file_.is_open()) {
+      Omega_h_fail("could not open file \"%s\"\n", path.c_str());
+    }
+#endif
+  }
+  ~SharedFile() {
+#ifdef OMEGA_H_USE_MPI
+    MPI_File_close(&file_);
+#endif
+  }
+  SharedFile(SharedFile const&) = delete;
+  SharedFile& operator=(SharedFile const&) = delete;
+  /* collective: every rank calls these, possibly with nbytes = 0 */
+  void write_at(I64 offset, char const* data, I64 nbytes) {
+    auto const npieces = count_pieces(nbytes);
+    for (I64 i = 0; i < npieces; ++i) {
+      auto const begin = std::min(i * max_io_piece, nbytes);
+      auto const n = std::min(max_io_piece, nbytes - begin);
+#ifdef OMEGA_H_USE_MPI
+      MPI_Status status;
+      OMEGA_H_CHECK(MPI_SUCCESS ==
+                    MPI_File_write_at_all(file_, MPI_Offset(offset + begin),
+                        data + begin, int(n), MPI_BYTE, &status));
+#else
+      if (n == 0) continue;
+      file_.seekp(offset + begin);
+      file_.write(data + begin, n);
+      OMEGA_H_CHECK(file_.good());
+#endif
+    }
+  }
+  void read_at(I64 offset, char* data, I64 nbytes) {
+    auto const npieces = count_pieces(nbytes);
+    for (I64 i = 0; i < npieces; ++i) {
+      auto const begin = std::min(i * max_io_piece, nbytes);
+      auto const n = std::min(max_io_piece, nbytes - begin);
+#ifdef OMEGA_H_USE_MPI
+      MPI_Status status;
+      OMEGA_H_CHECK(MPI_SUCCESS ==
+                    MPI_File_read_at_all(file_, MPI_Offset(offset + begin),
+                        data + begin, int(n), MPI_BYTE, &status));
+      int count;
+      MPI_Get_count(&status, MPI_BYTE, &count);
+      OMEGA_H_CHECK(I64(count) == n);
+#else
+      if (n == 0) continue;
+      file_.seekg(offset + begin);
+      file_.read(data + begin, n);
+      OMEGA_H_CHECK(file_.good());
+#endif
+    }
+  }
+
+ private:
+  I64 count_pieces(I64 nbytes) const {
+    return comm_->allreduce(
+        (nbytes + max_io_piece - 1) / max_io_piece, OMEGA_H_MAX);
+  }
+  CommPtr comm_;
+#ifdef OMEGA_H_USE_MPI
+  MPI_File file_;
+#else
+  std::fstream file_;
+#endif
+};
+
+/* a global array: the values of one tag (or the vertices, for the
+   unnamed array) of every owned entity of a dimension, concatenated
+   in rank order */
+struct SharedArray {
+  std::string name;
+  Int ent_dim;
+  Omega_h_Type type;
+  Int ncomps;
+  I64 offset;
+};
+
+struct SharedHeader {
+  Omega_h_Family family;
+  Int dim;
+  GO nents[4];
+  ClassSets class_sets;
+  std::vector<SharedArray> arrays;
+};
+
+std::string serialize(SharedHeader const& header, bool needs_swapping) {
+  std::ostringstream stream;
+  write_value(stream, I8(header.family), needs_swapping);
+  write_value(stream, I8(header.dim), needs_swapping);
+  for (Int d = 0; d <= header.dim; ++d) {
+    write_value(stream, header.nents[d], needs_swapping);
+  }
+  write_value(stream, I32(header.class_sets.size()), needs_swapping);
+  for (auto& set : header.class_sets) {
+    write(stream, set.first, needs_swapping);
+    write_value(stream, I32(set.second.size()), needs_swapping);
+    for (auto& pair : set.second) {
+      write_value(stream, pair.dim, needs_swapping);
+      write_value(stream, pair.id, needs_swapping);
+    }
+  }
+  write_value(stream, I32(header.arrays.size()), needs_swapping);
+  for (auto& array : header.arrays) {
+    write(stream, array.name, needs_swapping);
+    write_value(stream, I8(array.ent_dim), needs_swapping);
+    write_value(stream, I8(array.type), needs_swapping);
+    write_value(stream, I32(array.ncomps), needs_swapping);
+    write_value(stream, array.offset, needs_swapping);
+  }
+  return stream.str();
+}
+
+SharedHeader deserialize(std::string const& bytes, bool needs_swapping) {
+  std::istringstream stream(bytes);
+  SharedHeader header;
+  I8 family, dim;
+  read_value(stream, family, needs_swapping);
+  read_value(stream, dim, needs_swapping);
+  header.family = Omega_h_Family(family);
+  header.dim = dim;
+  OMEGA_H_CHECK(1 <= header.dim && header.dim <= 3);
+  for (Int d = 0; d <= header.dim; ++d) {
+    read_value(stream, header.nents[d], needs_swapping);
+  }
+  I32 nsets;
+  read_value(stream, nsets, needs_swapping);
+  for (I32 i = 0; i < nsets; ++i) {
+    std::string name;
+    read(stream, name, needs_swapping);
+    I32 npairs;
+    read_value(stream, npairs, needs_swapping);
+    for (I32 j = 0; j < npairs; ++j) {
+      ClassPair pair;
+      read_value(stream, pair.dim, needs_swapping);
+      read_value(stream, pair.id, needs_swapping);
+      header.class_sets[name].push_back(pair);
+    }
+  }
+  I32 narrays;
+  read_value(stream, narrays, needs_swapping);
+  for (I32 i = 0; i < narrays; ++i) {
+    SharedArray array;
+    I8 ent_dim, type;
+    I32 ncomps;
+    read(stream, array.name, needs_swapping);
+    read_value(stream, ent_dim, needs_swapping);
+    read_value(stream, type, needs_swapping);
+    read_value(stream, ncomps, needs_swapping);
+    read_value(stream, array.offset, needs_swapping);
+    array.ent_dim = ent_dim;
+    array.type = Omega_h_Type(type);
+    array.ncomps = ncomps;
+    header.arrays.push_back(array);
+  }
+  OMEGA_H_CHECK(stream.good());
+  return header;
+}
+
+I64 align_up(I64 offset) {
+  auto const alignment = I64(array_alignment);
+  return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+I64 type_size(Omega_h_Type type) {
+  I64 size = 0;
+  apply_to_omega_h_types(type, [&](auto t) { size = I64(sizeof(t)); });
+  return size;
+}
+
+SharedArray const* find_array(
+    SharedHeader const& header, Int ent_dim, std::string const& name) {
+  for (auto& array : header.arrays) {
+    if (array.ent_dim == ent_dim && array.name == name) return &array;
+  }
+  return nullptr;
+}
+
+template <typename T>
+Read<T> read_slice(SharedFile* file, SharedArray const& array, GO begin,
+    GO end, bool needs_swapping) {
+  auto const nvalues = LO((end - begin) * array.ncomps);
+  HostWrite<T> values(nvalues);
+  auto const offset = array.offset + begin * array.ncomps * I64(sizeof(T));
+  file->read_at(offset, reinterpret_cast<char*>(nonnull(values.data())),
+      I64(nvalues) * I64(sizeof(T)));
+  return swap_bytes(Read<T>(values.write()), needs_swapping);
+}
+
+template <typename T>
+void write_slice(SharedFile* file, SharedArray const& array, GO start,
+    LOs owned_ents, Read<T> values, bool needs_swapping) {
+  auto const owned_values = swap_bytes(
+      Read<T>(unmap(owned_ents, values, array.ncomps)), needs_swapping);
+  HostRead<T> host_values(owned_values);
+  auto const value_bytes = I64(array.ncomps) * I64(sizeof(T));
+  file->write_at(array.offset + start * value_bytes,
+      reinterpret_cast<char const*>(nonnull(host_values.data())),
+      I64(host_values.size()) * I64(sizeof(T)));
+}
+
+GOs min_vertices(GOs ev2vg, Int deg) {
+  auto const nents = divide_no_remainder(ev2vg.size(), deg);
+  Write<GO> out(nents);
+  auto f = OMEGA_H_LAMBDA(LO e) {
+    auto m = ev2vg[e * deg];
+    for (Int i = 1; i < deg; ++i) m = min2(m, ev2vg[e * deg + i]);
+    out[e] = m;
+  };
+  parallel_for(nents, std::move(f), "min_vertices");
+  return out;
+}
+
+/* carries per-entity data from a file slice of intermediate-dimension
+   entities onto the matching entities of a freshly built mesh.
+   both sides send their entities to the rank owning the (linearly
+   partitioned) lowest vertex, which pairs them by vertex set */
+struct SliceToMesh {
+  Dist slice2keys;
+  LOs mesh_items2slice_items;
+  Dist keys2mesh;
+  template <typename T>
+  Read<T> exch(Read<T> slice_data, Int ncomps) const {
+    auto const at_keys = slice2keys.exch(slice_data, ncomps);
+    auto const matched =
+        Read<T>(unmap(mesh_items2slice_items, at_keys, ncomps));
+    return keys2mesh.exch(matched, ncomps);
+  }
+};
+
+SliceToMesh match_slice_to_mesh(
+    Mesh* mesh, Int ent_dim, GOs slice_ev2vg, GO nglobal_verts) {
+  auto const comm = mesh->comm();
+  auto const deg = element_degree(mesh->family(), ent_dim, VERT);
+  auto const mesh_ev2vg =
+      Read<GO>(unmap(mesh->ask_verts_of(ent_dim), mesh->globals(VERT), 1));
+  auto const nkeys = linear_partition_size(comm, nglobal_verts);
+  SliceToMesh out;
+  out.slice2keys = Dist(comm,
+      globals_to_linear_owners(
+          comm, min_vertices(slice_ev2vg, deg), nglobal_verts),
+      nkeys);
+  auto const mesh2keys = Dist(comm,
+      globals_to_linear_owners(
+          comm, min_vertices(mesh_ev2vg, deg), nglobal_verts),
+      nkeys);
+  /* sort each entity's vertices once so candidates compare directly */
+  auto sorted_verts = [&](Read<GO> ev2vg) {
+    HostWrite<GO> verts(ev2vg.size());
+    HostRead<GO> unsorted(ev2vg);
+    for (LO i = 0; i < verts.size(); ++i) verts[i] = unsorted[i];
+    for (LO item = 0; item < verts.size() / deg; ++item) {
+      std::sort(verts.data() + item * deg, verts.data() + (item + 1) * deg);
+    }
+    return verts;
+  };
+  auto const slice_items_verts =
+      sorted_verts(out.slice2keys.exch(slice_ev2vg, deg));
+  auto const mesh_items_verts = sorted_verts(mesh2keys.exch(mesh_ev2vg, deg));
+  auto const keys2slice = out.slice2keys.invert();
+  auto const keys2mesh = mesh2keys.invert();
+  auto const keys2slice_items = HostRead<LO>(keys2slice.roots2items());
+  auto const keys2mesh_items = HostRead<LO>(keys2mesh.roots2items());
+  HostWrite<LO> matches(mesh_items_verts.size() / deg);
+  for (LO key = 0; key < nkeys; ++key) {
+    for (auto m = keys2mesh_items[key]; m < keys2mesh_items[key + 1]; ++m) {
+      auto const mesh_verts = mesh_items_verts.data() + m * deg;
+      LO match = -1;
+      for (auto s = keys2slice_items[key]; s < keys2slice_items[key + 1];
+           ++s) {
+        if (std::equal(mesh_verts, mesh_verts + deg,
+                slice_items_verts.data() + s * deg)) {
+          match = s;
+          break;
+        }
+      }
+      if (match == -1) {
+        Omega_h_fail("shared .osh file has no %s matching one in the mesh\n",
+            topological_singular_name(mesh->family(), ent_dim));
+      }
+      matches[m] = match;
+    }
+  }
+  out.mesh_items2slice_items = matches.write();
+  out.keys2mesh = Dist(comm, keys2mesh.items2dests(), mesh->nents(ent_dim));
+  return out;
+}
+
+}  // end anonymous namespace
+
+void write_shared(filesystem::path const& path, Mesh* mesh) {
+  ScopedTimer timer("binary::write_shared(path, mesh)");
+  auto const comm = mesh->comm();
+  auto const dim = mesh->dim();
+  bool const needs_swapping = !is_little_endian_cpu();
+  SharedHeader header;
+  header.family = mesh->family();
+  header.dim = dim;
+  header.class_sets = mesh->class_sets;
+  LOs owned_ents[4];
+  GO starts[4];
+  for (Int d = 0; d <= dim; ++d) {
+    owned_ents[d] = collect_marked(mesh->owned(d));
+    auto const nowned = GO(owned_ents[d].size());
+    header.nents[d] = comm->allreduce(nowned, OMEGA_H_SUM);
+    starts[d] = comm->exscan(nowned, OMEGA_H_SUM);
+  }
+  /* vertices are renumbered by owner rank so that each rank's owned
+     entities form one contiguous range of every global array */
+  auto vert_globals = rescan_globals(mesh, mesh->owned(VERT));
+  vert_globals = mesh->sync_array(VERT, vert_globals, 1);
+  for (Int d = 0; d <= dim; ++d) {
+    bool has_tags = false;
+    for (Int i = 0; i < mesh->ntags(d); ++i) {
+      auto const tag = mesh->get_tag(d, i);
+      if (tag->name() == "global") continue;
+      header.arrays.push_back({tag->name(), d, tag->type(), tag->ncomps(), 0});
+      has_tags = true;
+    }
+    if (d == dim || (d > VERT && has_tags)) {
+      auto const deg = element_degree(mesh->family(), d, VERT);
+      header.arrays.push_back({"", d, OMEGA_H_I64, deg, 0});
+    }
+  }
+  auto const header_bytes = I64(serialize(header, needs_swapping).size());
+  auto offset = align_up(shared_prefix_bytes + header_bytes);
+  for (auto& array : header.arrays) {
+    array.offset = offset;
+    offset = align_up(offset + header.nents[array.ent_dim] * array.ncomps *
+                                   type_size(array.type));
+  }
+  SharedFile file(comm, path, true);
+  {
+    std::ostringstream stream;
+    stream.write(reinterpret_cast<char const*>(shared_magic),
+        sizeof(shared_magic));
+    write_value(stream, shared_latest_version, needs_swapping);
+    write_value(stream, header_bytes, needs_swapping);
+    stream << serialize(header, needs_swapping);
+    auto const bytes = stream.str();
+    auto const nbytes = (comm->rank() == 0) ? I64(bytes.size()) : I64(0);
+    file.write_at(0, bytes.data(), nbytes);
+  }
+  for (auto& array : header.arrays) {
+    auto const d = array.ent_dim;
+    if (array.name.empty()) {
+      auto const ev2vg = GOs(unmap(mesh->ask_verts_of(d), vert_globals, 1));
+      write_slice(&file, array, starts[d], owned_ents[d], ev2vg,
+          needs_swapping);
+      continue;
+    }
+    auto f = [&](auto t) {
+      using T = decltype(t);
+      write_slice(&file, array, starts[d], owned_ents[d],
+          mesh->get_array<T>(d, array.name), needs_swapping);
+    };
+    apply_to_omega_h_types(array.type, std::move(f));
+  }
+}
+
+Mesh read_shared(filesystem::path const& path, CommPtr comm) {
+  ScopedTimer timer("binary::read_shared(path, comm)");
+  bool const needs_swapping = !is_little_endian_cpu();
+  SharedFile file(comm, path, false);
+  I64 header_bytes;
+  {
+    char prefix[shared_prefix_bytes];
+    file.read_at(0, prefix, shared_prefix_bytes);
+    if (std::memcmp(prefix, shared_magic, sizeof(shared_magic)) != 0) {
+      Omega_h_fail("\"%s\" is not a shared .osh file\n", path.c_str());
+    }
+    I32 version;
+    std::memcpy(&version, prefix + sizeof(shared_magic), sizeof(I32));
+    if (needs_swapping) swap_bytes(version);
+    if (version < 1 || version > shared_latest_version) {
+      Omega_h_fail("shared .osh file \"%s\" has version %d, "
+                   "this Omega_h reads versions up to %d\n",
+          path.c_str(), version, shared_latest_version);
+    }
+    std::memcpy(&header_bytes, prefix + sizeof(shared_magic) + sizeof(I32),
+        sizeof(I64));
+    if (needs_swapping) swap_bytes(header_bytes);
+  }
+  std::string bytes(std::size_t(header_bytes), '\0');
+  file.read_at(shared_prefix_bytes, &bytes[0], header_bytes);
+  auto const header = deserialize(bytes, needs_swapping);
+  auto const family = header.family;
+  auto const dim = header.dim;
+  GO elems_begin, elems_end, verts_begin, verts_end;
+  suggest_slices(
+      header.nents[dim], comm->size(), comm->rank(), &elems_begin, &elems_end);
+  suggest_slices(
+      header.nents[VERT], comm->size(), comm->rank(), &verts_begin, &verts_end);
+  auto const conn_array = find_array(header, dim, "");
+  auto const coords_array = find_array(header, VERT, "coordinates");
+  OMEGA_H_CHECK(conn_array != nullptr);
+  if (coords_array == nullptr) {
+    Omega_h_fail("shared .osh file \"%s\" has no coordinates\n", path.c_str());
+  }
+  auto const slice_conn = read_slice<GO>(
+      &file, *conn_array, elems_begin, elems_end, needs_swapping);
+  auto const slice_coords = read_slice<Real>(
+      &file, *coords_array, verts_begin, verts_end, needs_swapping);
+  Dist slice_elems2elems;
+  Dist slice_verts2verts;
+  LOs conn;
+  assemble_slices(comm, family, dim, header.nents[dim], elems_begin,
+      slice_conn, header.nents[VERT], verts_begin, slice_coords,
+      &slice_elems2elems, &conn, &slice_verts2verts);
+  auto const nslice_verts = LO(verts_end - verts_begin);
+  auto const slice_vert_globals =
+      GOs{nslice_verts, verts_begin, 1, "slice vert globals"};
+  auto const vert_globals = slice_verts2verts.exch(slice_vert_globals, 1);
+  Mesh mesh(comm->library());
+  build_from_elems2verts(&mesh, comm, family, dim, conn, vert_globals);
+  for (Int d = 0; d <= dim; ++d) {
+    GO begin, end;
+    suggest_slices(header.nents[d], comm->size(), comm->rank(), &begin, &end);
+    SliceToMesh slice2mesh;
+    bool matched = false;
+    for (auto& array : header.arrays) {
+      if (array.ent_dim != d || array.name.empty()) continue;
+      if (d > VERT && d < dim && !matched) {
+        auto const ents_array = find_array(header, d, "");
+        OMEGA_H_CHECK(ents_array != nullptr);
+        auto const slice_ev2vg = read_slice<GO>(
+            &file, *ents_array, begin, end, needs_swapping);
+        slice2mesh =
+            match_slice_to_mesh(&mesh, d, slice_ev2vg, header.nents[VERT]);
+        matched = true;
+      }
+      auto f = [&](auto t) {
+        using T = decltype(t);
+        auto const slice_values =
+            read_slice<T>(&file, array, begin, end, needs_swapping);
+        Read<T> values;
+        if (d == VERT) {
+          values = slice_verts2verts.exch(slice_values, array.ncomps);
+        } else if (d == dim) {
+          values = slice_elems2elems.exch(slice_values, array.ncomps);
+        } else {
+          values = slice2mesh.exch(slice_values, array.ncomps);
+        }
+        mesh.add_tag(d, array.name, array.ncomps, values, true);
+      };
+      apply_to_omega_h_types(array.type, std::move(f));
+    }
+  }
+  mesh.class_sets = header.class_sets;
+  return mesh;
+}
+
+}  // end namespace binary
+
+}  // end namespace Omega_h
@@ -9,6 +9,9 @@
 #include <Omega_h_sort.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #if defined(OMEGA_H_USE_CUDA) || defined(OMEGA_H_USE_HIP)
@@ -94,7 +97,7 @@ static LOs sort_by_keys_tmpl(Read<T> keys) {
 }
 
 template <typename T>
-LOs sort_by_keys(Read<T> keys, Int width) {
+LOs comparison_sort_by_keys(Read<T> keys, Int width) {
   if (width == 1) return sort_by_keys_tmpl<1>(keys);
   if (width == 2) return sort_by_keys_tmpl<2>(keys);
   if (width == 3) return sort_by_keys_tmpl<3>(keys);
@@ -102,7 +105,152 @@ LOs sort_by_keys(Read<T> keys, Int width) {
   OMEGA_H_NORETURN(LOs());
 }
 
-#define INST(T) template LOs sort_by_keys(Read<T> keys, Int width);
+/* least-significant-digit radix sort of (packed key, index) pairs.
+   each pass is a stable counting sort on one 8-bit digit.
+   with OpenMP, every thread histograms a contiguous block,
+   and the offsets are scanned digit-major, thread-minor
+   so that the scatter stays stable. */
+
+constexpr Int radix_bits = 8;
+constexpr LO radix_size = LO(1) << radix_bits;
+
+template <typename U>
+static void radix_pass(std::vector<std::pair<U, LO>> const& in,
+    std::vector<std::pair<U, LO>>& out, Int shift) {
+  auto const n = LO(in.size());
+#if defined(OMEGA_H_USE_OPENMP)
+  LO const nthreads = LO(omp_get_max_threads());
+#else
+  LO const nthreads = 1;
+#endif
+  auto const chunk = (n + nthreads - 1) / nthreads;
+  std::vector<LO> offsets(std::size_t(nthreads * radix_size), 0);
+#if defined(OMEGA_H_USE_OPENMP)
+#pragma omp parallel for
+#endif
+  for (LO t = 0; t < nthreads; ++t) {
+    auto const counts = offsets.data() + t * radix_size;
+    auto const end = min2(n, (t + 1) * chunk);
+    for (LO j = t * chunk; j < end; ++j) {
+      ++counts[LO((in[std::size_t(j)].first >> shift) & U(radix_size - 1))];
+    }
+  }
+  LO sum = 0;
+  for (LO d = 0; d < radix_size; ++d) {
+    for (LO t = 0; t < nthreads; ++t) {
+      auto& offset = offsets[std::size_t(t * radix_size + d)];
+      auto const count = offset;
+      offset = sum;
+      sum += count;
+    }
+  }
+#if defined(OMEGA_H_USE_OPENMP)
+#pragma omp parallel for
+#endif
+  for (LO t = 0; t < nthreads; ++t) {
+    auto const next = offsets.data() + t * radix_size;
+    auto const end = min2(n, (t + 1) * chunk);
+    for (LO j = t * chunk; j < end; ++j) {
+      auto const& item = in[std::size_t(j)];
+      auto const d = LO((item.first >> shift) & U(radix_size - 1));
+      out[std::size_t(next[d]++)] = item;
+    }
+  }
+}
+
+template <Int N, typename T>
+static LOs radix_sort_by_keys_tmpl(Read<T> keys) {
+  begin_code("radix_sort_by_keys");
+  using U = typename std::make_unsigned<T>::type;
+  using Item = std::pair<std::uint64_t, LO>;
+  auto const n = divide_no_remainder(keys.size(), N);
+  HostRead<T> h_keys(keys);
+  HostWrite<LO> h_perm(n, 0, 1);
+  if (n == 0) {
+    end_code();
+    return h_perm.write();
+  }
+  /* each integer of the tuple only needs as many bits as its range,
+     and is offset by its minimum so signed types work too */
+  T lo[N];
+  Int nbits[N];
+  for (Int i = 0; i < N; ++i) {
+    lo[i] = h_keys[i];
+    T hi = h_keys[i];
+    for (LO j = 1; j < n; ++j) {
+      lo[i] = min2(lo[i], h_keys[j * N + i]);
+      hi = max2(hi, h_keys[j * N + i]);
+    }
+    auto const range = U(U(hi) - U(lo[i]));
+    nbits[i] = 0;
+    while (nbits[i] < Int(sizeof(U) * 8) && (range >> nbits[i]) != 0) {
+      ++nbits[i];
+    }
+  }
+  std::vector<Item> items(static_cast<std::size_t>(n));
+  std::vector<Item> scratch(static_cast<std::size_t>(n));
+  /* pack as many trailing integers of the tuple as fit into one
+     64-bit digit string and sort by those first, which stability
+     turns into lexical order once the leading integers are sorted */
+  for (Int last = N - 1; last >= 0;) {
+    Int first = last;
+    Int total_bits = nbits[last];
+    while (first > 0 && total_bits + nbits[first - 1] <= 64) {
+      --first;
+      total_bits += nbits[first];
+    }
+    if (total_bits > 0) {
+#if defined(OMEGA_H_USE_OPENMP)
+#pragma omp parallel for
+#endif
+      for (LO j = 0; j < n; ++j) {
+        auto const old = h_perm[j];
+        std::uint64_t packed = 0;
+        for (Int i = first; i <= last; ++i) {
+          auto const bits = std::uint64_t(U(U(h_keys[old * N + i]) - U(lo[i])));
+          packed = (nbits[i] == 64) ? bits : ((packed << nbits[i]) | bits);
+        }
+        items[std::size_t(j)] = Item(packed, old);
+      }
+      for (Int shift = 0; shift < total_bits; shift += radix_bits) {
+        radix_pass(items, scratch, shift);
+        std::swap(items, scratch);
+      }
+#if defined(OMEGA_H_USE_OPENMP)
+#pragma omp parallel for
+#endif
+      for (LO j = 0; j < n; ++j) h_perm[j] = items[std::size_t(j)].second;
+    }
+    last = first - 1;
+  }
+  end_code();
+  return h_perm.write();
+}
+
+template <typename T>
+LOs radix_sort_by_keys(Read<T> keys, Int width) {
+  if (width == 1) return radix_sort_by_keys_tmpl<1>(keys);
+  if (width == 2) return radix_sort_by_keys_tmpl<2>(keys);
+  if (width == 3) return radix_sort_by_keys_tmpl<3>(keys);
+  if (width == 4) return radix_sort_by_keys_tmpl<4>(keys);
+  OMEGA_H_NORETURN(LOs());
+}
+
+template <typename T>
+LOs sort_by_keys(Read<T> keys, Int width) {
+#if !(defined(OMEGA_H_USE_CUDA) || defined(OMEGA_H_USE_HIP) ||                \
+      defined(OMEGA_H_USE_SYCL))
+  if (keys.size() >= radix_sort_min_size * width) {
+    return radix_sort_by_keys(keys, width);
+  }
+#endif
+  return comparison_sort_by_keys(keys, width);
+}
+
+#define INST(T)                                                                \
+  template LOs sort_by_keys(Read<T> keys, Int width);                          \
+  template LOs comparison_sort_by_keys(Read<T> keys, Int width);               \
+  template LOs radix_sort_by_keys(Read<T> keys, Int width);
 INST(LO)
 INST(GO)
 #undef INST
@@ -7,7 +7,7 @@ namespace Omega_h {
 
 /* Compute the permutation which sorts the given keys.
    Each key is a tuple of N integers of type T.
-   T may be 32 or 64 bits, and N may be 1, 2, or 3.
+   T may be 32 or 64 bits, and N may be 1, 2, 3, or 4.
    Let perm = sort_by_keys(keys, width);
    Then the key at perm[i] is <= the key at perm[i + 1].
    In other words, old_key_index = perm[new_key_index]
@@ -21,8 +21,25 @@ namespace Omega_h {
 template <typename T>
 LOs sort_by_keys(Read<T> keys, Int width = 1);
 
+/* The two engines behind sort_by_keys, which produce identical results.
+   comparison_sort_by_keys is a stable comparison sort (thrust on GPUs,
+   a parallel merge sort with OpenMP, std::stable_sort otherwise).
+   radix_sort_by_keys is a least-significant-digit radix sort of
+   (key, index) pairs which only makes as many passes as the range of
+   each tuple entry requires. It runs on the host, so on GPU builds the
+   keys are mirrored. On host builds, sort_by_keys uses it once there are
+   at least radix_sort_min_size keys. */
+template <typename T>
+LOs comparison_sort_by_keys(Read<T> keys, Int width = 1);
+template <typename T>
+LOs radix_sort_by_keys(Read<T> keys, Int width = 1);
+
+constexpr LO radix_sort_min_size = 4096;
+
 #define OMEGA_H_INST_DECL(T)                                                   \
-  extern template LOs sort_by_keys(Read<T> keys, Int width);
+  extern template LOs sort_by_keys(Read<T> keys, Int width);                   \
+  extern template LOs comparison_sort_by_keys(Read<T> keys, Int width);        \
+  extern template LOs radix_sort_by_keys(Read<T> keys, Int width);
 OMEGA_H_INST_DECL(LO)
 OMEGA_H_INST_DECL(GO)
 #undef OMEGA_H_INST_DECL
@@ -1,26 +1,34 @@
 #include "Omega_h_swap.hpp"
 
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_indset.hpp"
 #include "Omega_h_map.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_modify.hpp"
 #include "Omega_h_profile.hpp"
 #include "Omega_h_swap2d.hpp"
 #include "Omega_h_swap3d.hpp"
+#include "Omega_h_transfer.hpp"
 
 #include <iostream>
 
 namespace Omega_h {
 
-bool swap_part1(Mesh* mesh, AdaptOpts const& opts) {
-  mesh->set_parting(OMEGA_H_GHOSTED);
-  auto comm = mesh->comm();
+Read<I8> mark_swap_candidates(Mesh* mesh, AdaptOpts const& opts) {
   auto elems_are_cands =
       mark_sliver_layers(mesh, opts.min_quality_desired, opts.nsliver_layers);
-  OMEGA_H_CHECK(get_max(comm, elems_are_cands) == 1);
+  OMEGA_H_CHECK(get_max(mesh->comm(), elems_are_cands) == 1);
   auto edges_are_cands = mark_down(mesh, mesh->dim(), EDGE, elems_are_cands);
   /* only swap interior edges */
   auto edges_are_inter = mark_by_class_dim(mesh, EDGE, mesh->dim());
-  edges_are_cands = land_each(edges_are_cands, edges_are_inter);
+  return land_each(edges_are_cands, edges_are_inter);
+}
+
+bool swap_part1(Mesh* mesh, AdaptOpts const& opts) {
+  set_cavity_parting(mesh, opts);
+  auto comm = mesh->comm();
+  auto edges_are_cands = mark_swap_candidates(mesh, opts);
+  edges_are_cands = filter_local_cavities(mesh, opts, EDGE, edges_are_cands);
   if (get_max(comm, edges_are_cands) <= 0) return false;
   mesh->add_tag(EDGE, "candidate", 1, edges_are_cands);
   return true;
@@ -33,7 +41,7 @@ void filter_swap(Read<I8> keep_cands, LOs* cands2edges, Reals* cand_quals) {
 }
 
 Read<I8> filter_swap_improve(Mesh* mesh, LOs cands2edges, Reals cand_quals) {
-  OMEGA_H_CHECK(mesh->owners_have_all_upward(EDGE));
+  OMEGA_H_CHECK(mesh->parting() != OMEGA_H_VERT_BASED);
   auto elem_quals = mesh->ask_qualities();
   auto edges2elems = mesh->ask_up(EDGE, mesh->dim());
   auto edge_old_quals = graph_reduce(edges2elems, elem_quals, 1, OMEGA_H_MIN);
@@ -42,14 +50,126 @@ Read<I8> filter_swap_improve(Mesh* mesh, LOs cands2edges, Reals cand_quals) {
   return gt_each(cand_quals, cand_old_quals);
 }
 
+void choose_swaps(Mesh* mesh, AdaptOpts const& opts, Read<I8> edges_are_cands,
+    LOs* p_cands2edges, Reals* p_cand_quals, Read<I8>* p_cand_configs) {
+  auto cands2edges = collect_marked(edges_are_cands);
+  auto cand_quals = Reals();
+  auto cand_configs = Read<I8>();
+  if (mesh->dim() == 3) {
+    swap3d_qualities(mesh, opts, cands2edges, &cand_quals, &cand_configs);
+  } else {
+    cand_quals = swap2d_qualities(mesh, opts, cands2edges);
+  }
+  auto keep_cands = filter_swap_improve(mesh, cands2edges, cand_quals);
+  if (mesh->dim() == 3) {
+    *p_cand_configs = unmap(collect_marked(keep_cands), cand_configs, 1);
+  }
+  filter_swap(keep_cands, &cands2edges, &cand_quals);
+  *p_cands2edges = cands2edges;
+  *p_cand_quals = cand_quals;
+}
+
+void swap_topology(Mesh* mesh, LOs keys2edges, Read<I8> edge_configs,
+    HostFew<LOs, 4>* keys2prods_out, HostFew<LOs, 4>* prod_verts2verts_out) {
+  HostFew<LOs, 4> keys2prods;
+  HostFew<LOs, 4> prod_verts2verts;
+  if (mesh->dim() == 3) {
+    keys2prods = swap3d_keys_to_prods(mesh, keys2edges);
+    prod_verts2verts =
+        swap3d_topology(mesh, keys2edges, edge_configs, keys2prods);
+  } else {
+    HostFew<LOs, 3> keys2prods_2d;
+    HostFew<LOs, 3> prod_verts2verts_2d;
+    swap2d_topology(mesh, keys2edges, &keys2prods_2d, &prod_verts2verts_2d);
+    for (Int prod_dim = EDGE; prod_dim <= FACE; ++prod_dim) {
+      keys2prods[prod_dim] = keys2prods_2d[prod_dim];
+      prod_verts2verts[prod_dim] = prod_verts2verts_2d[prod_dim];
+    }
+  }
+  keys2prods[VERT] = LOs(keys2edges.size() + 1, 0);
+  prod_verts2verts[VERT] = LOs({});
+  *keys2prods_out = keys2prods;
+  *prod_verts2verts_out = prod_verts2verts;
+}
+
+static bool swap_ghosted(Mesh* mesh, AdaptOpts const& opts) {
+  auto comm = mesh->comm();
+  auto edges_are_cands = mesh->get_array<I8>(EDGE, "candidate");
+  mesh->remove_tag(EDGE, "candidate");
+  auto cands2edges = LOs();
+  auto cand_quals = Reals();
+  auto cand_configs = Read<I8>();
+  choose_swaps(
+      mesh, opts, edges_are_cands, &cands2edges, &cand_quals, &cand_configs);
+  /* cavity quality checks */
+  if (comm->reduce_and(cands2edges.size() == 0)) return false;
+  auto nedges = mesh->nedges();
+  edges_are_cands = mark_image(cands2edges, nedges);
+  auto edge_quals = map_onto(cand_quals, cands2edges, nedges, -1.0, 1);
+  auto edges_are_keys = find_indset(
+      mesh, EDGE, edge_quals, edges_are_cands, opts.indset_engine);
+  mesh->add_tag(EDGE, "key", 1, edges_are_keys);
+  if (mesh->dim() == 3) {
+    mesh->add_tag(EDGE, "config", 1,
+        map_onto(cand_configs, cands2edges, nedges, I8(-1), 1));
+  }
+  auto keys2edges = collect_marked(edges_are_keys);
+  set_owners_by_indset(
+      mesh, EDGE, keys2edges, mesh->ask_up(EDGE, mesh->dim()));
+  return true;
+}
+
+static void swap_element_based(Mesh* mesh, AdaptOpts const& opts) {
+  auto comm = mesh->comm();
+  auto edges_are_keys = mesh->get_array<I8>(EDGE, "key");
+  mesh->remove_tag(EDGE, "key");
+  auto edge_configs = Read<I8>();
+  if (mesh->dim() == 3) {
+    edge_configs = mesh->get_array<I8>(EDGE, "config");
+    mesh->remove_tag(EDGE, "config");
+  }
+  auto keys2edges = collect_marked(edges_are_keys);
+  if (opts.verbosity >= EACH_REBUILD) {
+    auto nkeys = keys2edges.size();
+    auto ntotal_keys = comm->allreduce(GO(nkeys), OMEGA_H_SUM);
+    if (comm->rank() == 0) {
+      std::cout << "swapping " << ntotal_keys << " " << mesh->dim()
+                << "D edges\n";
+    }
+  }
+  auto new_mesh = mesh->copy_meta();
+  new_mesh.set_verts(mesh->nverts());
+  new_mesh.set_owners(VERT, mesh->ask_owners(VERT));
+  transfer_copy(mesh, opts.xfer_opts, &new_mesh, VERT);
+  HostFew<LOs, 4> keys2prods;
+  HostFew<LOs, 4> prod_verts2verts;
+  swap_topology(mesh, keys2edges, edge_configs, &keys2prods, &prod_verts2verts);
+  auto old_lows2new_lows = LOs(mesh->nverts(), 0, 1);
+  for (Int ent_dim = EDGE; ent_dim <= mesh->dim(); ++ent_dim) {
+    auto prods2new_ents = LOs();
+    auto same_ents2old_ents = LOs();
+    auto same_ents2new_ents = LOs();
+    auto old_ents2new_ents = LOs();
+    modify_ents_adapt(mesh, &new_mesh, ent_dim, EDGE, keys2edges,
+        keys2prods[ent_dim], prod_verts2verts[ent_dim], old_lows2new_lows,
+        &prods2new_ents, &same_ents2old_ents, &same_ents2new_ents,
+        &old_ents2new_ents);
+    transfer_swap(mesh, opts.xfer_opts, &new_mesh, ent_dim, keys2edges,
+        keys2prods[ent_dim], prods2new_ents, same_ents2old_ents,
+        same_ents2new_ents);
+    old_lows2new_lows = old_ents2new_ents;
+  }
+  *mesh = new_mesh;
+}
+
 bool swap_edges(Mesh* mesh, AdaptOpts const& opts) {
   OMEGA_H_TIME_FUNCTION;
-  bool ret = false;
-  if (mesh->dim() == 3)
-    ret = swap_edges_3d(mesh, opts);
-  else if (mesh->dim() == 2)
-    ret = swap_edges_2d(mesh, opts);
-  return ret;
+  if (mesh->dim() < 2) return false;
+  if (!swap_part1(mesh, opts)) return false;
+  if (!swap_ghosted(mesh, opts)) return false;
+  mesh->set_parting(OMEGA_H_ELEM_BASED);
+  swap_element_based(mesh, opts);
+  return true;
 }
 
 }  // end namespace Omega_h
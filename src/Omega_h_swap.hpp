@@ -2,6 +2,7 @@
 #define OMEGA_H_SWAP_HPP
 
 #include <Omega_h_adapt.hpp>
+#include <Omega_h_host_few.hpp>
 
 namespace Omega_h {
 
@@ -13,6 +14,19 @@ Read<I8> filter_swap_improve(Mesh* mesh, LOs cands2edges, Reals cand_quals);
 
 bool swap_edges(Mesh* mesh, AdaptOpts const& opts);
 
+/* the pieces of swap_edges, for passes which combine swaps with
+   other operations. mark_swap_candidates marks the interior edges of
+   the sliver layers, choose_swaps keeps the marked edges whose best
+   swap would improve their cavity (cand_configs is only set in 3D),
+   and swap_topology gives the products of swapping the keys by
+   dimension, in the old vertex numbering (edge_configs is only read
+   in 3D, and no key produces vertices) */
+Read<I8> mark_swap_candidates(Mesh* mesh, AdaptOpts const& opts);
+void choose_swaps(Mesh* mesh, AdaptOpts const& opts, Read<I8> edges_are_cands,
+    LOs* p_cands2edges, Reals* p_cand_quals, Read<I8>* p_cand_configs);
+void swap_topology(Mesh* mesh, LOs keys2edges, Read<I8> edge_configs,
+    HostFew<LOs, 4>* keys2prods_out, HostFew<LOs, 4>* prod_verts2verts_out);
+
 }  // end namespace Omega_h
 
 #endif
@@ -14,8 +14,6 @@ HostFew<LOs, 4> swap3d_keys_to_prods(Mesh* mesh, LOs keys2edges);
 HostFew<LOs, 4> swap3d_topology(Mesh* mesh, LOs keys2edges,
     Read<I8> edge_configs, HostFew<LOs, 4> keys2prods);
 
-bool swap_edges_3d(Mesh* mesh, AdaptOpts const& opts);
-
 }  // end namespace Omega_h
 
 #endif
@@ -10,6 +10,7 @@
 #include "Omega_h_shape.hpp"
 
 #include <iostream>
+#include <set>
 namespace Omega_h {
 
 bool is_transfer_required(
@@ -730,6 +731,104 @@ void transfer_swap(Mesh* old_mesh, TransferOpts const& opts, Mesh* new_mesh,
   end_code();
 }
 
+template <typename T>
+static Mesh::TagPtr copy_tag_tmpl(TagBase const* tagbase) {
+  auto copy = std::make_shared<Tag<T>>(tagbase->name(), tagbase->ncomps());
+  copy->set_array(as<T>(tagbase)->array());
+  return copy;
+}
+
+static Mesh::TagPtr copy_tag(TagBase const* tagbase) {
+  switch (tagbase->type()) {
+    case OMEGA_H_I8:
+      return copy_tag_tmpl<I8>(tagbase);
+    case OMEGA_H_I32:
+      return copy_tag_tmpl<I32>(tagbase);
+    case OMEGA_H_I64:
+      return copy_tag_tmpl<I64>(tagbase);
+    case OMEGA_H_F64:
+      return copy_tag_tmpl<Real>(tagbase);
+  }
+  return nullptr;
+}
+
+template <typename T>
+static void keep_products_tmpl(Mesh* new_mesh, Int prod_dim,
+    TagBase const* kept_tag, LOs prods2new_ents) {
+  auto ncomps = kept_tag->ncomps();
+  auto kept_data = as<T>(kept_tag)->array();
+  auto data = new_mesh->get_array<T>(prod_dim, kept_tag->name());
+  auto new_data = deep_copy(data);
+  auto prod_data = read(unmap(prods2new_ents, kept_data, ncomps));
+  map_into(prod_data, prods2new_ents, new_data, ncomps);
+  transfer_common3(new_mesh, prod_dim, kept_tag, new_data);
+}
+
+static void keep_products(Mesh* new_mesh, Int prod_dim,
+    TagBase const* kept_tag, LOs prods2new_ents) {
+  switch (kept_tag->type()) {
+    case OMEGA_H_I8:
+      keep_products_tmpl<I8>(new_mesh, prod_dim, kept_tag, prods2new_ents);
+      break;
+    case OMEGA_H_I32:
+      keep_products_tmpl<I32>(new_mesh, prod_dim, kept_tag, prods2new_ents);
+      break;
+    case OMEGA_H_I64:
+      keep_products_tmpl<I64>(new_mesh, prod_dim, kept_tag, prods2new_ents);
+      break;
+    case OMEGA_H_F64:
+      keep_products_tmpl<Real>(new_mesh, prod_dim, kept_tag, prods2new_ents);
+      break;
+  }
+}
+
+/* transfer_refine and transfer_swap each build whole tags, filling in
+   only the products of their own keys. the tags the splits built are
+   set aside before the swaps run, so that each of them must be built
+   again by the swaps, which then take the split products back from it.
+   a tag only one of the two builds would be left unset on the other's
+   products, so it is an error */
+void transfer_refine_and_swap(Mesh* old_mesh, TransferOpts const& opts,
+    Mesh* new_mesh, Int prod_dim, LOs splits2edges, LOs splits2midverts,
+    LOs splits2prods, LOs split_prods2new_ents, LOs swaps2edges,
+    LOs swaps2prods, LOs swap_prods2new_ents, LOs same_ents2old_ents,
+    LOs same_ents2new_ents) {
+  std::set<std::string> prior_names;
+  for (Int i = 0; i < new_mesh->ntags(prod_dim); ++i) {
+    prior_names.insert(new_mesh->get_tag(prod_dim, i)->name());
+  }
+  transfer_refine(old_mesh, opts, new_mesh, splits2edges, splits2midverts,
+      prod_dim, splits2prods, split_prods2new_ents, same_ents2old_ents,
+      same_ents2new_ents);
+  /* swaps produce no vertices */
+  if (prod_dim == VERT) return;
+  std::vector<Mesh::TagPtr> split_tags;
+  for (Int i = 0; i < new_mesh->ntags(prod_dim); ++i) {
+    auto tag = new_mesh->get_tag(prod_dim, i);
+    if (!prior_names.count(tag->name())) split_tags.push_back(copy_tag(tag));
+  }
+  for (auto const& split_tag : split_tags) {
+    new_mesh->remove_tag(prod_dim, split_tag->name());
+  }
+  transfer_swap(old_mesh, opts, new_mesh, prod_dim, swaps2edges, swaps2prods,
+      swap_prods2new_ents, same_ents2old_ents, same_ents2new_ents);
+  for (auto const& split_tag : split_tags) {
+    if (!new_mesh->has_tag(prod_dim, split_tag->name())) {
+      Omega_h_fail("transfer_refine_and_swap: swaps did not transfer %s\n",
+          split_tag->name().c_str());
+    }
+    keep_products(new_mesh, prod_dim, split_tag.get(), split_prods2new_ents);
+    prior_names.insert(split_tag->name());
+  }
+  for (Int i = 0; i < new_mesh->ntags(prod_dim); ++i) {
+    auto const& name = new_mesh->get_tag(prod_dim, i)->name();
+    if (!prior_names.count(name)) {
+      Omega_h_fail("transfer_refine_and_swap: splits did not transfer %s\n",
+          name.c_str());
+    }
+  }
+}
+
 #define INST(T)                                                                \
   template void transfer_common3(                                              \
       Mesh* new_mesh, Int ent_dim, TagBase const* tagbase, Write<T> new_data); \
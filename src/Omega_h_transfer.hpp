@@ -44,6 +44,14 @@ void transfer_swap(Mesh* old_mesh, TransferOpts const& opts, Mesh* new_mesh,
     Int prod_dim, LOs keys2edges, LOs keys2prods, LOs prods2new_ents,
     LOs same_ents2old_ents, LOs same_ents2new_ents);
 
+/* transfers onto the products of splitting some edges and swapping
+   others in the same rebuild, as transfer_refine and transfer_swap would */
+void transfer_refine_and_swap(Mesh* old_mesh, TransferOpts const& opts,
+    Mesh* new_mesh, Int prod_dim, LOs splits2edges, LOs splits2midverts,
+    LOs splits2prods, LOs split_prods2new_ents, LOs swaps2edges,
+    LOs swaps2prods, LOs swap_prods2new_ents, LOs same_ents2old_ents,
+    LOs same_ents2new_ents);
+
 void transfer_copy(
     Mesh* old_mesh, TransferOpts const& opts, Mesh* new_mesh, Int prod_dim);
 
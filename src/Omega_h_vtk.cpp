@@ -1,10 +1,13 @@
 #include "Omega_h_vtk.hpp"
 
+#include <cctype>
 #include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <vector>
 
 #include "Omega_h_profile.hpp"
 
@@ -118,11 +121,19 @@ void describe_array(std::ostream& stream, std::string const& name, Int ncomps) {
   stream << "type=\"" << Traits<T>::name() << "\"";
   stream << " Name=\"" << name << "\"";
   stream << " NumberOfComponents=\"" << ncomps << "\"";
-  stream << " format=\"binary\"";
+}
+
+/* inline arrays have offset -1, appended ones the offset of their
+   header within the <AppendedData> section */
+static std::streamoff read_array_offset(xml_lite::Tag& st) {
+  auto const format = st.attribs["format"];
+  if (format == "appended") return std::stoll(st.attribs["offset"]);
+  OMEGA_H_CHECK(format == "binary");
+  return -1;
 }
 
 static bool read_array_start_tag(std::istream& stream, Omega_h_Type* type_out,
-    std::string* name_out, Int* ncomps_out) {
+    std::string* name_out, Int* ncomps_out, std::streamoff* offset_out) {
   auto st = xml_lite::read_tag(stream);
   if (st.elem_name != "DataArray" || st.type != xml_lite::Tag::START) {
     OMEGA_H_CHECK(st.type == xml_lite::Tag::END);
@@ -139,13 +150,13 @@ static bool read_array_start_tag(std::istream& stream, Omega_h_Type* type_out,
     *type_out = OMEGA_H_F64;
   *name_out = st.attribs["Name"];
   *ncomps_out = std::stoi(st.attribs["NumberOfComponents"]);
-  OMEGA_H_CHECK(st.attribs["format"] == "binary");
+  *offset_out = read_array_offset(st);
   return true;
 }
 
 template <typename T_osh, typename T_vtk>
 void write_array(std::ostream& stream, std::string const& name, Int ncomps,
-    Read<T_osh> array, bool compress) {
+    Read<T_osh> array, bool compress, AppendedData* appended) {
   OMEGA_H_TIME_FUNCTION;
   if (!(array.exists())) {
     Omega_h_fail("vtk::write_array: \"%s\" doesn't exist\n", name.c_str());
@@ -153,56 +164,210 @@ void write_array(std::ostream& stream, std::string const& name, Int ncomps,
   begin_code("header");
   stream << "<DataArray ";
   describe_array<T_vtk>(stream, name, ncomps);
-  stream << ">\n";
+  if (appended) {
+    stream << " format=\"appended\" offset=\"" << appended->size << "\">\n";
+  } else {
+    stream << " format=\"binary\">\n";
+  }
   end_code();
   HostRead<T_osh> uncompressed(array);
   std::uint64_t uncompressed_bytes =
       sizeof(T_osh) * static_cast<uint64_t>(array.size());
-  std::string enc_header;
-  std::string encoded;
+  /* the same header and payload bytes are either base64-encoded
+     in place or appended raw */
+  std::vector<std::uint64_t> header;
+  auto const host_array = std::make_shared<HostRead<T_osh>>(uncompressed);
+  std::shared_ptr<void const> payload(host_array, nonnull(host_array->data()));
+  std::uint64_t payload_bytes = uncompressed_bytes;
 #ifdef OMEGA_H_USE_ZLIB
   if (compress) {
     begin_code("zlib");
     uLong source_bytes = uncompressed_bytes;
     uLong dest_bytes = ::compressBound(source_bytes);
-    auto compressed = new ::Bytef[dest_bytes];
-    int ret = ::compress2(compressed, &dest_bytes,
-        reinterpret_cast<const ::Bytef*>(nonnull(uncompressed.data())),
-        source_bytes, Z_BEST_SPEED);
+    std::shared_ptr< ::Bytef> compressed(
+        new ::Bytef[dest_bytes], std::default_delete< ::Bytef[]>());
+    int ret = ::compress2(compressed.get(), &dest_bytes,
+        static_cast<const ::Bytef*>(payload.get()), source_bytes,
+        Z_BEST_SPEED);
     end_code();
     OMEGA_H_CHECK(ret == Z_OK);
-    begin_code("base64");
-    encoded = base64::encode(compressed, dest_bytes);
-    delete[] compressed;
-    std::uint64_t header[4] = {
-        1, uncompressed_bytes, uncompressed_bytes, dest_bytes};
-    enc_header = base64::encode(header, sizeof(header));
-    end_code();
+    header = {1, uncompressed_bytes, uncompressed_bytes, dest_bytes};
+    payload = compressed;
+    payload_bytes = dest_bytes;
   } else
 #else
   OMEGA_H_CHECK(!compress);
 #endif
   {
+    header = {uncompressed_bytes};
+  }
+  auto const header_bytes = header.size() * sizeof(std::uint64_t);
+  if (appended) {
+    appended->size += header_bytes + payload_bytes;
+    appended->blocks.push_back({header, payload, payload_bytes});
+  } else {
     begin_code("base64 bulk");
-    enc_header = base64::encode(&uncompressed_bytes, sizeof(std::uint64_t));
-    encoded = base64::encode(nonnull(uncompressed.data()), uncompressed_bytes);
+    base64::write_encoded(stream, header.data(), header_bytes);
+    base64::write_encoded(stream, payload.get(), payload_bytes);
+    stream.write("\n", 1);
     end_code();
   }
-  begin_code("stream bulk");
-  // stream << enc_header << encoded << '\n';
-  // the following three lines are 30% faster than the above line
-  stream.write(enc_header.data(), std::streamsize(enc_header.length()));
-  stream.write(encoded.data(), std::streamsize(encoded.length()));
-  stream.write("\n", 1);
-  end_code();
   begin_code("footer");
   stream << "</DataArray>\n";
   end_code();
 }
 
+static void write_appended_data(
+    std::ostream& stream, AppendedData const& data) {
+  begin_code("appended data");
+  stream << "<AppendedData encoding=\"raw\">\n_";
+  for (auto const& block : data.blocks) {
+    stream.write(reinterpret_cast<char const*>(block.header.data()),
+        std::streamsize(block.header.size() * sizeof(std::uint64_t)));
+    stream.write(static_cast<char const*>(block.payload.get()),
+        std::streamsize(block.payload_bytes));
+  }
+  stream << "\n</AppendedData>\n";
+  end_code();
+}
+
+/* where the raw <AppendedData> section of a file being read starts
+   and where the furthest array read from it ends, -1 until known */
+struct AppendedSection {
+  std::streamoff start = -1;
+  std::streamoff end = -1;
+};
+
+static void check_appended_data_tag(xml_lite::Tag& tag) {
+  if (tag.type != xml_lite::Tag::START) {
+    Omega_h_fail("vtk::read_vtu: misplaced </AppendedData>\n");
+  }
+  if (tag.attribs["encoding"] != "raw") {
+    Omega_h_fail("vtk::read_vtu: only raw AppendedData is supported\n");
+  }
+}
+
+/* leaves the stream at the first byte after the '_' that
+   starts the raw <AppendedData> section */
+static void skip_appended_data_mark(std::istream& stream) {
+  char c;
+  while (stream.get(c) && c != '_') OMEGA_H_CHECK(std::isspace(c));
+  OMEGA_H_CHECK(c == '_');
+}
+
+static void seek_appended_data(std::istream& stream) {
+  for (std::string line; std::getline(stream, line);) {
+    xml_lite::Tag tag;
+    if (!xml_lite::parse_tag(line, &tag)) continue;
+    if (tag.elem_name != "AppendedData") continue;
+    check_appended_data_tag(tag);
+    skip_appended_data_mark(stream);
+    return;
+  }
+  Omega_h_fail("vtk::read_vtu: appended array but no AppendedData\n");
+}
+
+/* reads what follows </UnstructuredGrid>: the <AppendedData> section
+   if there is one, whose raw bytes end after the furthest array read
+   from it, then </VTKFile> */
+static void read_vtu_end(
+    std::istream& stream, AppendedSection const& appended) {
+  auto tag = xml_lite::read_tag(stream);
+  if (tag.elem_name == "AppendedData") {
+    check_appended_data_tag(tag);
+    if (appended.start < 0) {
+      skip_appended_data_mark(stream);
+    } else {
+      stream.seekg(appended.end);
+    }
+    stream >> std::ws;
+    tag = xml_lite::read_tag(stream);
+    if (tag.elem_name != "AppendedData" || tag.type != xml_lite::Tag::END) {
+      Omega_h_fail("vtk::read_vtu: expected </AppendedData>\n");
+    }
+    tag = xml_lite::read_tag(stream);
+  } else if (appended.start >= 0) {
+    Omega_h_fail("vtk::read_vtu: AppendedData is not after the XML\n");
+  }
+  if (tag.elem_name != "VTKFile" || tag.type != xml_lite::Tag::END) {
+    Omega_h_fail("vtk::read_vtu: expected </VTKFile>\n");
+  }
+}
+
+static void read_raw(std::istream& stream, void* data, std::uint64_t bytes) {
+  stream.read(static_cast<char*>(data), std::streamsize(bytes));
+  OMEGA_H_CHECK(stream.gcount() == std::streamsize(bytes));
+}
+
+/* the start of the appended data is found by the first appended array
+   read from a file and remembered for the rest, as is the end of the
+   furthest array read, where the raw bytes of the section end */
+template <typename T>
+static Read<T> read_appended_array(std::istream& stream, LO size,
+    bool needs_swapping, bool is_compressed, std::streamoff offset,
+    AppendedSection* appended) {
+  auto const pos = stream.tellg();
+  if (appended->start < 0) {
+    seek_appended_data(stream);
+    appended->start = stream.tellg();
+  }
+  stream.seekg(appended->start + offset);
+  std::uint64_t uncompressed_bytes;
+#ifdef OMEGA_H_USE_ZLIB
+  std::uint64_t compressed_bytes;
+  if (is_compressed) {
+    std::uint64_t header[4];
+    read_raw(stream, header, sizeof(header));
+    if (needs_swapping) {
+      for (std::uint64_t i = 0; i < 4; ++i) {
+        binary::swap_bytes(header[i]);
+      }
+    }
+    OMEGA_H_CHECK(header[0] == 1);
+    uncompressed_bytes = header[2];
+    compressed_bytes = header[3];
+  } else
+#else
+  OMEGA_H_CHECK(is_compressed == false);
+#endif
+  {
+    read_raw(stream, &uncompressed_bytes, sizeof(uncompressed_bytes));
+    if (needs_swapping) binary::swap_bytes(uncompressed_bytes);
+  }
+  OMEGA_H_CHECK(uncompressed_bytes == std::uint64_t(size) * sizeof(T));
+  HostWrite<T> uncompressed(size);
+#ifdef OMEGA_H_USE_ZLIB
+  if (is_compressed) {
+    std::unique_ptr< ::Bytef[]> compressed(new ::Bytef[compressed_bytes]);
+    read_raw(stream, compressed.get(), compressed_bytes);
+    uLong dest_bytes = static_cast<uLong>(uncompressed_bytes);
+    uLong source_bytes = static_cast<uLong>(compressed_bytes);
+    ::Bytef* uncompressed_ptr =
+        reinterpret_cast< ::Bytef*>(nonnull(uncompressed.data()));
+    int ret = ::uncompress(
+        uncompressed_ptr, &dest_bytes, compressed.get(), source_bytes);
+    if (ret != Z_OK) {
+      Omega_h_fail("code %d: couln't decompress appended array\n", ret);
+    }
+    OMEGA_H_CHECK(dest_bytes == static_cast<uLong>(uncompressed_bytes));
+  } else
+#endif
+  {
+    read_raw(stream, nonnull(uncompressed.data()), uncompressed_bytes);
+  }
+  appended->end = std::max(appended->end, std::streamoff(stream.tellg()));
+  stream.seekg(pos);
+  return binary::swap_bytes(Read<T>(uncompressed.write()), needs_swapping);
+}
+
 template <typename T>
-static Read<T> read_array(
-    std::istream& stream, LO size, bool needs_swapping, bool is_compressed) {
+static Read<T> read_array(std::istream& stream, LO size, bool needs_swapping,
+    bool is_compressed, std::streamoff offset,
+    AppendedSection* appended) {
+  if (offset >= 0) {
+    return read_appended_array<T>(
+        stream, size, needs_swapping, is_compressed, offset, appended);
+  }
   auto enc_both = base64::read_encoded(stream);
   std::uint64_t uncompressed_bytes;
   std::string encoded;
@@ -263,16 +428,16 @@ static Read<T> read_array(
 
 namespace detail {
 template <typename T>
-static void write_tag_impl(
-    TagBase const* tag, Int space_dim, std::ostream& stream, bool compress) {
+static void write_tag_impl(TagBase const* tag, Int space_dim,
+    std::ostream& stream, bool compress, AppendedData* appended) {
   const auto ncomps = tag->ncomps();
   const auto name = tag->name();
   auto array = as<T>(tag)->array();
-  write_array(stream, name, ncomps, array, compress);
+  write_array(stream, name, ncomps, array, compress, appended);
 }
 template <>
-void write_tag_impl<Real>(
-    TagBase const* tag, Int space_dim, std::ostream& stream, bool compress) {
+void write_tag_impl<Real>(TagBase const* tag, Int space_dim,
+    std::ostream& stream, bool compress, AppendedData* appended) {
   const auto ncomps = tag->ncomps();
   const auto name = tag->name();
   auto array = as<Real>(tag)->array();
@@ -283,30 +448,31 @@ void write_tag_impl<Real>(
       // regardless of whether this is a 2D mesh or not.
       // this filter adds a 3rd zero component to any
       // fields with 2 components for 2D meshes
-      write_array(
-          stream, name, 3, resize_vectors(array, space_dim, 3), compress);
+      write_array(stream, name, 3, resize_vectors(array, space_dim, 3),
+          compress, appended);
     } else if (ncomps == symm_ncomps(space_dim)) {
       // Likewise, ParaView has component names specially set up for
       // 3D symmetric tensors
       write_array(stream, name, symm_ncomps(3),
-          resize_symms(array, space_dim, 3), compress);
+          resize_symms(array, space_dim, 3), compress, appended);
     } else {
-      write_array(stream, name, ncomps, array, compress);
+      write_array(stream, name, ncomps, array, compress, appended);
     }
   } else {
-    write_array(stream, name, ncomps, array, compress);
+    write_array(stream, name, ncomps, array, compress, appended);
   }
 }
 }  // namespace detail
 
 void write_tag(std::ostream& stream, TagBase const* tag, Int space_dim,
-    Int ent_dim, bool compress) {
+    Int ent_dim, bool compress, AppendedData* appended = nullptr) {
   OMEGA_H_TIME_FUNCTION;
   const auto name = tag->name();
   const auto class_ids = tag->class_ids();
   // TODO: write class id info for rc tag to file
   apply_to_omega_h_types(tag->type(), [&](auto t) {
-    detail::write_tag_impl<decltype(t)>(tag, space_dim, stream, compress);
+    detail::write_tag_impl<decltype(t)>(
+        tag, space_dim, stream, compress, appended);
 });
 }
 
@@ -314,8 +480,10 @@ namespace detail {
 template <typename T>
 static void read_tag_impl(std::istream& stream, Mesh* mesh, LO size, Int ncomps,
     Int ent_dim, std::string const& name, LOs class_ids, bool needs_swapping,
-    bool is_compressed) {
-  auto array = read_array<T>(stream, size, needs_swapping, is_compressed);
+    bool is_compressed, std::streamoff offset,
+    AppendedSection* appended) {
+  auto array = read_array<T>(
+      stream, size, needs_swapping, is_compressed, offset, appended);
   if (is_rc_tag(name)) {
     mesh->set_rc_from_mesh_array(ent_dim, ncomps, class_ids, name, array);
   } else {
@@ -325,8 +493,10 @@ static void read_tag_impl(std::istream& stream, Mesh* mesh, LO size, Int ncomps,
 template <>
 void read_tag_impl<Real>(std::istream& stream, Mesh* mesh, LO size, Int ncomps,
     Int ent_dim, std::string const& name, LOs class_ids, bool needs_swapping,
-    bool is_compressed) {
-  auto array = read_array<Real>(stream, size, needs_swapping, is_compressed);
+    bool is_compressed, std::streamoff offset,
+    AppendedSection* appended) {
+  auto array = read_array<Real>(
+      stream, size, needs_swapping, is_compressed, offset, appended);
   // special case for reading real tags only
   // undo the resizes done in write_tag()
   if (1 < mesh->dim() && mesh->dim() < 3) {
@@ -348,11 +518,12 @@ void read_tag_impl<Real>(std::istream& stream, Mesh* mesh, LO size, Int ncomps,
 }  // namespace detail
 
 static bool read_tag(std::istream& stream, Mesh* mesh, Int ent_dim,
-    bool needs_swapping, bool is_compressed) {
+    bool needs_swapping, bool is_compressed, AppendedSection* appended) {
   Omega_h_Type type = OMEGA_H_I8;
   std::string name;
   Int ncomps = -1;
-  if (!read_array_start_tag(stream, &type, &name, &ncomps)) {
+  std::streamoff offset = -1;
+  if (!read_array_start_tag(stream, &type, &name, &ncomps, &offset)) {
     return false;
   }
   auto class_ids = LOs();
@@ -364,7 +535,8 @@ static bool read_tag(std::istream& stream, Mesh* mesh, Int ent_dim,
   auto size = mesh->nents(ent_dim) * ncomps;
   apply_to_omega_h_types(type, [&](auto t) {
     detail::read_tag_impl<decltype(t)>(stream, mesh, size, ncomps, ent_dim,
-        name, class_ids, needs_swapping, is_compressed);
+        name, class_ids, needs_swapping, is_compressed, offset,
+        appended);
   });
   auto et = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(et.elem_name == "DataArray");
@@ -374,15 +546,16 @@ static bool read_tag(std::istream& stream, Mesh* mesh, Int ent_dim,
 
 template <typename T>
 static Read<T> read_known_array(std::istream& stream, std::string const& name,
-    LO nents, Int ncomps, bool needs_swapping, bool is_compressed) {
+    LO nents, Int ncomps, bool needs_swapping, bool is_compressed,
+    AppendedSection* appended) {
   auto st = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(st.elem_name == "DataArray");
   OMEGA_H_CHECK(st.type == xml_lite::Tag::START);
   OMEGA_H_CHECK(st.attribs["Name"] == name);
   OMEGA_H_CHECK(st.attribs["type"] == Traits<T>::name());
   OMEGA_H_CHECK(st.attribs["NumberOfComponents"] == std::to_string(ncomps));
-  auto array =
-      read_array<T>(stream, nents * ncomps, needs_swapping, is_compressed);
+  auto array = read_array<T>(stream, nents * ncomps, needs_swapping,
+      is_compressed, read_array_offset(st), appended);
   auto et = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(et.elem_name == "DataArray");
   OMEGA_H_CHECK(et.type == xml_lite::Tag::END);
@@ -478,17 +651,17 @@ static void read_piece_start_tag(
   *ncells_out = std::stoi(st.attribs["NumberOfCells"]);
 }
 
-static void write_connectivity(
-    std::ostream& stream, Mesh* mesh, Int cell_dim, bool compress) {
+static void write_connectivity(std::ostream& stream, Mesh* mesh, Int cell_dim,
+    bool compress, AppendedData* appended) {
   Read<I8> types(mesh->nents(cell_dim), vtk_type(mesh->family(), cell_dim));
-  write_array(stream, "types", 1, types, compress);
+  write_array(stream, "types", 1, types, compress, appended);
   LOs ev2v = mesh->ask_verts_of(cell_dim);
   auto deg = element_degree(mesh->family(), cell_dim, VERT);
   /* starts off already at the end of the first entity's adjacencies,
      increments by a constant value */
   LOs ends(mesh->nents(cell_dim), deg, deg);
-  write_array(stream, "connectivity", 1, ev2v, compress);
-  write_array(stream, "offsets", 1, ends, compress);
+  write_array(stream, "connectivity", 1, ev2v, compress, appended);
+  write_array(stream, "offsets", 1, ends, compress, appended);
 }
 
 static void write_connectivity(std::ostream& stream, MixedMesh* mesh, Int cell_dim,
@@ -573,10 +746,11 @@ static void write_connectivity(std::ostream& stream, MixedMesh* mesh, Int cell_d
 }
 
 static void read_connectivity(std::istream& stream, CommPtr comm, LO ncells,
-    bool needs_swapping, bool is_compressed, Omega_h_Family* family_out,
-    Int* dim_out, LOs* ev2v_out) {
+    bool needs_swapping, bool is_compressed, AppendedSection* appended,
+    Omega_h_Family* family_out, Int* dim_out, LOs* ev2v_out) {
   auto types = read_known_array<I8>(
-      stream, "types", ncells, 1, needs_swapping, is_compressed);
+      stream, "types", ncells, 1, needs_swapping, is_compressed,
+      appended);
   Omega_h_Family family = OMEGA_H_SIMPLEX;
   Int dim = -1;
   if (types.size()) {
@@ -604,42 +778,43 @@ static void read_connectivity(std::istream& stream, CommPtr comm, LO ncells,
   *family_out = family;
   *dim_out = dim;
   auto deg = element_degree(family, dim, VERT);
-  auto ev2v = read_known_array<LO>(
-      stream, "connectivity", ncells * deg, 1, needs_swapping, is_compressed);
+  auto ev2v = read_known_array<LO>(stream, "connectivity", ncells * deg, 1,
+      needs_swapping, is_compressed, appended);
   *ev2v_out = ev2v;
-  read_known_array<LO>(
-      stream, "offsets", ncells, 1, needs_swapping, is_compressed);
+  read_known_array<LO>(stream, "offsets", ncells, 1, needs_swapping,
+      is_compressed, appended);
 }
 
-static void write_locals(
-    std::ostream& stream, Mesh* mesh, Int ent_dim, bool compress) {
-  write_array(
-      stream, "local", 1, Read<LO>(mesh->nents(ent_dim), 0, 1), compress);
+static void write_locals(std::ostream& stream, Mesh* mesh, Int ent_dim,
+    bool compress, AppendedData* appended) {
+  write_array(stream, "local", 1, Read<LO>(mesh->nents(ent_dim), 0, 1),
+      compress, appended);
 }
 
-static void write_owners(
-    std::ostream& stream, Mesh* mesh, Int ent_dim, bool compress) {
+static void write_owners(std::ostream& stream, Mesh* mesh, Int ent_dim,
+    bool compress, AppendedData* appended) {
   if (mesh->comm()->size() == 1) return;
-  write_array(stream, "owner", 1, mesh->ask_owners(ent_dim).ranks, compress);
+  write_array(stream, "owner", 1, mesh->ask_owners(ent_dim).ranks, compress,
+      appended);
 }
 
-static void write_vtk_ghost_types(
-    std::ostream& stream, Mesh* mesh, Int ent_dim, bool compress) {
+static void write_vtk_ghost_types(std::ostream& stream, Mesh* mesh,
+    Int ent_dim, bool compress, AppendedData* appended) {
   if (mesh->comm()->size() == 1) return;
   const auto owned = mesh->owned(ent_dim);
   auto ghost_types = each_eq_to(owned, static_cast<I8>(0));
   write_array<I8, std::uint8_t>(
-      stream, "vtkGhostType", 1, ghost_types, compress);
+      stream, "vtkGhostType", 1, ghost_types, compress, appended);
 }
 
 static void write_locals_and_owners(std::ostream& stream, Mesh* mesh,
-    Int ent_dim, TagSet const& tags, bool compress) {
+    Int ent_dim, TagSet const& tags, bool compress, AppendedData* appended) {
   OMEGA_H_TIME_FUNCTION;
   if (tags[size_t(ent_dim)].count("local")) {
-    write_locals(stream, mesh, ent_dim, compress);
+    write_locals(stream, mesh, ent_dim, compress, appended);
   }
   if (tags[size_t(ent_dim)].count("owner")) {
-    write_owners(stream, mesh, ent_dim, compress);
+    write_owners(stream, mesh, ent_dim, compress, appended);
   }
 }
 
@@ -648,7 +823,7 @@ void write_p_data_array(
     std::ostream& stream, std::string const& name, Int ncomps) {
   stream << "<PDataArray ";
   describe_array<T>(stream, name, ncomps);
-  stream << "/>\n";
+  stream << " format=\"binary\"/>\n";
 }
 
 static void write_p_data_array2(std::ostream& stream, std::string const& name,
@@ -767,33 +942,35 @@ void write_vtkfile_vtu_start_tag(std::ostream& stream, bool compress) {
 }
 
 void write_vtu(std::ostream& stream, Mesh* mesh, Int cell_dim,
-    TagSet const& tags, bool compress) {
+    TagSet const& tags, bool compress, bool appended) {
   OMEGA_H_TIME_FUNCTION;
   default_dim(mesh->dim(), &cell_dim);
   verify_vtk_tagset(mesh, cell_dim, tags);
+  AppendedData appended_data;
+  auto const data = appended ? &appended_data : nullptr;
   write_vtkfile_vtu_start_tag(stream, compress);
   stream << "<UnstructuredGrid>\n";
   write_piece_start_tag(stream, mesh, cell_dim);
   stream << "<Cells>\n";
-  write_connectivity(stream, mesh, cell_dim, compress);
+  write_connectivity(stream, mesh, cell_dim, compress, data);
   stream << "</Cells>\n";
   stream << "<Points>\n";
   auto coords = mesh->coords();
   write_array(stream, "coordinates", 3, resize_vectors(coords, mesh->dim(), 3),
-      compress);
+      compress, data);
   stream << "</Points>\n";
   stream << "<PointData>\n";
   /* globals go first so read_vtu() knows where to find them */
   if (mesh->has_tag(VERT, "global") && tags[VERT].count("global")) {
     write_tag(stream, mesh->get_tag<GO>(VERT, "global"), mesh->dim(), VERT,
-        compress);
+        compress, data);
   }
-  write_locals_and_owners(stream, mesh, VERT, tags, compress);
+  write_locals_and_owners(stream, mesh, VERT, tags, compress, data);
   for (Int i = 0; i < mesh->ntags(VERT); ++i) {
     auto tag = mesh->get_tag(VERT, i);
     if (tag->name() != "coordinates" && tag->name() != "global" &&
         tags[VERT].count(tag->name())) {
-      write_tag(stream, tag, mesh->dim(), VERT, compress);
+      write_tag(stream, tag, mesh->dim(), VERT, compress, data);
     }
   }
   stream << "</PointData>\n";
@@ -802,21 +979,22 @@ void write_vtu(std::ostream& stream, Mesh* mesh, Int cell_dim,
   if (mesh->has_tag(cell_dim, "global") &&
       tags[size_t(cell_dim)].count("global")) {
     write_tag(stream, mesh->get_tag<GO>(cell_dim, "global"), mesh->dim(),
-        cell_dim, compress);
+        cell_dim, compress, data);
   }
-  write_locals_and_owners(stream, mesh, cell_dim, tags, compress);
+  write_locals_and_owners(stream, mesh, cell_dim, tags, compress, data);
   if (tags[size_t(cell_dim)].count("vtkGhostType")) {
-    write_vtk_ghost_types(stream, mesh, cell_dim, compress);
+    write_vtk_ghost_types(stream, mesh, cell_dim, compress, data);
   }
   for (Int i = 0; i < mesh->ntags(cell_dim); ++i) {
     auto tag = mesh->get_tag(cell_dim, i);
     if (tag->name() != "global" && tags[size_t(cell_dim)].count(tag->name())) {
-      write_tag(stream, tag, mesh->dim(), cell_dim, compress);
+      write_tag(stream, tag, mesh->dim(), cell_dim, compress, data);
     }
   }
   stream << "</CellData>\n";
   stream << "</Piece>\n";
   stream << "</UnstructuredGrid>\n";
+  if (appended) write_appended_data(stream, appended_data);
   stream << "</VTKFile>\n";
 }
 
@@ -928,6 +1106,7 @@ void read_vtu(std::istream& stream, CommPtr comm, Mesh* mesh) {
 void read_vtu_ents(std::istream& stream, Mesh* mesh) {
   bool needs_swapping, is_compressed;
   read_vtkfile_vtu_start_tag(stream, &needs_swapping, &is_compressed);
+  AppendedSection appended;
   auto tag1 = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(tag1.elem_name == "UnstructuredGrid");
   LO nverts, ncells;
@@ -939,7 +1118,7 @@ void read_vtu_ents(std::istream& stream, Mesh* mesh) {
   Int dim;
   LOs ev2v;
   read_connectivity(stream, comm, ncells, needs_swapping, is_compressed,
-      &family, &dim, &ev2v);
+      &appended, &family, &dim, &ev2v);
   mesh->set_family(family);
   mesh->set_dim(dim);
   auto tag3 = xml_lite::read_tag(stream);
@@ -947,7 +1126,8 @@ void read_vtu_ents(std::istream& stream, Mesh* mesh) {
   auto tag4 = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(tag4.elem_name == "Points");
   auto coords = read_known_array<Real>(
-      stream, "coordinates", nverts, 3, needs_swapping, is_compressed);
+      stream, "coordinates", nverts, 3, needs_swapping, is_compressed,
+      &appended);
   if (dim < 3) coords = resize_vectors(coords, 3, dim);
   auto tag5 = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(tag5.elem_name == "Points");
@@ -956,13 +1136,15 @@ void read_vtu_ents(std::istream& stream, Mesh* mesh) {
   GOs vert_globals;
   if (mesh->could_be_shared(VERT)) {
     vert_globals = read_known_array<GO>(
-        stream, "global", nverts, 1, needs_swapping, is_compressed);
+        stream, "global", nverts, 1, needs_swapping, is_compressed,
+        &appended);
   } else {
     vert_globals = Read<GO>(nverts, 0, 1);
   }
   build_verts_from_globals(mesh, vert_globals);
   mesh->add_tag(VERT, "coordinates", dim, coords, true);
-  while (read_tag(stream, mesh, VERT, needs_swapping, is_compressed))
+  while (read_tag(
+      stream, mesh, VERT, needs_swapping, is_compressed, &appended))
     ;
   mesh->remove_tag(VERT, "local");
   mesh->remove_tag(VERT, "owner");
@@ -971,29 +1153,32 @@ void read_vtu_ents(std::istream& stream, Mesh* mesh) {
   GOs elem_globals;
   if (mesh->could_be_shared(dim)) {
     elem_globals = read_known_array<GO>(
-        stream, "global", ncells, 1, needs_swapping, is_compressed);
+        stream, "global", ncells, 1, needs_swapping, is_compressed,
+        &appended);
   } else {
     elem_globals = Read<GO>(ncells, 0, 1);
   }
   build_ents_from_elems2verts(mesh, ev2v, vert_globals, elem_globals);
-  while (read_tag(stream, mesh, dim, needs_swapping, is_compressed))
+  while (read_tag(
+      stream, mesh, dim, needs_swapping, is_compressed, &appended))
     ;
   mesh->remove_tag(dim, "local");
   mesh->remove_tag(dim, "owner");
   auto tag8 = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(tag8.elem_name == "Piece");
+  OMEGA_H_CHECK(tag8.type == xml_lite::Tag::END);
   auto tag9 = xml_lite::read_tag(stream);
   OMEGA_H_CHECK(tag9.elem_name == "UnstructuredGrid");
-  auto tag10 = xml_lite::read_tag(stream);
-  OMEGA_H_CHECK(tag10.elem_name == "VTKFile");
+  OMEGA_H_CHECK(tag9.type == xml_lite::Tag::END);
+  read_vtu_end(stream, appended);
 }
 
 void write_vtu(filesystem::path const& filename, Mesh* mesh, Int cell_dim,
-    TagSet const& tags, bool compress) {
-  std::ofstream file(filename.c_str());
+    TagSet const& tags, bool compress, bool appended) {
+  std::ofstream file(filename.c_str(), std::ios::binary);
   OMEGA_H_CHECK(file.is_open());
   ask_for_mesh_tags(mesh, tags);
-  write_vtu(file, mesh, cell_dim, tags, compress);
+  write_vtu(file, mesh, cell_dim, tags, compress, appended);
 }
 
 void write_vtu(
@@ -1122,7 +1307,7 @@ void read_pvtu(filesystem::path const& pvtupath, CommPtr comm, I32* npieces_out,
 }
 
 void write_parallel(filesystem::path const& path, Mesh* mesh, Int cell_dim,
-    TagSet const& tags, bool compress) {
+    TagSet const& tags, bool compress, bool appended) {
   ScopedTimer timer("vtk::write_parallel");
   default_dim(mesh->dim(), &cell_dim);
   ask_for_mesh_tags(mesh, tags);
@@ -1142,7 +1327,8 @@ void write_parallel(filesystem::path const& path, Mesh* mesh, Int cell_dim,
     auto const relative_piecepath = filesystem::path("pieces") / "piece";
     write_pvtu(pvtuname, mesh, cell_dim, relative_piecepath, tags);
   }
-  write_vtu(piece_filename(piecepath, rank), mesh, cell_dim, tags, compress);
+  write_vtu(piece_filename(piecepath, rank), mesh, cell_dim, tags, compress,
+      appended);
 }
 
 void write_parallel(
@@ -1165,7 +1351,7 @@ void read_parallel(filesystem::path const& pvtupath, CommPtr comm, Mesh* mesh) {
   bool in_subcomm = (comm->rank() < npieces);
   auto subcomm = comm->split(I32(!in_subcomm), 0);
   if (in_subcomm) {
-    std::ifstream vtustream(vtupath.c_str());
+    std::ifstream vtustream(vtupath.c_str(), std::ios::binary);
     OMEGA_H_CHECK(vtustream.is_open());
     mesh->set_comm(subcomm);
     if (nghost_layers == 0) {
@@ -1272,15 +1458,17 @@ Writer::Writer()
       root_path_("/not-set"),
       cell_dim_(-1),
       compress_(OMEGA_H_DEFAULT_COMPRESS),
+      appended_(false),
       step_(-1),
       pvd_pos_(0) {}
 
 Writer::Writer(filesystem::path const& root_path, Mesh* mesh, Int cell_dim,
-    Real restart_time, bool compress)
+    Real restart_time, bool compress, bool appended)
     : mesh_(mesh),
       root_path_(root_path),
       cell_dim_(cell_dim),
       compress_(compress),
+      appended_(appended),
       step_(0),
       pvd_pos_(0) {
   default_dim(mesh_->dim(), &cell_dim_);
@@ -1302,8 +1490,8 @@ Writer::Writer(filesystem::path const& root_path, Mesh* mesh, Int cell_dim,
 
 void Writer::write(I64 step, Real time, TagSet const& tags) {
   step_ = step;
-  write_parallel(
-      get_step_path(root_path_, step_), mesh_, cell_dim_, tags, compress_);
+  write_parallel(get_step_path(root_path_, step_), mesh_, cell_dim_, tags,
+      compress_, appended_);
   if (mesh_->comm()->rank() == 0) {
     update_pvd(root_path_, &pvd_pos_, step_, time);
   }
@@ -1321,7 +1509,7 @@ void Writer::write(Real time) {
 void Writer::write() { this->write(Real(step_)); }
 
 FullWriter::FullWriter(filesystem::path const& root_path, Mesh* mesh,
-    Real restart_time, bool compress) {
+    Real restart_time, bool compress, bool appended) {
   auto const comm = mesh->comm();
   auto const rank = comm->rank();
   if (rank == 0) {
@@ -1330,7 +1518,7 @@ FullWriter::FullWriter(filesystem::path const& root_path, Mesh* mesh,
   comm->barrier();
   for (Int i = EDGE; i <= mesh->dim(); ++i) {
     writers_.push_back(Writer(root_path / dimensional_plural_name(i), mesh, i,
-        restart_time, compress));
+        restart_time, compress, appended));
   }
 }
 
@@ -1346,7 +1534,7 @@ void FullWriter::write() {
   template void write_p_data_array<T>(                                         \
       std::ostream & stream, std::string const& name, Int ncomps);             \
   template void write_array(std::ostream& stream, std::string const& name,     \
-      Int ncomps, Read<T> array, bool compress);
+      Int ncomps, Read<T> array, bool compress, AppendedData* appended);
 OMEGA_H_EXPL_INST(I8)
 OMEGA_H_EXPL_INST(I32)
 OMEGA_H_EXPL_INST(I64)
@@ -1354,7 +1542,8 @@ OMEGA_H_EXPL_INST(Real)
 #undef OMEGA_H_EXPL_INST
 
 template void write_array<Real, std::uint8_t>(std::ostream& stream,
-    std::string const& name, Int ncomps, Read<Real> array, bool compress);
+    std::string const& name, Int ncomps, Read<Real> array, bool compress,
+    AppendedData* appended);
 
 }  // end namespace vtk
 
@@ -1,7 +1,9 @@
 #ifndef OMEGA_H_VTK_HPP
 #define OMEGA_H_VTK_HPP
 
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -63,15 +65,31 @@ template <typename T>
 void write_p_data_array(
     std::ostream& stream, std::string const& name, Int ncomps);
 
+/* the blocks of a raw <AppendedData> section, each a header and a
+   payload which stay where they are until the section is streamed
+   after the XML, so the section is never gathered into one buffer */
+struct AppendedData {
+  struct Block {
+    std::vector<std::uint64_t> header;
+    std::shared_ptr<void const> payload;
+    std::uint64_t payload_bytes;
+  };
+  std::vector<Block> blocks;
+  std::uint64_t size = 0;
+};
+
+/* when appended is non-null the array bytes are added to it as a
+   block and the DataArray only records their offset */
 template <typename T_osh, typename T_vtk = T_osh>
 void write_array(std::ostream& stream, std::string const& name, Int ncomps,
-    Read<T_osh> array, bool compress);
+    Read<T_osh> array, bool compress, AppendedData* appended = nullptr);
 
 #define OMEGA_H_EXPL_INST_DECL(T)                                              \
   extern template void write_p_data_array<T>(                                  \
       std::ostream & stream, std::string const& name, Int ncomps);             \
   extern template void write_array(std::ostream& stream,                       \
-      std::string const& name, Int ncomps, Read<T> array, bool compress);
+      std::string const& name, Int ncomps, Read<T> array, bool compress,       \
+      AppendedData* appended);
 OMEGA_H_EXPL_INST_DECL(I8)
 OMEGA_H_EXPL_INST_DECL(I32)
 OMEGA_H_EXPL_INST_DECL(I64)
@@ -79,7 +97,8 @@ OMEGA_H_EXPL_INST_DECL(Real)
 #undef OMEGA_H_EXPL_INST_DECL
 
 extern template void write_array<Real, std::uint8_t>(std::ostream& stream,
-    std::string const& name, Int ncomps, Read<Real> array, bool compress);
+    std::string const& name, Int ncomps, Read<Real> array, bool compress,
+    AppendedData* appended);
 
 }  // namespace vtk
 
@@ -0,0 +1,80 @@
+#include "Omega_h_base64.hpp"
+#include "Omega_h_fail.hpp"
+#include "Omega_h_library.hpp"
+#include "Omega_h_timer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace Omega_h;
+
+/* compares base64 throughput of the scalar engine with the vector
+   engines this CPU supports, and of encoding into a string and then
+   a stream with encoding straight into the stream.
+   usage: base64_bench [megabytes] [ntrials] */
+
+template <typename F>
+static Real best_of(Int const ntrials, F const& f) {
+  Real best = -1.0;
+  for (Int i = 0; i < ntrials; ++i) {
+    auto const t0 = now();
+    f();
+    auto const t = now() - t0;
+    if (best < 0.0 || t < best) best = t;
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  std::size_t megabytes = 64;
+  Int ntrials = 5;
+  if (argc > 1) megabytes = std::size_t(std::atoi(argv[1]));
+  if (argc > 2) ntrials = std::atoi(argv[2]);
+  std::vector<unsigned char> data(megabytes << 20);
+  std::mt19937 gen(42);
+  for (auto& byte : data) byte = static_cast<unsigned char>(gen());
+  std::vector<char> text(base64::encoded_size(data.size()));
+  std::vector<unsigned char> decoded(data.size());
+  auto const gb = Real(data.size()) / Real(1 << 30);
+  std::cout << megabytes << " MB, best engine "
+            << base64::engine_name(base64::best_engine()) << '\n';
+  std::vector<char> reference;
+  Real scalar_encode = 0.0, scalar_decode = 0.0;
+  for (Int e = base64::SCALAR; e <= base64::best_engine(); ++e) {
+    auto const engine = base64::Engine(e);
+    auto const encode_time = best_of(ntrials, [&]() {
+      base64::encode(data.data(), data.size(), text.data(), engine);
+    });
+    auto const decode_time = best_of(ntrials, [&]() {
+      base64::decode(text.data(), decoded.data(), data.size(), engine);
+    });
+    if (engine == base64::SCALAR) {
+      reference = text;
+      scalar_encode = encode_time;
+      scalar_decode = decode_time;
+    }
+    OMEGA_H_CHECK(text == reference);
+    OMEGA_H_CHECK(decoded == data);
+    std::cout << base64::engine_name(engine) << ": encode "
+              << (gb / encode_time) << " GB/s (speedup "
+              << (scalar_encode / encode_time) << "), decode "
+              << (gb / decode_time) << " GB/s (speedup "
+              << (scalar_decode / decode_time) << ")\n";
+  }
+  auto const string_time = best_of(ntrials, [&]() {
+    std::stringstream stream;
+    auto const encoded = base64::encode(data.data(), data.size());
+    stream.write(encoded.data(), std::streamsize(encoded.length()));
+  });
+  auto const stream_time = best_of(ntrials, [&]() {
+    std::stringstream stream;
+    base64::write_encoded(stream, data.data(), data.size());
+  });
+  std::cout << "encode to string then stream " << string_time
+            << " s, write_encoded " << stream_time << " s\n";
+  return 0;
+}
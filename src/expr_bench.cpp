@@ -0,0 +1,70 @@
+#include "Omega_h_array_ops.hpp"
+#include "Omega_h_expr.hpp"
+#include "Omega_h_fail.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_library.hpp"
+#include "Omega_h_timer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace Omega_h;
+
+/* compares evaluating an expression one operator at a time
+   (ExprOp::eval) with evaluating its lowered ExprProgram.
+   usage: expr_bench [nentities] [ntrials] */
+
+template <typename F>
+static Real best_of(Int const ntrials, F const& f) {
+  Real best = -1.0;
+  for (Int i = 0; i < ntrials; ++i) {
+    auto const t0 = now();
+    f();
+    auto const t = now() - t0;
+    if (best < 0.0 || t < best) best = t;
+  }
+  return best;
+}
+
+static Reals make_coords(LO const n, Real const scale) {
+  Write<Real> a(n);
+  auto f = OMEGA_H_LAMBDA(LO i) { a[i] = scale * Real(i % 1000) / 1000.0; };
+  parallel_for(n, f);
+  return a;
+}
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  LO n = 1 << 22;
+  Int ntrials = 5;
+  if (argc > 1) n = LO(std::atol(argv[1]));
+  if (argc > 2) ntrials = std::atoi(argv[2]);
+  ExprEnv env(n, 3);
+  env.register_variable("x", any(make_coords(n, 1.0)));
+  env.register_variable("y", any(make_coords(n, 2.0)));
+  env.register_variable("z", any(make_coords(n, 3.0)));
+  char const* const exprs[] = {"x + y * z",
+      "sqrt(x^2 + y^2 + z^2) * exp(-x) + sin(y) * cos(z) - 2 * x * y",
+      "(x > 0.5) ? (1 + x * y) / (1 + z) : 0.1 * x",
+      "v = vector(x, y, z); n = norm(v); (1 / (n + 1)) * v"};
+  std::cout << n << " entities\n";
+  for (auto expr : exprs) {
+    ExprOpsReader reader;
+    auto op = reader.read_ops(expr);
+    ExprProgram program(*op, env);
+    auto unfused = any();
+    auto const unfused_time = best_of(ntrials, [&]() {
+      unfused = op->eval(env);
+    });
+    Reals fused;
+    auto const fused_time = best_of(ntrials, [&]() { fused = program.eval(); });
+    env.repeat(unfused);
+    OMEGA_H_CHECK(are_close(fused, any_cast<Reals>(unfused)));
+    std::cout << expr << "\n  " << program.ninstructions()
+              << " instructions, " << program.nregisters()
+              << " registers: eval " << unfused_time << " s, fused "
+              << fused_time << " s (speedup " << (unfused_time / fused_time)
+              << ")\n";
+  }
+  return 0;
+}
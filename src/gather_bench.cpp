@@ -0,0 +1,113 @@
+#include "Omega_h_array_ops.hpp"
+#include "Omega_h_build.hpp"
+#include "Omega_h_fail.hpp"
+#include "Omega_h_for.hpp"
+#include "Omega_h_library.hpp"
+#include "Omega_h_mesh.hpp"
+#include "Omega_h_metric.hpp"
+#include "Omega_h_quality.hpp"
+#include "Omega_h_shape.hpp"
+#include "Omega_h_timer.hpp"
+#include "Omega_h_unmap_mesh.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace Omega_h;
+
+/* compares element kernels which gather vertex coordinates and metrics
+   through the element-to-vertex map with the same kernels reading
+   the per-element copies that Mesh::set_elem_vert_caching keeps.
+   with "scatter", the vertices are renumbered by a large stride
+   first, as a stand-in for meshes whose vertex order has little
+   to do with their element order.
+   usage: gather_bench [nelems per axis] [ntrials] [scatter] */
+
+template <typename F>
+static Real best_of(Int const ntrials, F const& f) {
+  Real best = -1.0;
+  for (Int i = 0; i < ntrials; ++i) {
+    auto const t0 = now();
+    f();
+    auto const t = now() - t0;
+    if (best < 0.0 || t < best) best = t;
+  }
+  return best;
+}
+
+static void add_metric(Mesh* mesh) {
+  auto coords = mesh->coords();
+  Write<Real> metrics(mesh->nverts() * symm_ncomps(3));
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto x = get_vector<3>(coords, v);
+    auto m = diagonal(vector_3(1.0 + x[0], 2.0 + x[1] * x[2], 3.0));
+    set_symm(metrics, v, m);
+  };
+  parallel_for(mesh->nverts(), f);
+  mesh->add_tag(VERT, "metric", symm_ncomps(3), Reals(metrics));
+}
+
+static void scatter_verts(Mesh* mesh) {
+  auto const nverts = mesh->nverts();
+  GO const stride = 1000003;
+  OMEGA_H_CHECK(nverts % stride != 0);
+  Write<LO> new_verts2old_verts(nverts);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    new_verts2old_verts[v] = LO((GO(v) * stride) % GO(nverts));
+  };
+  parallel_for(nverts, f);
+  LOs new_ents2old_ents[4];
+  new_ents2old_ents[VERT] = new_verts2old_verts;
+  for (Int d = 1; d <= mesh->dim(); ++d) {
+    new_ents2old_ents[d] = LOs(mesh->nents(d), 0, 1);
+  }
+  unmap_mesh(mesh, new_ents2old_ents);
+}
+
+template <typename F>
+static void compare(
+    Mesh* mesh, Int const ntrials, char const* name, F const& kernel) {
+  mesh->set_elem_vert_caching(false);
+  Reals gathered;
+  auto const gathered_time =
+      best_of(ntrials, [&]() { gathered = kernel(mesh); });
+  mesh->set_elem_vert_caching(true);
+  mesh->ask_elem_coords();
+  mesh->ask_elem_metrics();
+  Reals packed;
+  auto const packed_time = best_of(ntrials, [&]() { packed = kernel(mesh); });
+  OMEGA_H_CHECK(packed == gathered);
+  std::cout << name << ": gathered " << gathered_time << " s, packed "
+            << packed_time << " s (speedup " << (gathered_time / packed_time)
+            << ")\n";
+}
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  LO n = 64;
+  Int ntrials = 5;
+  if (argc > 1) n = LO(std::atol(argv[1]));
+  if (argc > 2) ntrials = std::atoi(argv[2]);
+  auto const scatter = (argc > 3) && (std::string(argv[3]) == "scatter");
+  auto mesh = build_box(lib.world(), OMEGA_H_SIMPLEX, 1, 1, 1, n, n, n);
+  if (scatter) scatter_verts(&mesh);
+  add_metric(&mesh);
+  mesh.ask_sizes();
+  std::cout << mesh.nelems() << " elements\n";
+  mesh.set_elem_vert_caching(true);
+  auto const build_time = best_of(ntrials, [&]() {
+    mesh.set_elem_vert_caching(false);
+    mesh.set_elem_vert_caching(true);
+    mesh.ask_elem_coords();
+    mesh.ask_elem_metrics();
+  });
+  std::cout << "building the copies: " << build_time << " s\n";
+  compare(&mesh, ntrials, "measure_elements_real",
+      [](Mesh* m) { return measure_elements_real(m); });
+  compare(&mesh, ntrials, "measure_qualities",
+      [](Mesh* m) { return measure_qualities(m); });
+  compare(&mesh, ntrials, "get_element_implied_length_metrics",
+      [](Mesh* m) { return get_element_implied_length_metrics(m); });
+  return 0;
+}
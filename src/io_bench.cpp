@@ -0,0 +1,87 @@
+#include "Omega_h_array_ops.hpp"
+#include "Omega_h_build.hpp"
+#include "Omega_h_file.hpp"
+#include "Omega_h_library.hpp"
+#include "Omega_h_mesh.hpp"
+#include "Omega_h_timer.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace Omega_h;
+
+/* times writing .osh files, including how long write_async blocks
+   the caller, and compares streaming and memory-mapped
+   reads of them, both in the default (chunked compression when
+   available) layout and in the uncompressed, aligned layout.
+   usage: io_bench [nelems_per_axis] [ntrials] */
+
+static double file_megabytes(filesystem::path const& path) {
+  auto filepath = path / "0.osh";
+  std::ifstream file(filepath.c_str(), std::ios::binary | std::ios::ate);
+  return double(file.tellg()) / (1024.0 * 1024.0);
+}
+
+/* sums every element of the coordinates so that a lazily mapped
+   file is actually paged in before the clock stops */
+template <typename ReadFunc>
+static Real time_read(
+    filesystem::path const& path, Int const ntrials, ReadFunc read_func) {
+  Real best = -1.0;
+  for (Int trial = 0; trial < ntrials; ++trial) {
+    auto const t0 = now();
+    Mesh mesh = read_func(path);
+    auto const sum = get_sum(mesh.coords());
+    auto const t1 = now();
+    OMEGA_H_CHECK(sum > 0.0);
+    if (best < 0.0 || (t1 - t0) < best) best = t1 - t0;
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  auto const comm = lib.self();
+  LO n = 30;
+  Int ntrials = 3;
+  if (argc > 1) n = std::atoi(argv[1]);
+  if (argc > 2) ntrials = std::atoi(argv[2]);
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 1., n, n, n);
+  std::cout << mesh.nelems() << " tets\n";
+  auto streamed = [&](filesystem::path const& path) {
+    return binary::read(path, comm);
+  };
+  auto mapped = [&](filesystem::path const& path) {
+    return binary::read_mapped(path, comm);
+  };
+  for (bool aligned : {false, true}) {
+    filesystem::path path = aligned ? "io_bench_aligned.osh" : "io_bench.osh";
+    Real write_time = -1.0;
+    for (Int trial = 0; trial < ntrials; ++trial) {
+      auto const t0 = now();
+      binary::write(path, &mesh, aligned);
+      auto const t1 = now();
+      if (write_time < 0.0 || (t1 - t0) < write_time) write_time = t1 - t0;
+    }
+    Real async_time = -1.0;
+    for (Int trial = 0; trial < ntrials; ++trial) {
+      auto const t0 = now();
+      auto future = binary::write_async(path, &mesh, aligned);
+      auto const t1 = now();
+      future.get();
+      if (async_time < 0.0 || (t1 - t0) < async_time) async_time = t1 - t0;
+    }
+    auto const megabytes = file_megabytes(path);
+    auto const stream_time = time_read(path, ntrials, streamed);
+    auto const map_time = time_read(path, ntrials, mapped);
+    std::cout << (aligned ? "aligned" : "default") << ": " << megabytes
+              << " MB, write " << write_time << " s (write_async blocks "
+              << async_time << " s), read " << stream_time << " s ("
+              << (megabytes / stream_time) << " MB/s), read_mapped "
+              << map_time << " s (" << (megabytes / map_time)
+              << " MB/s), speedup " << (stream_time / map_time) << '\n';
+    filesystem::remove_all(path);
+  }
+  return 0;
+}
@@ -1,12 +1,20 @@
+#include <Omega_h_adapt.hpp>
 #include <Omega_h_array_ops.hpp>
 #include <Omega_h_bipart.hpp>
 #include <Omega_h_build.hpp>
 #include <Omega_h_compare.hpp>
 #include <Omega_h_for.hpp>
+#include <Omega_h_indset.hpp>
 #include <Omega_h_inertia.hpp>
+#include <Omega_h_linpart.hpp>
+#include <Omega_h_map.hpp>
+#include <Omega_h_metric.hpp>
+#include <Omega_h_multisect.hpp>
 #include <Omega_h_owners.hpp>
+#include <Omega_h_profile.hpp>
 #include <Omega_h_vtk.hpp>
 
+#include <cstring>
 #include <sstream>
 
 using namespace Omega_h;
@@ -113,6 +121,40 @@ static void test_two_ranks_dist(CommPtr comm) {
   OMEGA_H_CHECK(c == a);
 }
 
+static void test_two_ranks_dist_plan(CommPtr comm) {
+  OMEGA_H_CHECK(comm->size() == 2);
+  /* the reversal of test_two_ranks_dist, with the first root on
+     rank 0 sending to two destinations */
+  Dist dist;
+  dist.set_parent_comm(comm);
+  if (comm->rank() == 0) {
+    dist.set_dest_ranks(Read<I32>({1, 0, 1, 0}));
+    dist.set_dest_idxs(LOs({1, 3, 0, 2}), 4);
+    dist.set_roots2items(LOs({0, 2, 3, 4}));
+  } else {
+    dist.set_dest_ranks(Read<I32>({0, 0}));
+    dist.set_dest_idxs(LOs({1, 0}), 2);
+  }
+  DistPlan<Real> plan(dist, 2);
+  for (Int step = 0; step < 3; ++step) {
+    Reals a;
+    if (comm->rank() == 0) {
+      a = Reals({0. + step, 1., 2., 3., 4., 5.});
+    } else {
+      a = Reals({6., 7., 8., 9. + step});
+    }
+    plan.begin(a);
+    auto expected = dist.exch(a, 2);
+    auto b = plan.finish();
+    OMEGA_H_CHECK(b == expected);
+    OMEGA_H_CHECK(plan.exch(a) == expected);
+  }
+  auto roots = LOs(comm->rank() == 0 ? 3 : 2, 0, 1);
+  auto items = dist.exch(roots, 1);
+  auto inverse = DistPlan<LO>(dist.invert(), 1);
+  OMEGA_H_CHECK(inverse.exch(items) == dist.invert().exch(items, 1));
+}
+
 static void test_two_ranks_dist_for_two_variable_sized_actors(CommPtr comm) {
   OMEGA_H_CHECK(comm->size() == 2);
   Dist copies2owners;
@@ -377,6 +419,64 @@ static void test_read_vtu(Library* lib, CommPtr comm) {
       OMEGA_H_SAME == compare_meshes(&mesh0, &mesh1, opts, true, false));
 }
 
+static void test_sync_plan(CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto plan = mesh.sync_plan<Real>(VERT, 2);
+  for (Int step = 0; step < 2; ++step) {
+    auto a = Reals(mesh.nverts() * 2, Real(comm->rank() + step), 1.);
+    plan.begin(a);
+    OMEGA_H_CHECK(plan.finish() == mesh.sync_array(VERT, a, 2));
+  }
+}
+
+static void test_sync_tags(CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto const n = mesh.nverts();
+  auto const rank = comm->rank();
+  mesh.add_tag(VERT, "a", 3, Reals(n * 3, Real(rank), 0.5));
+  mesh.add_tag(VERT, "b", 1, Read<I8>(n, I8(rank), 1));
+  mesh.add_tag(VERT, "c", 2, Read<I64>(n * 2, I64(rank) << 40, 3));
+  mesh.add_tag(VERT, "d", 1, LOs(n, rank, 7));
+  auto a = mesh.sync_array(VERT, mesh.get_array<Real>(VERT, "a"), 3);
+  auto b = mesh.sync_array(VERT, mesh.get_array<I8>(VERT, "b"), 1);
+  auto c = mesh.sync_array(VERT, mesh.get_array<I64>(VERT, "c"), 2);
+  auto d = mesh.sync_array(VERT, mesh.get_array<LO>(VERT, "d"), 1);
+  mesh.sync_tags(VERT, {"a", "b", "c", "d"});
+  OMEGA_H_CHECK(mesh.get_array<Real>(VERT, "a") == a);
+  OMEGA_H_CHECK(mesh.get_array<I8>(VERT, "b") == b);
+  OMEGA_H_CHECK(mesh.get_array<I64>(VERT, "c") == c);
+  OMEGA_H_CHECK(mesh.get_array<LO>(VERT, "d") == d);
+}
+
+/* both engines must find a maximal independent set across ranks,
+   judged on the owned edges, whose stars are complete */
+static void test_find_indset(CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 8, 8, 0);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto const star = mesh.ask_star(EDGE);
+  auto const owned = mesh.owned(EDGE);
+  auto const quals = Reals(mesh.nedges(), 1.0);
+  auto const cands = Read<I8>(mesh.nedges(), 1);
+  for (auto engine : {SYNCHRONOUS_INDSET, RELAXED_INDSET}) {
+    auto const keys = find_indset(&mesh, EDGE, quals, cands, engine);
+    OMEGA_H_CHECK(mesh.sync_array(EDGE, keys, 1) == keys);
+    auto const xadj = star.a2ab;
+    auto const adj = star.ab2b;
+    Write<I8> bad(mesh.nedges());
+    auto f = OMEGA_H_LAMBDA(LO e) {
+      bool has_key_neighbor = false;
+      for (auto j = xadj[e]; j < xadj[e + 1]; ++j) {
+        if (keys[adj[j]]) has_key_neighbor = true;
+      }
+      bad[e] = owned[e] && (bool(keys[e]) == has_key_neighbor);
+    };
+    parallel_for(mesh.nedges(), f);
+    OMEGA_H_CHECK(get_max(comm, Read<I8>(bad)) == 0);
+  }
+}
+
 static void test_binary_io(Library* lib, CommPtr comm) {
   auto mesh0 = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
   mesh0.set_parting(OMEGA_H_ELEM_BASED);
@@ -394,8 +494,36 @@ static void test_binary_io(Library* lib, CommPtr comm) {
       OMEGA_H_SAME == compare_meshes(&mesh0, &mesh2, opts, true, true));
 }
 
+/* the worklist limiter sends only changed metrics to the other rank,
+   yet has to agree with the sweeps which synchronize every step */
+static void test_limit_metric_gradation(CommPtr comm) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 24, 24, 0);
+  mesh.set_parting(OMEGA_H_GHOSTED);
+  auto const coords = mesh.coords();
+  Write<Real> metrics(mesh.nverts() * symm_ncomps(2));
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto const x = get_vector<2>(coords, v);
+    auto const hx = (x[0] < 0.3) ? 0.005 : 0.5;
+    auto const hy = (x[1] > 0.6) ? 0.01 : 0.3;
+    set_symm(metrics, v,
+        diagonal(vector_2(1.0 / square(hx), 1.0 / square(hy))));
+  };
+  parallel_for(mesh.nverts(), f);
+  auto const tol = 1e-3;
+  auto const by_worklist =
+      limit_metric_gradation(&mesh, Reals(metrics), 1.0, tol, false);
+  auto const by_sweeps =
+      limit_metric_gradation_by_sweeps(&mesh, Reals(metrics), 1.0, tol, false);
+  OMEGA_H_CHECK(!comm->reduce_and(are_close(by_sweeps, Reals(metrics))));
+  OMEGA_H_CHECK(comm->reduce_and(are_close(by_worklist, by_sweeps, tol)));
+  /* ghost copies hold their owners' metrics */
+  OMEGA_H_CHECK(comm->reduce_and(
+      are_close(by_worklist, mesh.sync_array(VERT, by_worklist, 3))));
+}
+
 static void test_two_ranks(Library* lib, CommPtr comm) {
   test_two_ranks_dist(comm);
+  test_two_ranks_dist_plan(comm);
   test_two_ranks_dist_for_two_variable_sized_actors(comm);
   test_two_rank_for_four_variable_sized_actors(comm);
   test_two_ranks_owners(comm);
@@ -405,6 +533,9 @@ static void test_two_ranks(Library* lib, CommPtr comm) {
   test_construct(lib, comm);
   test_read_vtu(lib, comm);
   test_binary_io(lib, comm);
+  test_sync_plan(comm);
+  test_sync_tags(comm);
+  test_limit_metric_gradation(comm);
 }
 
 void test_rib(CommPtr comm) {
@@ -437,6 +568,139 @@ void test_rib(CommPtr comm) {
   OMEGA_H_CHECK(masses == Reals(n, 1));
 }
 
+void test_multisect(CommPtr comm) {
+  auto rank = comm->rank();
+  auto size = comm->size();
+  LO n = 5;
+  Write<Real> w_coords(n * 3);
+  auto set_coords = OMEGA_H_LAMBDA(LO i) {
+    set_vector(w_coords, i, vector_3(0, i * size + rank, 0));
+  };
+  parallel_for(n, set_coords);
+  Reals coords(w_coords);
+  /* with 4 ranks the last 8 of 20 items weigh 1.5,
+     so each part should hold 6 in weight */
+  auto weight = [=](Real y) { return (size == 4 && y >= 12) ? 1.5 : 1.0; };
+  HostWrite<Real> h_weights(n);
+  for (LO i = 0; i < n; ++i) h_weights[i] = weight(i * size + rank);
+  Reals weights(h_weights.write());
+  auto owners = Remotes(Read<I32>(n, rank), LOs(n, 0, 1));
+  multisect::recursively_multisect(comm, 0.0, &coords, &weights, &owners);
+  /* each part is the slab of items whose preceding weight
+     falls in its share */
+  Real total = 0;
+  for (LO y = 0; y < n * size; ++y) total += weight(y);
+  auto const share = total / size;
+  auto const ys = HostRead<Real>(get_component(coords, 3, 1));
+  for (LO i = 0; i < ys.size(); ++i) {
+    Real preceding = 0;
+    for (LO y = 0; y < ys[i]; ++y) preceding += weight(y);
+    OMEGA_H_CHECK(I32(preceding / share) == rank);
+  }
+  OMEGA_H_CHECK(are_close(get_sum(weights), share));
+  OMEGA_H_CHECK(multisect::choose_nsections(4, 4) == 4);
+  OMEGA_H_CHECK(multisect::choose_nsections(12, 4) == 4);
+  OMEGA_H_CHECK(multisect::choose_nsections(6, 4) == 2);
+  OMEGA_H_CHECK(multisect::choose_nsections(7, 4) == 7);
+}
+
+/* refines a corner of the box, which without rebalancing
+   leaves most new elements on one rank */
+static Real adapt_corner(CommPtr comm, bool should_rebalance) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 8, 8, 0);
+  auto const coords = mesh.coords();
+  Write<Real> metrics(mesh.nverts());
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto const x = get_vector<2>(coords, v);
+    auto const h = (norm(x) < 0.3) ? 0.02 : 0.125;
+    metrics[v] = metric_eigenvalue_from_length(h);
+  };
+  parallel_for(mesh.nverts(), f);
+  mesh.add_tag(VERT, "metric", 1, Reals(metrics));
+  auto opts = AdaptOpts(&mesh);
+  opts.verbosity = SILENT;
+  opts.should_rebalance = should_rebalance;
+  opts.max_imbalance_allowed = 1.2;
+  opts.should_reorder = true;
+  OMEGA_H_CHECK(adapt(&mesh, opts));
+  OMEGA_H_CHECK(mesh.min_quality() >= opts.min_quality_allowed);
+  return mesh.imbalance();
+}
+
+static void test_adapt_rebalance(CommPtr comm) {
+  auto const without = adapt_corner(comm, false);
+  auto const with = adapt_corner(comm, true);
+  OMEGA_H_CHECK(with < without);
+}
+
+/* the owned global numbers of each dimension must be exactly
+   0 through nglobal_ents - 1, each owned by one rank */
+static void check_globals(Mesh* mesh) {
+  auto const comm = mesh->comm();
+  for (Int ent_dim = 0; ent_dim <= mesh->dim(); ++ent_dim) {
+    auto const total = mesh->nglobal_ents(ent_dim);
+    auto const globals = mesh->globals(ent_dim);
+    OMEGA_H_CHECK(get_max(comm, globals) + 1 == total);
+    auto const owned_globals =
+        unmap(collect_marked(mesh->owned(ent_dim)), globals, 1);
+    auto const nslots = linear_partition_size(comm, total);
+    auto const dist = Dist(comm,
+        globals_to_linear_owners(comm, owned_globals, total), nslots);
+    auto const slots2owned = dist.invert().roots2items();
+    OMEGA_H_CHECK(slots2owned == LOs(nslots + 1, 0, 1));
+  }
+}
+
+/* true if any rank ghosted its mesh while the history was recorded */
+static bool did_ghost(CommPtr comm, profile::History const& history) {
+  bool ghosted = false;
+  for (std::size_t i = 0; i < history.frames.size(); ++i) {
+    if (0 == std::strcmp(history.get_name(i), "ghost_mesh")) ghosted = true;
+  }
+  return comm->reduce_or(ghosted);
+}
+
+/* refines and coarsens across the part boundaries, which without ghosts
+   only happens once the elements around them have moved */
+static GO adapt_graded(CommPtr comm, bool should_adapt_unghosted) {
+  auto mesh = build_box(comm, OMEGA_H_SIMPLEX, 1., 1., 0., 8, 8, 0);
+  auto const coords = mesh.coords();
+  Write<Real> metrics(mesh.nverts());
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto const x = get_vector<2>(coords, v);
+    auto const h = 0.03 + 0.4 * std::abs(x[0] - 0.5);
+    metrics[v] = metric_eigenvalue_from_length(h);
+  };
+  parallel_for(mesh.nverts(), f);
+  mesh.add_tag(VERT, "metric", 1, Reals(metrics));
+  auto opts = AdaptOpts(&mesh);
+  opts.verbosity = SILENT;
+  opts.should_adapt_unghosted = should_adapt_unghosted;
+  auto const previous_history = profile::global_singleton_history;
+  profile::History history;
+  profile::global_singleton_history = &history;
+  auto const adapted = adapt(&mesh, opts);
+  profile::global_singleton_history = previous_history;
+  OMEGA_H_CHECK(adapted);
+  OMEGA_H_CHECK(mesh.min_quality() >= opts.min_quality_allowed);
+  OMEGA_H_CHECK(get_max(comm, mesh.ask_lengths()) <= opts.max_length_allowed);
+  check_globals(&mesh);
+  if (should_adapt_unghosted) {
+    /* the mesh stays element based from start to end */
+    OMEGA_H_CHECK(mesh.parting() == OMEGA_H_ELEM_BASED);
+    OMEGA_H_CHECK(!did_ghost(comm, history));
+  } else if (comm->size() > 1) {
+    OMEGA_H_CHECK(did_ghost(comm, history));
+  }
+  return mesh.nglobal_ents(mesh.dim());
+}
+
+static void test_adapt_unghosted(CommPtr comm) {
+  auto const ghosted = adapt_graded(comm, false);
+  auto const unghosted = adapt_graded(comm, true);
+  OMEGA_H_CHECK(std::abs(Real(unghosted - ghosted)) < 0.1 * Real(ghosted));
+}
+
 int main(int argc, char** argv) {
   auto lib = Library(&argc, &argv);
   auto world = lib.world();
@@ -456,4 +720,10 @@ int main(int argc, char** argv) {
   }
   world->barrier();
   test_rib(world);
+  test_multisect(world);
+  test_find_indset(world);
+  if (world->size() == 4) test_adapt_rebalance(world);
+  test_adapt_unghosted(world);
+  auto three = world->split(world->rank() / 3, world->rank() % 3);
+  if (world->rank() < 3 && three->size() == 3) test_multisect(three);
 }
@@ -1,5 +1,6 @@
 #include <iostream>
 
+#include <Omega_h_cmdline.hpp>
 #include <Omega_h_file.hpp>
 #include <Omega_h_library.hpp>
 #include <Omega_h_timer.hpp>
@@ -7,16 +8,20 @@
 int main(int argc, char** argv) {
   auto lib = Omega_h::Library(&argc, &argv);
   auto world = lib.world();
-  if (argc != 4) {
-    if (!world->rank()) {
-      std::cout << "usage: " << argv[0] << " in.osh <nparts> out.osh\n";
-    }
-    return -1;
-  }
+  Omega_h::CmdLine cmdline;
+  cmdline.add_arg<std::string>("in.osh");
+  cmdline.add_arg<int>("<nparts>");
+  cmdline.add_arg<std::string>("out.osh");
+  cmdline.add_flag("--multisection",
+      "partition by recursive coordinate multi-section instead of "
+      "recursive inertial bisection");
+  cmdline.add_flag("--predictive",
+      "weigh elements by the element count their \"metric\" tag implies");
+  if (!cmdline.parse_final(world, &argc, argv)) return -1;
   auto nparts_total = world->size();
-  auto path_in = argv[1];
-  auto nparts_out = atoi(argv[2]);
-  auto path_out = argv[3];
+  auto path_in = cmdline.get<std::string>("in.osh");
+  auto nparts_out = cmdline.get<int>("<nparts>");
+  auto path_out = cmdline.get<std::string>("out.osh");
   auto t0 = Omega_h::now();
   if (nparts_out < 1) {
     if (!world->rank()) {
@@ -54,7 +59,11 @@ int main(int argc, char** argv) {
   }
   if (is_in || is_out) mesh.set_comm(comm_out);
   if (is_out) {
-    if (nparts_out != nparts_in) mesh.balance();
+    if (cmdline.parsed("--multisection")) {
+      mesh.set_partitioner(OMEGA_H_MULTISECTION);
+    }
+    auto const predictive = cmdline.parsed("--predictive");
+    if (nparts_out != nparts_in || predictive) mesh.balance(predictive);
     Omega_h::binary::write(path_out, &mesh);
   }
   world->barrier();
@@ -1,18 +1,41 @@
 #include <Omega_h_cmdline.hpp>
 #include <Omega_h_file.hpp>
+#include <Omega_h_graph.hpp>
 #include <Omega_h_mesh.hpp>
 
+#include <iostream>
+
+static void print_bandwidth(Omega_h::Mesh* mesh, char const* when) {
+  auto comm = mesh->comm();
+  auto star = mesh->ask_star(Omega_h::VERT);
+  auto bandwidth = comm->allreduce(
+      Omega_h::GO(Omega_h::get_bandwidth(star)), OMEGA_H_MAX);
+  auto profile = comm->allreduce(Omega_h::get_profile(star), OMEGA_H_SUM);
+  if (!comm->rank()) {
+    std::cout << when << ": vertex bandwidth " << bandwidth << ", profile "
+              << profile << '\n';
+  }
+}
+
 int main(int argc, char** argv) {
   auto lib = Omega_h::Library(&argc, &argv);
   auto world = lib.world();
   Omega_h::CmdLine cmdline;
   cmdline.add_arg<std::string>("input.osh");
   cmdline.add_arg<std::string>("output.osh");
+  cmdline.add_flag("--rcm",
+      "reverse Cuthill-McKee vertex order instead of the Hilbert curve");
   if (!cmdline.parse_final(world, &argc, argv)) return -1;
   auto inpath = cmdline.get<std::string>("input.osh");
   auto outpath = cmdline.get<std::string>("output.osh");
   Omega_h::Mesh mesh(&lib);
   Omega_h::binary::read(inpath, world, &mesh);
-  Omega_h::reorder_by_hilbert(&mesh);
+  print_bandwidth(&mesh, "before");
+  if (cmdline.parsed("--rcm")) {
+    Omega_h::reorder_by_rcm(&mesh);
+  } else {
+    Omega_h::reorder_by_hilbert(&mesh);
+  }
+  print_bandwidth(&mesh, "after");
   Omega_h::binary::write(outpath, &mesh);
 }
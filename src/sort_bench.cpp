@@ -0,0 +1,53 @@
+#include "Omega_h_array_ops.hpp"
+#include "Omega_h_library.hpp"
+#include "Omega_h_sort.hpp"
+#include "Omega_h_timer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace Omega_h;
+
+/* compares the comparison and radix engines of sort_by_keys
+   on uniformly random keys bounded by the number of tuples,
+   like vertex indices or global numbers.
+   usage: sort_bench [min_ntuples] [max_ntuples] */
+
+template <typename T>
+static Read<T> random_keys(LO const n, Int const width) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<T> dist(0, T(n));
+  HostWrite<T> h_keys(n * width);
+  for (LO i = 0; i < n * width; ++i) h_keys[i] = dist(gen);
+  return h_keys.write();
+}
+
+template <typename T>
+static void bench(char const* type_name, LO const n, Int const width) {
+  auto const keys = random_keys<T>(n, width);
+  auto const t0 = now();
+  auto const comparison_perm = comparison_sort_by_keys(keys, width);
+  auto const t1 = now();
+  auto const radix_perm = radix_sort_by_keys(keys, width);
+  auto const t2 = now();
+  OMEGA_H_CHECK(comparison_perm == radix_perm);
+  std::cout << type_name << " n " << n << " width " << width
+            << ": comparison " << (t1 - t0) << " s, radix " << (t2 - t1)
+            << " s, speedup " << ((t1 - t0) / (t2 - t1)) << '\n';
+}
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  LO min_n = 1000 * 1000;
+  LO max_n = 10 * 1000 * 1000;
+  if (argc > 1) min_n = std::atoi(argv[1]);
+  if (argc > 2) max_n = std::atoi(argv[2]);
+  for (LO n = min_n; n <= max_n; n *= 10) {
+    for (Int width = 1; width <= 4; ++width) {
+      bench<LO>("LO", n, width);
+      bench<GO>("GO", n, width);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include "Omega_h_adj.hpp"
+#include "Omega_h_build.hpp"
+#include "Omega_h_library.hpp"
+#include "Omega_h_mesh.hpp"
+#include "Omega_h_timer.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace Omega_h;
+
+/* compares the sorting and hashing engines of find_unique
+   when deriving edges and faces from the tetrahedra of a box.
+   usage: unique_bench [nelems_per_axis] [ntrials] */
+
+static Real time_find_unique(
+    LOs const ev2v, Int const low_dim, Int const ntrials, LO* nunique) {
+  Real best = -1.0;
+  for (Int trial = 0; trial < ntrials; ++trial) {
+    auto const t0 = now();
+    auto const uv2v = find_unique(ev2v, OMEGA_H_SIMPLEX, 3, low_dim);
+    auto const t1 = now();
+    *nunique = uv2v.size() / (low_dim + 1);
+    if (best < 0.0 || (t1 - t0) < best) best = t1 - t0;
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  auto lib = Library(&argc, &argv);
+  LO n = 40;
+  Int ntrials = 3;
+  if (argc > 1) n = std::atoi(argv[1]);
+  if (argc > 2) ntrials = std::atoi(argv[2]);
+  auto mesh = build_box(lib.self(), OMEGA_H_SIMPLEX, 1., 1., 1., n, n, n);
+  auto const ev2v = mesh.ask_elem_verts();
+  std::cout << mesh.nelems() << " tets\n";
+  for (Int low_dim = 1; low_dim <= 2; ++low_dim) {
+    LO nsorted, nhashed;
+    disable_hashed_find_unique();
+    auto const sort_time = time_find_unique(ev2v, low_dim, ntrials, &nsorted);
+    enable_hashed_find_unique();
+    auto const hash_time = time_find_unique(ev2v, low_dim, ntrials, &nhashed);
+    disable_hashed_find_unique();
+    OMEGA_H_CHECK(nsorted == nhashed);
+    std::cout << (low_dim == 1 ? "edges" : "faces") << ": " << nsorted
+              << " unique, sort " << sort_time << " s, hash " << hash_time
+              << " s, speedup " << (sort_time / hash_time) << '\n';
+  }
+  return 0;
+}
@@ -7,7 +7,10 @@
 #include "Omega_h_library.hpp"
 #include "Omega_h_linpart.hpp"
 #include "Omega_h_map.hpp"
+#include "Omega_h_malloc.hpp"
 #include "Omega_h_mark.hpp"
+#include "Omega_h_pool.hpp"
+#include "Omega_h_profile.hpp"
 #include "Omega_h_sort.hpp"
 #include "Omega_h_atomics.hpp"
 #include "Omega_h_file.hpp"
@@ -69,6 +72,61 @@ static void test_sort() {
     LOs perm = sort_by_keys(a, 3);
     OMEGA_H_CHECK(perm == LOs({1, 0, 2}));
   }
+  {
+    LOs a({1, 2, 3, 1, 2, 2, 3, 0, 0});
+    OMEGA_H_CHECK(radix_sort_by_keys(a, 3) == LOs({1, 0, 2}));
+    OMEGA_H_CHECK(radix_sort_by_keys(a, 1) == comparison_sort_by_keys(a, 1));
+  }
+  {
+    Read<GO> a({-5, 3000000000, 7, -5, -70000, 3000000000});
+    OMEGA_H_CHECK(radix_sort_by_keys(a, 2) == LOs({2, 0, 1}));
+    OMEGA_H_CHECK(radix_sort_by_keys(a) == LOs({4, 0, 3, 2, 1, 5}));
+  }
+  for (Int width = 1; width <= 4; ++width) {
+    LO const n = 3 * radix_sort_min_size;
+    HostWrite<LO> h_keys(n * width);
+    for (LO i = 0; i < n * width; ++i) h_keys[i] = (i * 7919) % 1031 - 500;
+    LOs keys(h_keys.write());
+    OMEGA_H_CHECK(
+        radix_sort_by_keys(keys, width) == comparison_sort_by_keys(keys, width));
+  }
+}
+
+static void test_pool() {
+  OMEGA_H_CHECK(pool_block_size(0) == 256);
+  OMEGA_H_CHECK(pool_block_size(100) == 256);
+  OMEGA_H_CHECK(pool_block_size(257) == 320);
+  OMEGA_H_CHECK(pool_block_size(512) == 512);
+  OMEGA_H_CHECK(pool_block_size(513) == 640);
+  OMEGA_H_CHECK(pool_block_size(1000) == 1024);
+  Pool pool(host_malloc, host_free, 4096);
+  auto a = allocate(pool, 1000);
+  deallocate(pool, a, 1000);
+  auto b = allocate(pool, 900);
+  OMEGA_H_CHECK(a == b);
+  auto stats = get_stats(pool);
+  OMEGA_H_CHECK(stats.hits == 1);
+  OMEGA_H_CHECK(stats.misses == 1);
+  OMEGA_H_CHECK(stats.used_bytes == 1024);
+  OMEGA_H_CHECK(stats.waste_bytes() == 124);
+  deallocate(pool, b, 900);
+  void* c[3];
+  for (auto& p : c) p = allocate(pool, 2048);
+  for (auto p : c) deallocate(pool, p, 2048);
+  stats = get_stats(pool);
+  OMEGA_H_CHECK(stats.trimmed_blocks == 2);
+  OMEGA_H_CHECK(stats.cached_bytes == 3072);
+  OMEGA_H_CHECK(stats.high_water_bytes == 7168);
+  /* blocks adopted from another pool are freed, not cached */
+  auto d = allocate(pool, 100);
+  {
+    Pool next(host_malloc, host_free, 4096);
+    adopt_used_blocks(next, pool);
+    deallocate(next, d, 100);
+    OMEGA_H_CHECK(get_stats(next).cached_bytes == 0);
+  }
+  trim(pool);
+  OMEGA_H_CHECK(get_stats(pool).cached_bytes == 0);
 }
 
 static void test_equal() {
@@ -298,6 +356,12 @@ static void test_expr() {
   OMEGA_H_CHECK(
       are_close(any_cast<Reals>(reader.read_string("exp(x)", "test10")),
           Reals({1.0, std::exp(1.0), std::exp(2.0), std::exp(3.0)})));
+  OMEGA_H_CHECK(
+      are_close(any_cast<Reals>(reader.read_fused("v - 1.5 * j", "test11")),
+          Reals({0, -1.5, 0, 0, -0.5, 0, 0, 0.5, 0, 0, 1.5, 0})));
+  OMEGA_H_CHECK(
+      are_close(any_cast<Reals>(reader.read_fused("pi * 2", "test12")),
+          Reals(4, 3.14159 * 2)));
 }
 
 static Omega_h::any test_expr2(
@@ -348,6 +412,127 @@ static void test_expr2() {
       Reals({1.0, std::exp(1.0), std::exp(2.0), std::exp(3.0)})));
 }
 
+static Reals test_expr_program(
+    ExprEnv& env, std::string const& expr, std::string const& test_name) {
+  ExprOpsReader reader;
+  auto op = any_cast<OpPtr>(reader.read_string(expr, test_name));
+  ExprProgram program(*op, env);
+  auto fused = program.eval();
+  auto unfused = op->eval(env);
+  env.repeat(unfused);
+  OMEGA_H_CHECK(are_close(fused, any_cast<Reals>(unfused)));
+  return fused;
+}
+
+static void test_expr_program() {
+  ExprEnv env(4, 3);
+  env.register_variable("x", any(Reals({0, 1, 2, 3})));
+  env.register_variable("j", any(vector_3(0, 1, 0)));
+  env.register_variable("v", any(Reals({0, 0, 0, 0, 1, 0, 0, 2, 0, 0, 3, 0})));
+  env.register_variable("M", any(repeat_matrix(4, identity_matrix<3, 3>())));
+  env.register_variable(
+      "A", any(matrix_3x3(1, 2, 3, 4, 5, 6, 7, 8, 9)));
+  OMEGA_H_CHECK(are_close(test_expr_program(env, "1 + 1", "p0"),
+      Reals(4, 2.0)));
+  test_expr_program(env, "x^2 - 3 * x / (x + 1)", "p1");
+  test_expr_program(env, "v - 1.5 * j", "p2");
+  test_expr_program(env, "v(1) + norm(v) * exp(-x) + sqrt(x) * sin(x)", "p3");
+  test_expr_program(env, "vector(x, 0, cos(x))", "p4");
+  test_expr_program(env, "(x > 1.5) ? x : 2 * x", "p5");
+  test_expr_program(
+      env, "((x < 1.5) && (x > 0.5)) || (x > 2.5) ? x : -x", "p6");
+  test_expr_program(env, "M * v + I * j", "p7");
+  test_expr_program(env, "M * (2 * I) - M", "p8");
+  test_expr_program(env, "M(1, 1) * v * j + erf(x)", "p9");
+  test_expr_program(env, "y = x + 1; z = y * y; z - y", "p10");
+  test_expr_program(env, "matrix(1, 0, 0, 0, x, 0, 0, 0, 1) * v", "p11");
+  test_expr_program(env, "matrix(1, 2, 3, 4, 5, 6, 7, 8, 9) * v", "p12");
+  test_expr_program(env, "matrix(1, 2, 3, 4, 5, 6, 7, 8, 9)", "p12b");
+  test_expr_program(env, "matrix(1, x, 3, -x, 5, 6, 7, 8, 9) * v", "p13");
+  test_expr_program(env, "matrix(1, x, 3, -x, 5, 6, 7, 8, 9) * M", "p13b");
+  test_expr_program(
+      env, "m = matrix(1, x, 3, -x, 5, 6, 7, 8, 9); m(0, 1) + 2 * m(1, 0)", "p14");
+  test_expr_program(env, "A * v + (A(0, 1) * x - 2 * A(1, 0)) * j", "p14b");
+  {
+    /* a non-symmetric array tensor is indexed as its constant value */
+    env.register_variable(
+        "N", any(repeat_matrix(4, matrix_3x3(1, 2, 3, 4, 5, 6, 7, 8, 9))));
+    auto const expr =
+        std::string("N(0, 1) - 10 * N(1, 0) + N(2, 1) - A(0, 1)");
+    OMEGA_H_CHECK(
+        are_close(test_expr_program(env, expr, "p14c"), Reals(4, -32.0)));
+    ExprReader expr_reader(4, 3);
+    expr_reader.register_variable(
+        "N", any(repeat_matrix(4, matrix_3x3(1, 2, 3, 4, 5, 6, 7, 8, 9))));
+    expr_reader.register_variable(
+        "A", any(matrix_3x3(1, 2, 3, 4, 5, 6, 7, 8, 9)));
+    OMEGA_H_CHECK(are_close(
+        any_cast<Reals>(expr_reader.read_string(expr, "p14c")),
+        Reals(4, -32.0)));
+  }
+  {
+    ExprEnv env2(4, 2);
+    env2.register_variable("a", any(Reals({0, 1, 2, 3})));
+    env2.register_variable("b", any(Reals({4, 5, 6, 7})));
+    auto const m = test_expr_program(env2, "matrix(a, b, 2 * a, b - a)", "p15");
+    ExprReader expr_reader(4, 2);
+    expr_reader.register_variable("a", any(Reals({0, 1, 2, 3})));
+    expr_reader.register_variable("b", any(Reals({4, 5, 6, 7})));
+    auto const interpreted = any_cast<Reals>(
+        expr_reader.read_string("matrix(a, b, 2 * a, b - a)", "p15"));
+    OMEGA_H_CHECK(are_close(m, interpreted));
+    ExprOpsReader ops_reader;
+    auto const op = ops_reader.read_ops("matrix(a, b, 2 * a, b - a)");
+    OMEGA_H_CHECK(are_close(any_cast<Reals>(eval_fused(op, env2)),
+        interpreted));
+  }
+  ExprOpsReader reader;
+  auto op = reader.read_ops("symm(M)");
+  bool threw = false;
+  try {
+    ExprProgram program(*op, env);
+  } catch (ParserFail const&) {
+    threw = true;
+  }
+  OMEGA_H_CHECK(threw);
+  OMEGA_H_CHECK(any_cast<Reals>(eval_fused(op, env)).size() == 4 * 6);
+  env.register_function("twice",
+      [](ExprEnv::Args& args) { return any(2.0 * any_cast<Real>(args[0])); });
+  auto twice = reader.read_ops("twice(3)");
+  OMEGA_H_CHECK(are_close(any_cast<Reals>(eval_fused(twice, env)),
+      Reals(4, 6.0)));
+}
+
+static void test_kernel_counters() {
+  auto const previous_history = profile::global_singleton_history;
+  auto const previous_counters = profile::global_kernel_counters;
+  profile::History history;
+  profile::KernelCounters counters;
+  profile::global_singleton_history = &history;
+  profile::global_kernel_counters = &counters;
+  {
+    ScopedTimer timer("kernel counters test");
+    Write<Real> a(100);
+    auto f = OMEGA_H_LAMBDA(LO i) { a[i] = Real(i); };
+    parallel_for(100, f, "counted kernel");
+    parallel_for(50, f, "counted kernel");
+  }
+  profile::global_singleton_history = previous_history;
+  profile::global_kernel_counters = previous_counters;
+  auto const outer = history.find_root("kernel counters test");
+  OMEGA_H_CHECK(outer != profile::invalid);
+  auto const kernel = history.find_child_of(outer, "counted kernel");
+  OMEGA_H_CHECK(kernel != profile::invalid);
+  auto const& counts = history.frames[kernel].counts;
+  OMEGA_H_CHECK(counts.kernels == 2);
+  OMEGA_H_CHECK(counts.items == 150);
+  OMEGA_H_CHECK(counts.allocated_bytes == 100 * sizeof(Real));
+  OMEGA_H_CHECK(history.calls(kernel) == 2);
+  auto const inverted = invert(history);
+  auto const inverted_kernel = inverted.find_root("counted kernel");
+  OMEGA_H_CHECK(inverted.frames[inverted_kernel].counts.items == 150);
+}
+
 static void test_array_from_kokkos() {
 #ifdef OMEGA_H_USE_KOKKOS
   View<double**> managed(
@@ -376,6 +561,7 @@ int main(int argc, char** argv) {
   test_int128();
   test_repro_sum();
   test_sort();
+  test_pool();
   test_fan_and_funnel();
   test_permute();
   test_invert_map();
@@ -389,6 +575,8 @@ int main(int argc, char** argv) {
   test_scalar_ptr();
   test_expr();
   test_expr2();
+  test_expr_program();
+  test_kernel_counters();
   test_array_from_kokkos();
   fprintf(stderr, "done\n");
   return 0;
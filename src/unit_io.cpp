@@ -5,8 +5,11 @@
 #include <numeric>
 
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_base64.hpp"
 #include "Omega_h_build.hpp"
 #include "Omega_h_compare.hpp"
+#include "Omega_h_profile.hpp"
+#include "Omega_h_shape.hpp"
 #include "Omega_h_vtk.hpp"
 #include "Omega_h_xml_lite.hpp"
 
@@ -1139,7 +1142,8 @@ $Elements
 $EndElements
 )GMSH";
 
-static void test_file_components(bool is_compressed, bool needs_swapping) {
+static void test_file_components(
+    I8 compression, bool needs_swapping, bool is_aligned = false) {
   using namespace binary;
   std::stringstream stream;
   std::string s = "foo";
@@ -1153,13 +1157,13 @@ static void test_file_components(bool is_compressed, bool needs_swapping) {
   Real d = 4.2;
   write_value(stream, d, needs_swapping);
   Read<I8> aa(n, 0, a);
-  write_array(stream, aa, is_compressed, needs_swapping);
+  write_array(stream, aa, compression, needs_swapping, is_aligned);
   Read<I32> ab(n, 0, b);
-  write_array(stream, ab, is_compressed, needs_swapping);
+  write_array(stream, ab, compression, needs_swapping, is_aligned);
   Read<I64> ac(n, 0, c);
-  write_array(stream, ac, is_compressed, needs_swapping);
+  write_array(stream, ac, compression, needs_swapping, is_aligned);
   Read<Real> ad(n, 0, d);
-  write_array(stream, ad, is_compressed, needs_swapping);
+  write_array(stream, ad, compression, needs_swapping, is_aligned);
   write(stream, s, needs_swapping);
   I8 a2;
   read_value(stream, a2, needs_swapping);
@@ -1174,38 +1178,62 @@ static void test_file_components(bool is_compressed, bool needs_swapping) {
   read_value(stream, d2, needs_swapping);
   OMEGA_H_CHECK(d == d2);
   Read<I8> aa2;
-  read_array(stream, aa2, is_compressed, needs_swapping);
+  read_array(stream, aa2, compression, needs_swapping, is_aligned);
   OMEGA_H_CHECK(aa2 == aa);
   Read<I32> ab2;
-  read_array(stream, ab2, is_compressed, needs_swapping);
+  read_array(stream, ab2, compression, needs_swapping, is_aligned);
   OMEGA_H_CHECK(ab2 == ab);
   Read<I64> ac2;
-  read_array(stream, ac2, is_compressed, needs_swapping);
+  read_array(stream, ac2, compression, needs_swapping, is_aligned);
   OMEGA_H_CHECK(ac2 == ac);
   Read<Real> ad2;
-  read_array(stream, ad2, is_compressed, needs_swapping);
+  read_array(stream, ad2, compression, needs_swapping, is_aligned);
   OMEGA_H_CHECK(ad2 == ad);
   std::string s2;
   read(stream, s2, needs_swapping);
   OMEGA_H_CHECK(s == s2);
 }
 
+/* arrays spanning several compression chunks, with a partial last chunk */
+static void test_chunked_compression(I8 compression, bool needs_swapping) {
+  using namespace binary;
+  std::stringstream stream;
+  auto const n = LO(2 * compression_chunk_bytes / sizeof(Real) + 7);
+  Read<Real> a(n, 0.0, 0.5);
+  Read<LO> b(n, 3, 2);
+  write_array(stream, a, compression, needs_swapping);
+  write_array(stream, b, compression, needs_swapping);
+  Read<Real> a2;
+  read_array(stream, a2, compression, needs_swapping);
+  OMEGA_H_CHECK(a2 == a);
+  Read<LO> b2;
+  read_array(stream, b2, compression, needs_swapping);
+  OMEGA_H_CHECK(b2 == b);
+}
+
 static void test_file_components() {
-  test_file_components(false, false);
-  test_file_components(false, true);
-#ifdef OMEGA_H_USE_ZLIB
-  test_file_components(true, false);
-  test_file_components(true, true);
-#endif
+  using namespace binary;
+  test_file_components(COMPRESSION_NONE, false);
+  test_file_components(COMPRESSION_NONE, true);
+  test_file_components(COMPRESSION_NONE, false, true);
+  test_file_components(COMPRESSION_NONE, true, true);
+  for (I8 compression :
+      {COMPRESSION_ZLIB_WHOLE, COMPRESSION_ZLIB, COMPRESSION_ZSTD}) {
+    if (!can_compress(compression)) continue;
+    test_file_components(compression, false);
+    test_file_components(compression, true);
+    test_chunked_compression(compression, false);
+    test_chunked_compression(compression, true);
+  }
 }
 
 static void build_empty_mesh(Mesh* mesh, Int dim) {
   build_from_elems_and_coords(mesh, OMEGA_H_SIMPLEX, dim, LOs({}), Reals({}));
 }
 
-static void test_file(Library* lib, Mesh* mesh0) {
+static void test_file(Library* lib, Mesh* mesh0, bool aligned) {
   std::stringstream stream;
-  binary::write(stream, mesh0);
+  binary::write(stream, mesh0, aligned);
   Mesh mesh1(lib);
   mesh1.set_comm(lib->self());
   binary::read(stream, &mesh1, binary::latest_version);
@@ -1215,16 +1243,143 @@ static void test_file(Library* lib, Mesh* mesh0) {
   OMEGA_H_CHECK(*mesh0 == mesh1);
 }
 
-static void test_file(Library* lib) {
-  {
-    auto mesh0 = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 1, 1, 1);
-    test_file(lib, &mesh0);
+static void test_mapped_file(Library* lib) {
+  auto mesh0 = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  binary::write("mapped.osh", &mesh0, true);
+  auto mesh1 = binary::read_mapped("mapped.osh", lib->world(), true);
+  auto opts = MeshCompareOpts::init(&mesh0, VarCompareOpts::zero_tolerance());
+  OMEGA_H_CHECK(
+      compare_meshes(&mesh0, &mesh1, opts, true, true) == OMEGA_H_SAME);
+  /* mapped arrays must survive both the reader and later modification */
+  auto coords = deep_copy(mesh1.coords());
+  mesh1.set_coords(coords);
+  OMEGA_H_CHECK(mesh0 == mesh1);
+}
+
+static void test_async_file(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  Mesh expected = mesh;
+  auto future = binary::write_async("async.osh", &mesh);
+  /* the checkpoint is a snapshot: later changes must not reach it */
+  mesh.add_tag(VERT, "after", 1, Reals(mesh.nverts(), 1.0));
+  mesh.set_coords(multiply_each_by(mesh.coords(), 2.0));
+  future.get();
+  OMEGA_H_CHECK(future.completed());
+  auto written = binary::read("async.osh", lib->world(), true);
+  OMEGA_H_CHECK(!written.has_tag(VERT, "after"));
+  auto opts =
+      MeshCompareOpts::init(&expected, VarCompareOpts::zero_tolerance());
+  OMEGA_H_CHECK(
+      compare_meshes(&expected, &written, opts, true, true) == OMEGA_H_SAME);
+}
+
+template <typename T>
+static promoted_t<T> owned_sum(Mesh* mesh, Int dim, std::string const& name) {
+  auto const tag = mesh->get_tag<T>(dim, name);
+  return get_sum(mesh->comm(),
+      mesh->owned_array(dim, tag->array(), tag->ncomps()));
+}
+
+static void test_chrome_trace(Library* lib) {
+  auto comm = lib->world();
+  auto const previous = profile::global_singleton_trace;
+  profile::Trace trace(comm, "", 8);
+  profile::global_singleton_trace = &trace;
+  for (int i = 0; i < 5; ++i) {
+    ScopedTimer outer("trace outer");
+    ScopedTimer inner("trace \"inner\"");
   }
+  profile::global_singleton_trace = previous;
+  OMEGA_H_CHECK(trace.nrecorded == 10);
+  OMEGA_H_CHECK(trace.events.size() == 8);
+  OMEGA_H_CHECK(trace.ndropped() == 2);
+  for (auto const& event : trace.events) {
+    OMEGA_H_CHECK(event.thread >= 0);
+    OMEGA_H_CHECK(event.start >= 0.0);
+    OMEGA_H_CHECK(event.duration >= 0.0);
+  }
+  /* names are cached per thread by pointer: a new trace and a
+     reused buffer must still record the right names */
   {
-    Mesh mesh0(lib);
-    build_empty_mesh(&mesh0, 3);
-    test_file(lib, &mesh0);
+    profile::Trace second(comm, "", 8);
+    profile::global_singleton_trace = &second;
+    char buffer[] = "first";
+    { ScopedTimer timer(buffer); }
+    buffer[0] = 'w';
+    { ScopedTimer timer(buffer); }
+    { ScopedTimer timer("trace outer"); }
+    profile::global_singleton_trace = previous;
+    OMEGA_H_CHECK(second.events.size() == 3);
+    auto const name = [&](int i) {
+      return std::string(second.names.get(second.events[i].name_ptr));
+    };
+    OMEGA_H_CHECK(name(0) == "first");
+    OMEGA_H_CHECK(name(1) == "wirst");
+    OMEGA_H_CHECK(name(2) == "trace outer");
   }
+  profile::write_chrome_trace(trace, "chrome_trace.json");
+  if (comm->rank() != 0) return;
+  std::ifstream file("chrome_trace.json");
+  std::string const text((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  OMEGA_H_CHECK(text.find("{\"traceEvents\":[\n") == 0);
+  OMEGA_H_CHECK(text.find("\"name\":\"trace outer\"") != std::string::npos);
+  OMEGA_H_CHECK(
+      text.find("\"name\":\"trace \\\"inner\\\"\"") != std::string::npos);
+  OMEGA_H_CHECK(text.find(",\n]") == std::string::npos);
+  for (int rank = 0; rank < comm->size(); ++rank) {
+    auto const name = "\"name\":\"rank " + std::to_string(rank) + "\"";
+    OMEGA_H_CHECK(text.find(name) != std::string::npos);
+  }
+  auto const dropped =
+      "\"dropped_events\":" + std::to_string(2 * comm->size()) + "}";
+  OMEGA_H_CHECK(text.find(dropped) != std::string::npos);
+}
+
+static void test_shared_file(Mesh* mesh0, CommPtr comm) {
+  auto mesh1 = binary::read_shared("shared.oshs", comm);
+  OMEGA_H_CHECK(mesh1.comm() == comm);
+  for (Int d = 0; d <= mesh0->dim(); ++d) {
+    OMEGA_H_CHECK(mesh1.nglobal_ents(d) == mesh0->nglobal_ents(d));
+    OMEGA_H_CHECK(owned_sum<I8>(&mesh1, d, "class_dim") ==
+                  owned_sum<I8>(mesh0, d, "class_dim"));
+    OMEGA_H_CHECK(owned_sum<ClassId>(&mesh1, d, "class_id") ==
+                  owned_sum<ClassId>(mesh0, d, "class_id"));
+  }
+  OMEGA_H_CHECK(are_close(owned_sum<Real>(&mesh1, VERT, "coordinates"),
+      owned_sum<Real>(mesh0, VERT, "coordinates")));
+  /* edges are matched to the file by their vertices */
+  OMEGA_H_CHECK(are_close(mesh1.get_array<Real>(EDGE, "file_length"),
+      measure_edges_real(&mesh1)));
+  auto const& set = mesh1.class_sets["bottom"];
+  OMEGA_H_CHECK(set.size() == 1 && set[0].dim == 2 && set[0].id == 4);
+}
+
+static void test_shared_file(Library* lib) {
+  auto mesh0 = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 2, 2, 2);
+  mesh0.add_tag(EDGE, "file_length", 1, measure_edges_real(&mesh0));
+  mesh0.class_sets["bottom"].push_back(ClassPair(2, 4));
+  binary::write_shared("shared.oshs", &mesh0);
+  /* read back with the writing ranks, and with every rank alone */
+  test_shared_file(&mesh0, lib->world());
+  test_shared_file(&mesh0, lib->self());
+}
+
+static void test_file(Library* lib) {
+  for (bool aligned : {false, true}) {
+    {
+      auto mesh0 =
+          build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 1, 1, 1);
+      test_file(lib, &mesh0, aligned);
+    }
+    {
+      Mesh mesh0(lib);
+      build_empty_mesh(&mesh0, 3);
+      test_file(lib, &mesh0, aligned);
+    }
+  }
+  test_mapped_file(lib);
+  test_async_file(lib);
 }
 
 template <typename T>
@@ -1439,6 +1594,34 @@ static void test_gmsh(Library* lib) {
   }
 }
 
+static void test_base64() {
+  OMEGA_H_CHECK(base64::encode("Man", 3) == "TWFu");
+  OMEGA_H_CHECK(base64::encode("Ma", 2) == "TWE=");
+  OMEGA_H_CHECK(base64::encode("M", 1) == "TQ==");
+  /* every engine must agree with the scalar one on all tail lengths */
+  std::vector<unsigned char> data(200);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<unsigned char>(i * 97 + 13);
+  }
+  for (std::size_t size = 0; size <= data.size(); ++size) {
+    std::string scalar(base64::encoded_size(size), '\0');
+    base64::encode(data.data(), size, &scalar[0], base64::SCALAR);
+    for (Int e = base64::SCALAR; e <= base64::best_engine(); ++e) {
+      auto const engine = base64::Engine(e);
+      std::string text(base64::encoded_size(size), '\0');
+      base64::encode(data.data(), size, &text[0], engine);
+      OMEGA_H_CHECK(text == scalar);
+      std::vector<unsigned char> decoded(size);
+      base64::decode(text.data(), decoded.data(), size, engine);
+      OMEGA_H_CHECK(std::equal(decoded.begin(), decoded.end(), data.begin()));
+    }
+    std::stringstream stream;
+    base64::write_encoded(stream, data.data(), size);
+    stream << '\n';
+    OMEGA_H_CHECK(base64::read_encoded(stream) == scalar);
+  }
+}
+
 static void test_xml() {
   xml_lite::Tag tag;
   OMEGA_H_CHECK(!xml_lite::parse_tag("AQAAAAAAAADABg", &tag));
@@ -1459,12 +1642,17 @@ static void test_xml() {
   OMEGA_H_CHECK(tag.type == xml_lite::Tag::END);
 }
 
-static void test_read_vtu(Mesh* mesh0) {
+static void test_read_vtu(Mesh* mesh0, bool compress, bool appended) {
   std::stringstream stream;
-  vtk::write_vtu(
-      stream, mesh0, mesh0->dim(), vtk::get_all_vtk_tags(mesh0, mesh0->dim()));
+  vtk::write_vtu(stream, mesh0, mesh0->dim(),
+      vtk::get_all_vtk_tags(mesh0, mesh0->dim()), compress, appended);
+  OMEGA_H_CHECK(
+      appended == (stream.str().find("<AppendedData") != std::string::npos));
   Mesh mesh1(mesh0->library());
   vtk::read_vtu(stream, mesh0->comm(), &mesh1);
+  /* the reader consumed the file through </VTKFile> */
+  stream >> std::ws;
+  OMEGA_H_CHECK(stream.peek() == std::char_traits<char>::eof());
   auto opts = MeshCompareOpts::init(mesh0, VarCompareOpts::zero_tolerance());
   OMEGA_H_CHECK(
       OMEGA_H_SAME == compare_meshes(mesh0, &mesh1, opts, true, false));
@@ -1472,7 +1660,9 @@ static void test_read_vtu(Mesh* mesh0) {
 
 static void test_read_vtu(Library* lib) {
   auto mesh0 = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 1., 1, 1, 1);
-  test_read_vtu(&mesh0);
+  test_read_vtu(&mesh0, OMEGA_H_DEFAULT_COMPRESS, vtk::dont_append);
+  test_read_vtu(&mesh0, vtk::dont_compress, vtk::do_append);
+  test_read_vtu(&mesh0, OMEGA_H_DEFAULT_COMPRESS, vtk::do_append);
 }
 
 int main(int argc, char** argv) {
@@ -1481,9 +1671,12 @@ int main(int argc, char** argv) {
   if (lib.world()->size() == 1) {
     test_file_components();
     test_file(&lib);
+    test_base64();
     test_xml();
     test_read_vtu(&lib);
   }
+  test_shared_file(&lib);
+  test_chrome_trace(&lib);
   test_gmsh(&lib);
 #if defined(OMEGA_H_USE_GMSH) && defined(OMEGA_H_USE_MPI)
   test_gmsh_parallel(&lib);
@@ -1,23 +1,37 @@
 #include "Omega_h_align.hpp"
 #include "Omega_h_array_ops.hpp"
+#include "Omega_h_adapt.hpp"
 #include "Omega_h_bbox.hpp"
 #include "Omega_h_build.hpp"
+#include "Omega_h_coarsen.hpp"
 #include "Omega_h_compare.hpp"
 #include "Omega_h_confined.hpp"
+#include "Omega_h_element.hpp"
 #include "Omega_h_for.hpp"
+#include "Omega_h_graph.hpp"
 #include "Omega_h_hilbert.hpp"
 #include "Omega_h_hypercube.hpp"
+#include "Omega_h_indset.hpp"
 #include "Omega_h_inertia.hpp"
 #include "Omega_h_int_scan.hpp"
+#include "Omega_h_laplace.hpp"
+#include "Omega_h_map.hpp"
+#include "Omega_h_mark.hpp"
 #include "Omega_h_mesh.hpp"
+#include "Omega_h_modify.hpp"
+#include "Omega_h_profile.hpp"
 #include "Omega_h_quality.hpp"
 #include "Omega_h_recover.hpp"
+#include "Omega_h_refine.hpp"
 #include "Omega_h_refine_qualities.hpp"
 #include "Omega_h_shape.hpp"
+#include "Omega_h_swap.hpp"
 #include "Omega_h_swap2d.hpp"
 #include "Omega_h_swap3d_choice.hpp"
 #include "Omega_h_swap3d_loop.hpp"
+#include "Omega_h_unmap_mesh.hpp"
 
+#include <cstring>
 #include <sstream>
 
 using namespace Omega_h;
@@ -206,6 +220,13 @@ static void test_find_unique() {
   auto a = find_unique(LOs({0, 1, 2, 3}), OMEGA_H_HYPERCUBE, 2, 1);
   OMEGA_H_CHECK(find_unique(LOs({0, 1, 2, 3}), OMEGA_H_HYPERCUBE, 2, 1) ==
                 LOs({0, 1, 3, 0, 1, 2, 2, 3}));
+  enable_hashed_find_unique();
+  OMEGA_H_CHECK(find_unique(LOs({}), OMEGA_H_SIMPLEX, 3, 2) == LOs({}));
+  OMEGA_H_CHECK(find_unique(LOs({0, 1, 2, 2, 3, 0}), OMEGA_H_SIMPLEX, 2, 1) ==
+                LOs({0, 1, 1, 2, 2, 3, 3, 0, 0, 2}));
+  OMEGA_H_CHECK(find_unique(LOs({0, 1, 2, 3}), OMEGA_H_HYPERCUBE, 2, 1) ==
+                LOs({0, 1, 1, 2, 2, 3, 3, 0}));
+  disable_hashed_find_unique();
 }
 
 static void test_hilbert() {
@@ -408,6 +429,51 @@ static void test_mark_up_down(Library* lib) {
       mark_up(&mesh, VERT, FACE, Read<I8>({0, 1, 0, 0})) == Read<I8>({1, 0}));
 }
 
+static void check_carried_up_adjs(Mesh* mesh) {
+  for (Int dim = 1; dim <= mesh->dim(); ++dim) {
+    OMEGA_H_CHECK(mesh->has_adj(dim - 1, dim));
+    auto const carried = mesh->get_adj(dim - 1, dim);
+    auto const derived = invert_adj(mesh->ask_down(dim, dim - 1),
+        element_degree(mesh->family(), dim, dim - 1), mesh->nents(dim - 1),
+        dim, dim - 1);
+    OMEGA_H_CHECK(carried.a2ab == derived.a2ab);
+    OMEGA_H_CHECK(carried.ab2b == derived.ab2b);
+    OMEGA_H_CHECK(carried.codes == derived.codes);
+  }
+}
+
+static void test_incremental_up_adjs(Library* lib, Int dim) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., dim == 3 ? 1. : 0.,
+      2, 2, dim == 3 ? 2 : 0);
+  auto const opts = AdaptOpts(&mesh);
+  enable_incremental_up_adjs();
+  for (auto const metric : {16.0, 1.0}) {
+    mesh.remove_tag(EDGE, "length");
+    mesh.remove_tag(VERT, "metric");
+    mesh.add_tag(VERT, "metric", 1, Reals(mesh.nverts(), metric));
+    for (Int d = 1; d <= dim; ++d) mesh.ask_up(d - 1, d);
+    if (metric > 1.0) {
+      OMEGA_H_CHECK(refine_by_size(&mesh, opts));
+    } else {
+      OMEGA_H_CHECK(coarsen_by_size(&mesh, opts));
+    }
+    check_carried_up_adjs(&mesh);
+  }
+  /* refining near one side leaves most rows to be copied */
+  HostRead<Real> coords(mesh.coords());
+  HostWrite<Real> metrics(mesh.nverts());
+  for (LO v = 0; v < mesh.nverts(); ++v) {
+    metrics[v] = (coords[v * dim] < 0.25) ? 16.0 : 1.0;
+  }
+  mesh.remove_tag(EDGE, "length");
+  mesh.remove_tag(VERT, "metric");
+  mesh.add_tag(VERT, "metric", 1, Reals(metrics.write()));
+  for (Int d = 1; d <= dim; ++d) mesh.ask_up(d - 1, d);
+  OMEGA_H_CHECK(refine_by_size(&mesh, opts));
+  check_carried_up_adjs(&mesh);
+  disable_incremental_up_adjs();
+}
+
 static void test_compare_meshes(Library* lib) {
   auto a = build_box(lib->world(), OMEGA_H_SIMPLEX, 1., 1., 0., 4, 4, 0);
   OMEGA_H_CHECK(a == a);
@@ -597,6 +663,266 @@ static void test_1d_box(Library* lib) {
   auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1, 0, 0, 4, 0, 0);
 }
 
+static void test_reorder_by_elements(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1, 1, 0, 8, 8, 0);
+  auto const original = mesh;
+  auto const ordered = get_locality(&mesh);
+  /* reverse the vertices, leaving the other entities as they are */
+  LOs new_ents2old_ents[4];
+  new_ents2old_ents[VERT] = LOs(mesh.nverts(), mesh.nverts() - 1, -1);
+  for (Int d = 1; d <= mesh.dim(); ++d) {
+    new_ents2old_ents[d] = LOs(mesh.nents(d), 0, 1);
+  }
+  unmap_mesh(&mesh, new_ents2old_ents);
+  auto const reversed = get_locality(&mesh);
+  OMEGA_H_CHECK(reversed > 2.0 * ordered);
+  OMEGA_H_CHECK(reorder_for_locality(&mesh, 1.5));
+  OMEGA_H_CHECK(get_locality(&mesh) < 1.5 * ordered);
+  OMEGA_H_CHECK(!reorder_for_locality(&mesh, 1.5));
+  /* vertices come in the order the elements first use them */
+  auto const ev2v = mesh.ask_elem_verts();
+  OMEGA_H_CHECK(ev2v.get(0) == 0);
+  OMEGA_H_CHECK(ev2v.get(1) == 1);
+  OMEGA_H_CHECK(ev2v.get(2) == 2);
+  auto opts = MeshCompareOpts::init(&mesh, VarCompareOpts::zero_tolerance());
+  auto copy = original;
+  OMEGA_H_CHECK(OMEGA_H_SAME == compare_meshes(&copy, &mesh, opts, true));
+}
+
+static void test_reorder_by_rcm(Library* lib) {
+  /* the path 1 - 3 - 0 - 2, with a second component 4 - 5 */
+  auto const path =
+      Graph(LOs({0, 2, 3, 4, 6, 7, 8}), LOs({3, 2, 3, 0, 1, 0, 5, 4}));
+  OMEGA_H_CHECK(get_bandwidth(path) == 3);
+  auto const new2old = reverse_cuthill_mckee(path);
+  OMEGA_H_CHECK(new2old == LOs({5, 4, 2, 0, 3, 1}));
+  auto const old2new = invert_permutation(new2old);
+  auto const new_path = unmap_graph(new2old,
+      Graph(path.a2ab, unmap(path.ab2b, old2new, 1)));
+  OMEGA_H_CHECK(get_bandwidth(new_path) == 1);
+  OMEGA_H_CHECK(get_profile(new_path) == 4);
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1, 1, 0, 8, 8, 0);
+  auto const original = mesh;
+  auto const bandwidth = get_bandwidth(mesh.ask_star(VERT));
+  auto const profile = get_profile(mesh.ask_star(VERT));
+  reorder_by_rcm(&mesh);
+  OMEGA_H_CHECK(get_bandwidth(mesh.ask_star(VERT)) < bandwidth);
+  OMEGA_H_CHECK(get_profile(mesh.ask_star(VERT)) < profile);
+  auto opts = MeshCompareOpts::init(&mesh, VarCompareOpts::zero_tolerance());
+  auto copy = original;
+  OMEGA_H_CHECK(OMEGA_H_SAME == compare_meshes(&copy, &mesh, opts, true));
+}
+
+static void test_elem_vert_caching(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1, 1, 1, 3, 3, 3);
+  auto coords = mesh.coords();
+  Write<Real> metrics(mesh.nverts() * symm_ncomps(3));
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto x = get_vector<3>(coords, v);
+    auto m = diagonal(vector_3(1.0 + x[0], 2.0 + x[1] * x[2], 3.0));
+    set_symm(metrics, v, m);
+  };
+  parallel_for(mesh.nverts(), f);
+  mesh.add_tag(VERT, "metric", symm_ncomps(3), Reals(metrics));
+  auto const quals = measure_qualities(&mesh);
+  auto const sizes = measure_elements_real(&mesh);
+  auto const implied = get_element_implied_length_metrics(&mesh);
+  mesh.set_elem_vert_caching(true);
+  OMEGA_H_CHECK(
+      mesh.ask_elem_coords() == Reals(unmap(mesh.ask_elem_verts(), coords, 3)));
+  OMEGA_H_CHECK(measure_qualities(&mesh) == quals);
+  OMEGA_H_CHECK(measure_elements_real(&mesh) == sizes);
+  OMEGA_H_CHECK(get_element_implied_length_metrics(&mesh) == implied);
+  /* the copies follow changes to the coordinates and the metric */
+  mesh.set_coords(multiply_each_by(coords, 2.0));
+  OMEGA_H_CHECK(are_close(measure_elements_real(&mesh),
+      multiply_each_by(sizes, 8.0)));
+  auto const identity = repeat_symm(mesh.nverts(), identity_matrix<3, 3>());
+  mesh.set_tag(VERT, "metric", identity);
+  OMEGA_H_CHECK(measure_qualities(&mesh) ==
+                measure_qualities(&mesh, LOs(mesh.nelems(), 0, 1), identity));
+}
+
+static void test_solve_laplacian(Library* lib, Int dim, bool use_multigrid) {
+  auto const n = (dim == 3) ? 10 : 16;
+  auto mesh = build_box(
+      lib->world(), OMEGA_H_SIMPLEX, 1, 1, dim - 2, n, n, (dim == 3) ? n : 0);
+  /* linear fields are averages of their values at the (symmetric)
+     neighbors of each interior vertex of a box */
+  auto coords = mesh.coords();
+  auto interior = mark_by_class_dim(&mesh, VERT, dim);
+  Write<Real> exact(mesh.nverts() * 2);
+  Write<Real> initial(mesh.nverts() * 2);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    Real x[2] = {coords[v * dim] + 2.0 * coords[v * dim + 1],
+        1.0 - coords[v * dim + dim - 1]};
+    for (Int c = 0; c < 2; ++c) {
+      exact[v * 2 + c] = x[c];
+      initial[v * 2 + c] = interior[v] ? 0.0 : x[c];
+    }
+  };
+  parallel_for(mesh.nverts(), f);
+  auto solution = solve_laplacian(&mesh, initial, 2, 1e-12, 1e-14,
+      use_multigrid);
+  OMEGA_H_CHECK(are_close(solution, Reals(exact), 1e-9, 1e-9));
+}
+
+/* a metric jumping from h = 0.005 to h = 0.5 across x = 0.3, and
+   (if anisotropic) in y across y = 0.6, which gradation limiting
+   spreads over many vertices */
+static Reals get_jump_metric(Mesh* mesh, bool is_aniso) {
+  auto const dim = mesh->dim();
+  auto const coords = mesh->coords();
+  auto const ncomps = is_aniso ? symm_ncomps(dim) : 1;
+  Write<Real> metrics(mesh->nverts() * ncomps);
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto const hx = (coords[v * dim] < 0.3) ? 0.005 : 0.5;
+    auto const hy = (coords[v * dim + 1] > 0.6) ? 0.01 : 0.3;
+    if (!is_aniso) {
+      metrics[v] = 1.0 / square(hx);
+    } else if (dim == 2) {
+      set_symm(metrics, v,
+          diagonal(vector_2(1.0 / square(hx), 1.0 / square(hy))));
+    } else {
+      set_symm(metrics, v,
+          diagonal(vector_3(1.0 / square(hx), 1.0 / square(hy), 1.0)));
+    }
+  };
+  parallel_for(mesh->nverts(), f);
+  return metrics;
+}
+
+static void test_limit_metric_gradation(Library* lib, Int dim, bool is_aniso) {
+  auto const n = (dim == 3) ? 8 : 24;
+  auto mesh = build_box(
+      lib->world(), OMEGA_H_SIMPLEX, 1, 1, dim - 2, n, n, (dim == 3) ? n : 0);
+  auto const metrics = get_jump_metric(&mesh, is_aniso);
+  auto const tol = 1e-3;
+  auto const by_worklist =
+      limit_metric_gradation(&mesh, metrics, 1.0, tol, false);
+  auto const by_sweeps =
+      limit_metric_gradation_by_sweeps(&mesh, metrics, 1.0, tol, false);
+  OMEGA_H_CHECK(!are_close(by_sweeps, metrics));
+  /* both stop once no metric would change by more than tol */
+  OMEGA_H_CHECK(are_close(by_worklist, by_sweeps, tol));
+}
+
+static void test_find_indset(Library* lib) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1, 1, 0, 16, 16, 0);
+  auto const star = mesh.ask_star(EDGE);
+  /* equal qualities everywhere: only the tiebreakers decide */
+  auto const quals = Reals(mesh.nedges(), 1.0);
+  auto const cands = Read<I8>(mesh.nedges(), 1);
+  Int nrounds[2];
+  for (auto engine : {SYNCHRONOUS_INDSET, RELAXED_INDSET}) {
+    auto const stats0 = get_indset_stats();
+    auto const keys = find_indset(&mesh, EDGE, quals, cands, engine);
+    nrounds[engine] = get_indset_stats().nrounds - stats0.nrounds;
+    auto const xadj = star.a2ab;
+    auto const adj = star.ab2b;
+    Write<I8> bad(mesh.nedges());
+    auto f = OMEGA_H_LAMBDA(LO e) {
+      bool has_key_neighbor = false;
+      for (auto j = xadj[e]; j < xadj[e + 1]; ++j) {
+        if (keys[adj[j]]) has_key_neighbor = true;
+      }
+      /* independent and maximal */
+      bad[e] = (bool(keys[e]) == has_key_neighbor);
+    };
+    parallel_for(mesh.nedges(), f);
+    OMEGA_H_CHECK(get_max(Read<I8>(bad)) == 0);
+  }
+  OMEGA_H_CHECK(nrounds[RELAXED_INDSET] < nrounds[SYNCHRONOUS_INDSET]);
+}
+
+/* an anisotropic metric, finer across x = 0.5, whose refinement
+   leaves slivers to be swapped */
+static Mesh build_sliver_box(Library* lib, Int dim) {
+  auto mesh = build_box(lib->world(), OMEGA_H_SIMPLEX, 1, 1, dim - 2, 4, 4,
+      (dim == 3) ? 4 : 0);
+  auto coords = mesh.coords();
+  Write<Real> metrics(mesh.nverts() * symm_ncomps(dim));
+  auto f = OMEGA_H_LAMBDA(LO v) {
+    auto const hx =
+        min2(0.04 + 0.34 * std::abs(coords[v * dim] - 0.5), 0.125);
+    auto const across = metric_eigenvalue_from_length(hx);
+    auto const along = metric_eigenvalue_from_length(0.125);
+    if (dim == 3) {
+      set_symm(metrics, v, diagonal(vector_3(across, along, along)));
+    } else {
+      set_symm(metrics, v, diagonal(vector_2(across, along)));
+    }
+  };
+  parallel_for(mesh.nverts(), f);
+  mesh.add_tag(VERT, "metric", symm_ncomps(dim), Reals(metrics));
+  return mesh;
+}
+
+static std::size_t count_calls(
+    profile::History const& history, char const* name) {
+  std::size_t ncalls = 0;
+  for (std::size_t i = 0; i < history.frames.size(); ++i) {
+    if (0 == std::strcmp(history.get_name(i), name)) {
+      ncalls += history.frames[i].number_of_calls;
+    }
+  }
+  return ncalls;
+}
+
+/* refinement passes leave slivers for the next pass to swap */
+static Mesh refine_sliver_box(Library* lib, Int dim, AdaptOpts const& opts) {
+  auto mesh = build_sliver_box(lib, dim);
+  while (mesh.min_quality() >= opts.min_quality_desired) {
+    OMEGA_H_CHECK(refine_by_size(&mesh, opts));
+  }
+  return mesh;
+}
+
+/* one combined pass splits and swaps with one rebuild per dimension,
+   where a refinement pass and a swap pass take one each */
+static void test_combined_pass(Library* lib, Int dim) {
+  auto opts = AdaptOpts(dim);
+  opts.verbosity = SILENT;
+  auto const previous_history = profile::global_singleton_history;
+  auto separate = refine_sliver_box(lib, dim, opts);
+  auto combined = refine_sliver_box(lib, dim, opts);
+  profile::History separate_history;
+  profile::global_singleton_history = &separate_history;
+  OMEGA_H_CHECK(swap_edges(&separate, opts));
+  OMEGA_H_CHECK(refine_by_size(&separate, opts));
+  profile::History combined_history;
+  profile::global_singleton_history = &combined_history;
+  OMEGA_H_CHECK(refine_and_swap_by_size(&combined, opts));
+  profile::global_singleton_history = previous_history;
+  OMEGA_H_CHECK(count_calls(combined_history, "transfer_swap") > 0);
+  OMEGA_H_CHECK(
+      count_calls(separate_history, "modify_ents_adapt") == 2 * dim + 1);
+  OMEGA_H_CHECK(count_calls(combined_history, "modify_ents_adapt") == dim + 1);
+  OMEGA_H_CHECK(combined.min_quality() >= opts.min_quality_allowed);
+  /* the split and swapped cavities still fill the box conformingly */
+  OMEGA_H_CHECK(are_close(get_sum(measure_elements_real(&combined)), 1.0));
+  auto sides2elems = combined.ask_up(dim - 1, dim);
+  OMEGA_H_CHECK(get_max(get_degrees(sides2elems.a2ab)) == 2);
+  /* and the tags carried over hold both kinds of products */
+  OMEGA_H_CHECK(
+      are_close(combined.ask_qualities(), measure_qualities(&combined)));
+  OMEGA_H_CHECK(
+      are_close(combined.ask_lengths(), measure_edges_metric(&combined)));
+  OMEGA_H_CHECK(get_min(combined.get_array<I8>(dim, "class_dim")) == dim);
+}
+
+static void test_combined_passes(Library* lib) {
+  test_combined_pass(lib, 2);
+  test_combined_pass(lib, 3);
+  auto mesh = build_sliver_box(lib, 3);
+  auto opts = AdaptOpts(&mesh);
+  opts.verbosity = SILENT;
+  opts.should_combine_passes = true;
+  OMEGA_H_CHECK(adapt(&mesh, opts));
+  OMEGA_H_CHECK(mesh.min_quality() >= opts.min_quality_allowed);
+  OMEGA_H_CHECK(get_max(mesh.ask_lengths()) <= opts.max_length_allowed);
+}
+
 static bool compare_hst(Int pd, Int cd, Int wc, Int wcv, SplitVertex truth) {
   auto split_vtx = hypercube_split_template(pd, cd, wc, wcv);
   if (split_vtx.dim != truth.dim) return false;
@@ -784,6 +1110,8 @@ int main(int argc, char** argv) {
   test_average_field(&lib);
   test_refine_qualities(&lib);
   test_mark_up_down(&lib);
+  test_incremental_up_adjs(&lib, 2);
+  test_incremental_up_adjs(&lib, 3);
   test_compare_meshes(&lib);
   test_swap2d_topology(&lib);
   test_swap3d_loop(&lib);
@@ -792,6 +1120,17 @@ int main(int argc, char** argv) {
   test_sf_scale(&lib);
   test_proximity(&lib);
   test_1d_box(&lib);
+  test_reorder_by_elements(&lib);
+  test_reorder_by_rcm(&lib);
+  test_elem_vert_caching(&lib);
+  test_solve_laplacian(&lib, 2, true);
+  test_solve_laplacian(&lib, 3, true);
+  test_solve_laplacian(&lib, 3, false);
+  test_limit_metric_gradation(&lib, 2, false);
+  test_limit_metric_gradation(&lib, 2, true);
+  test_limit_metric_gradation(&lib, 3, true);
+  test_find_indset(&lib);
+  test_combined_passes(&lib);
   test_hypercube_split_template();
   test_copy_constructor(&lib);
 }